@@ -0,0 +1,140 @@
+/*
+ * Command tables of the command line shell with a compile time perfect hash.
+ *
+ * Each table of commands, the verbs of the command line and the arguments of a verb
+ * such as set, is kept in flash with PROGMEM along with a slot index. The name of a
+ * command is hashed with cmdHash() and the hash selects a slot of the index which holds
+ * the number of the one command whose name can have that hash, or -1. A command is
+ * found with a hash of the argument, one read of the index, and a compare of the name
+ * however many commands the table has, and the compare makes the match exact so that
+ * a prefix of a command name, such as se for set, is not taken as the command.
+ *
+ * The slot index is computed by the compiler from the list of commands, see CMD_TABLE
+ * below. The hash is seeded and a static_assert checks that no two commands of a table
+ * have the same slot. If adding a command breaks the build with that static_assert then
+ * change the seed of the table or double its number of slots.
+ *
+ * Usage:
+ *     #define SET_COMMANDS(X) \
+ *       X(device, handlerSetDevice) \
+ *       X(baud, handlerSetBaud)
+ *
+ *     CMD_TABLE(setCommands, SET_COMMANDS, 4, 0x5a)      // 4 slots, seed 0x5a
+ *
+ *     CmdEntry  entry;
+ *     if (argc > 1 && cmdFind (&setCommands, argv[1], entry)) entry.pHandler (argc - 1, argv + 1);
+ */
+
+#if !defined(CMDTABLE_H_INCLUDED)
+#define CMDTABLE_H_INCLUDED
+
+#include <stdint.h>
+#include <string.h>
+
+#define CMD_NAME_MAX    12      // longest command name plus the zero terminator
+
+struct CmdEntry {
+  char  cmdName[CMD_NAME_MAX];
+  int (*pHandler) (int argc, char *argv[]);     // argv[0] is the command name
+};
+
+struct CmdTable {
+  const CmdEntry  *pEntries;    // the commands, in PROGMEM
+  const int8_t    *pSlots;      // the slot index, in PROGMEM, the number of the command or -1
+  uint8_t          nSlots;      // number of slots, a power of 2
+  uint8_t          uchSeed;     // seed of the hash
+};
+
+// the hash of a command name. the same hash is computed by the compiler for the names
+// of the commands in a table, cmdHashName(), and at run time for an argument, cmdFind().
+constexpr uint16_t cmdHashStep (uint16_t usHash, uint8_t c)
+{
+  return (uint16_t)((usHash ^ c) * 0x0193u);
+}
+
+constexpr uint8_t cmdSlot (uint16_t usHash, uint8_t nSlots)
+{
+  return (uint8_t)((usHash ^ (usHash >> 8)) & (nSlots - 1));
+}
+
+constexpr uint16_t cmdHashName (const char *pszName, uint16_t usHash)
+{
+  return *pszName ? cmdHashName (pszName + 1, cmdHashStep (usHash, (uint8_t)*pszName)) : usHash;
+}
+
+// the compile time part. cmdSlotEntry() is the number of the first command whose name
+// has the slot iSlot, or -1, which is the value of that slot of the index. the table is
+// perfect if the slot of each command holds that command.
+constexpr int8_t cmdSlotEntry (const char *const *apszNames, uint8_t nNames, uint8_t uchSeed,
+    uint8_t nSlots, uint8_t iSlot, uint8_t i = 0)
+{
+  return (i >= nNames) ? -1
+      : (cmdSlot (cmdHashName (apszNames[i], uchSeed), nSlots) == iSlot) ? (int8_t)i
+      : cmdSlotEntry (apszNames, nNames, uchSeed, nSlots, iSlot, i + 1);
+}
+
+constexpr bool cmdPerfect (const char *const *apszNames, uint8_t nNames, uint8_t uchSeed, uint8_t nSlots, uint8_t i = 0)
+{
+  return (i >= nNames) || (cmdSlotEntry (apszNames, nNames, uchSeed, nSlots,
+      cmdSlot (cmdHashName (apszNames[i], uchSeed), nSlots)) == (int8_t)i
+      && cmdPerfect (apszNames, nNames, uchSeed, nSlots, i + 1));
+}
+
+constexpr uint8_t cmdNameLength (const char *pszName)
+{
+  return *pszName ? 1 + cmdNameLength (pszName + 1) : 0;
+}
+
+constexpr bool cmdNamesFit (const char *const *apszNames, uint8_t nNames, uint8_t i = 0)
+{
+  return (i >= nNames) || (cmdNameLength (apszNames[i]) < CMD_NAME_MAX && cmdNamesFit (apszNames, nNames, i + 1));
+}
+
+// the slot index initializers for tables of 2 to 64 slots.
+#define CMD_SLOT(t, n, s, i)        cmdSlotEntry (t##Names, t##Count, s, n, i)
+#define CMD_SLOTS_2(t, n, s, o)     CMD_SLOT(t, n, s, o), CMD_SLOT(t, n, s, o + 1)
+#define CMD_SLOTS_4(t, n, s, o)     CMD_SLOTS_2(t, n, s, o), CMD_SLOTS_2(t, n, s, o + 2)
+#define CMD_SLOTS_8(t, n, s, o)     CMD_SLOTS_4(t, n, s, o), CMD_SLOTS_4(t, n, s, o + 4)
+#define CMD_SLOTS_16(t, n, s, o)    CMD_SLOTS_8(t, n, s, o), CMD_SLOTS_8(t, n, s, o + 8)
+#define CMD_SLOTS_32(t, n, s, o)    CMD_SLOTS_16(t, n, s, o), CMD_SLOTS_16(t, n, s, o + 16)
+#define CMD_SLOTS_64(t, n, s, o)    CMD_SLOTS_32(t, n, s, o), CMD_SLOTS_32(t, n, s, o + 32)
+
+#define CMD_NAME_STRING(name, handler)    #name,
+#define CMD_ENTRY(name, handler)          { #name, handler },
+
+// define the CmdTable tableName in PROGMEM with the commands in the X macro list,
+// nSlots slots, which must be 2, 4, 8, 16, 32, or 64, and the hash seed uchSeed.
+#define CMD_TABLE(tableName, list, nSlots, uchSeed) \
+  constexpr const char *const tableName##Names[] = { list(CMD_NAME_STRING) }; \
+  constexpr uint8_t tableName##Count = sizeof(tableName##Names) / sizeof(tableName##Names[0]); \
+  static_assert (cmdNamesFit (tableName##Names, tableName##Count), #tableName ": a command name is longer than CMD_NAME_MAX - 1"); \
+  static_assert (cmdPerfect (tableName##Names, tableName##Count, uchSeed, nSlots), \
+      #tableName ": two commands have the same slot, change the seed or the number of slots"); \
+  const CmdEntry tableName##Entries[] PROGMEM = { list(CMD_ENTRY) }; \
+  const int8_t tableName##Slots[nSlots] PROGMEM = { \
+      CMD_SLOTS_##nSlots(tableName, nSlots, uchSeed, 0) }; \
+  const CmdTable tableName PROGMEM = { tableName##Entries, tableName##Slots, nSlots, uchSeed };
+
+// find the command of a table whose name is exactly pszName and copy its entry from
+// flash into entry. returns false if the table has no such command.
+inline bool cmdFind (const CmdTable *pTable, const char *pszName, CmdEntry &entry)
+{
+  CmdTable  table;
+  uint16_t  usHash;
+  uint8_t   nLength = 0;
+
+  memcpy_P (&table, pTable, sizeof(table));
+  for (usHash = table.uchSeed; pszName[nLength]; nLength++) {
+    if (nLength >= CMD_NAME_MAX - 1) return false;
+    usHash = cmdHashStep (usHash, (uint8_t)pszName[nLength]);
+  }
+  if (nLength == 0) return false;
+
+  int8_t  iEntry = (int8_t)pgm_read_byte (table.pSlots + cmdSlot (usHash, table.nSlots));
+  if (iEntry < 0) return false;
+
+  memcpy_P (&entry, table.pEntries + iEntry, sizeof(entry));
+  return strcmp (entry.cmdName, pszName) == 0;
+}
+
+#endif    // !defined(CMDTABLE_H_INCLUDED)
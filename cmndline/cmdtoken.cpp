@@ -0,0 +1,53 @@
+/*
+ * Tokenizer of the command line shell.
+ *
+ * See cmdtoken.h for a description.
+ */
+
+#include <stddef.h>
+
+#include "cmdtoken.h"
+
+int cmdTokenize (char *pszLine, char *argv[], int nMaxArgs)
+{
+  char  *pIn = pszLine;       // the next character to look at
+  char  *pOut = pszLine;      // where the next character of the argument goes, never after pIn
+  int    argc = 0;
+  bool   bInArg = false;      // an argument has been started
+  bool   bQuoted = false;     // between double quotes
+
+  if (nMaxArgs < 1) return CMD_TOKEN_MANY;
+
+  for ( ; ; pIn++) {
+    char  c = *pIn;
+
+    if (c == 0 || c == '\r' || c == '\n') break;
+
+    if (!bQuoted && (c == ' ' || c == '\t')) {
+      if (bInArg) {
+        *pOut++ = 0;          // end of the argument, pOut is at most pIn so this is a separator
+        bInArg = false;
+      }
+      continue;
+    }
+
+    if (!bInArg) {            // the first character of an argument
+      if (argc >= nMaxArgs - 1) return CMD_TOKEN_MANY;
+      argv[argc++] = pOut;
+      bInArg = true;
+    }
+
+    if (c == '"') {
+      bQuoted = !bQuoted;
+    } else if (c == '\\' && pIn[1] != 0 && pIn[1] != '\r' && pIn[1] != '\n') {
+      *pOut++ = *++pIn;
+    } else {
+      *pOut++ = c;
+    }
+  }
+
+  if (bQuoted) return CMD_TOKEN_QUOTE;
+  if (bInArg) *pOut = 0;
+  argv[argc] = NULL;
+  return argc;
+}
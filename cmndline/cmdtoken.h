@@ -0,0 +1,31 @@
+/*
+ * Tokenizer of the command line shell.
+ *
+ * cmdTokenize() splits a command line into arguments in place, the way a shell does,
+ * and puts a pointer to each argument into an argv array. The line is scanned once.
+ * Each argument is terminated by a zero written into the line and the quotes and
+ * escape backslashes are removed by moving the characters of the argument down over
+ * them so nothing is copied out of the line and nothing is allocated.
+ *
+ *   - arguments are separated by one or more spaces or tabs
+ *   - "double quotes" make the spaces between them part of the argument, the quotes
+ *     are removed, and "" is an empty argument
+ *   - a backslash makes the character following it an ordinary character so \" is a
+ *     quote, \\ a backslash, and "\ " a space within the argument
+ *   - the line ends with a zero, a carriage return, or a line feed
+ *
+ * For example  set device "lane 7"  gives argc 3 and argv set, device, and lane 7.
+ */
+
+#if !defined(CMDTOKEN_H_INCLUDED)
+#define CMDTOKEN_H_INCLUDED
+
+#define CMD_TOKEN_QUOTE     -1      // a quote was not closed before the end of the line
+#define CMD_TOKEN_MANY      -2      // the line has more than nMaxArgs - 1 arguments
+
+// split the line pszLine into arguments. argv must have room for nMaxArgs pointers,
+// up to nMaxArgs - 1 arguments followed by a NULL. returns the number of arguments,
+// argc, or one of the CMD_TOKEN_ errors above.
+int cmdTokenize (char *pszLine, char *argv[], int nMaxArgs);
+
+#endif    // !defined(CMDTOKEN_H_INCLUDED)
@@ -1,5 +1,18 @@
 #include <EEPROM.h>
 
+// the provisioning settings are kept in a wear leveled key and value store which uses
+// all of the 1 KB EEPROM of the Uno in 4 segments and caches the settings in RAM.
+// see libraries/ConfigStore. each setting has a key from ConfigKeys.h, CONFIG_DEVICE_NAME
+// for the device name, so that the keys of the sketches which share the EEPROM differ.
+#include <ConfigStore.h>
+#include <ConfigKeys.h>
+
+ConfigStore<EEPROMClass, 64>  config (EEPROM, 0, 1024, 4);
+
+// the work of the shell is done by the tasks of a cooperative task runtime, see
+// libraries/TaskRuntime, which counts the time each task takes for get tasks.
+#include <TaskRuntime.h>
+
 void setup() {
   // put your setup code here, to run once:
   Serial.begin (19200);
@@ -8,135 +21,132 @@ void setup() {
     ;  // wait for serial port to connect
   }
 
+  config.begin ();
 }
 
 // ------------------------------------------------------------------
-//  The following function, getToken(), is used to implement a simple
-//  recursive descent parser. This function and the token struct is used
-//  to process a command line in a manner similar to standard command shell
-//  specifications.
+//  A command line is split into arguments by cmdTokenize() in the manner of a
+//  standard command shell. The arguments are separated by spaces, an argument
+//  with spaces in it can be put in double quotes, and a backslash makes the
+//  character after it an ordinary character. See cmdtoken.h.
 //
-//  A command line is expected to be composed of multiple tokens which are
-// separated by spaces.
+//  The first argument is the command and the handler of a command is given
+//  the arguments as argc and argv, with argv[0] being the name it was found
+//  with, as for main() of a C program.
 
-typedef unsigned short USHORT;
-
-struct token {
-  char    *first;   // beginning of token
-  char    *last;    // last character of token
-  USHORT  len;      // count of characters of token
-  char    *strEnd;  // points to position after last character of string being parsed
-};
+#include "cmdtoken.h"
 
-enum tokState { TokInitial = 0, TokStringStart, TokString, TokQuoted, TokEnd };
-struct token getToken (struct token myTok)
-{
-  tokState   state = TokInitial;
-  char      *line = myTok.last;
-
- myTok.first = line;
-
- while (state != TokEnd) {
-  switch (*line) {
-    case 0:      // this is end of string terminator
-      state = TokEnd;
-    case ' ':
-      if (state != TokQuoted && state != TokInitial) state = TokEnd;
-      break;
-    case '"':
-      if (state != TokQuoted) {
-        state = TokQuoted;
-        myTok.first = line;
-      } else {
-        state = TokString;
-      }
-      break;
-    case 1:     // this appears to be same line end
-    case '\r':
-      state = TokEnd;
-      break;
-    default:
-      switch (state) {
-        case TokString:
-        case TokQuoted:
-          break;
-        case TokStringStart:
-          state = TokString;
-          break;
-        default:
-          state = TokStringStart;
-          myTok.first = line;
-          break;
-      }
-      break;
-  }
-  if (state == TokEnd) {
-    myTok.last = line;
-    myTok.len = myTok.last - myTok.first;
-    break;
-  }
-  line++;
- }
-  return myTok;
-}
+#define CMD_ARGS_MAX    8     // most arguments on a command line, plus 1 for the NULL
 
 // --------------------------------------------------------------------
 
 // Command handlers follow. These are the functions which will handle
 // the specific command entered.
+//
+// The commands of each command table are looked up with a perfect hash computed
+// by the compiler and the tables are kept in flash. See cmdtable.h.
 
-struct cmdList {
-  char *cmdName;
-  int (*pHandler) (struct token x);
-};
+#include "cmdtable.h"
+
+// get device, print the device name, nothing if it has not been set.
+int handlerGetDevice (int argc, char *argv[])
+{
+  char  aszDeviceName[24];
+  int   nLength = config.get (CONFIG_DEVICE_NAME, aszDeviceName, sizeof(aszDeviceName) - 1);
+
+  aszDeviceName[nLength > 0 ? nLength : 0] = 0;
+  Serial.println (aszDeviceName);
+  return 0;
+}
 
 /*
- * handlerSet - handle the set command.
- * 
+ * handlerSetDevice - handle the set device command.
+ *
  *   The set command is used to set particular provisioning information.
- *   
+ *
  *   set device name
  *     Sets the device name to be the text specified by name. The device name
- *     is a text string that identifies the device. It is stored in the EEPROM
- *     at address 0 and
+ *     is a text string that identifies the device of up to 23 characters. It
+ *     is kept in the configuration store with the key CONFIG_DEVICE_NAME.
+ *     Without a name the device name is printed as with get device.
  */
-struct DeviceName {
-  char  aszDeviceName [24];
-};
+int handlerSetDevice (int argc, char *argv[])
+{
+  if (argc > 1) {
+    size_t  nLength = strlen (argv[1]);
 
-int handlerSetDevice (struct token tok)
+    if (nLength > 23) nLength = 23;
+    if (!config.set (CONFIG_DEVICE_NAME, argv[1], (uint8_t)nLength)) Serial.println ("config store full");
+    return 0;
+  }
+  return handlerGetDevice (argc, argv);
+}
+
+// the arguments of the set command. the table has 2 slots and the hash seed 0,
+// see cmdtable.h for changing them if a new argument breaks the build.
+#define SET_COMMANDS(X) \
+  X(device, handlerSetDevice)
+
+CMD_TABLE(setCommands, SET_COMMANDS, 2, 0)
+
+// the set command, hand the arguments to the handler of the setting named.
+int handlerSet (int argc, char *argv[])
 {
-  DeviceName deviceName;
-
-  tok = getToken (tok);
-  if (tok.first && tok.first < tok.strEnd) {
-    // set the specified device name into the EEPROM
-    if (tok.len > 23) tok.len = 23;
-    strncpy (deviceName.aszDeviceName, tok.first, tok.len);
-    deviceName.aszDeviceName[tok.len] = 0;  // end of string
-    EEPROM.put (0, deviceName);
-  } else {
-    // read the device name from EEPROM and print it out
-    EEPROM.get (0, deviceName);
-    deviceName.aszDeviceName[23] = 0;  // ensure zero terminator to device name
-    Serial.println (deviceName.aszDeviceName);
+  CmdEntry  entry;
+
+  if (argc > 1 && cmdFind (&setCommands, argv[1], entry)) {
+    return entry.pHandler (argc - 1, argv + 1);
   }
+  return 0;
 }
 
-int handlerSet (struct token tok)
+// get store, print the state of the configuration store.
+int handlerGetStore (int argc, char *argv[])
 {
-  cmdList setList[] = {
-    {"device", handlerSetDevice},
-    {  0,  0}
-  };
-
-  tok = getToken (tok);
-   if (tok.first && tok.first < tok.strEnd) for (int i = 0; setList[i].cmdName; i++) {
-     if (strncmp (setList[i].cmdName, tok.first, tok.len) == 0) {
-       setList[i].pHandler (tok);
-       break;
-     }
-   }
+  char  aszLine[64];
+
+  snprintf (aszLine, sizeof(aszLine), "segment %u seq %u free %u cache %u compactions %u",
+      config.activeSegment (), config.sequence (), config.bytesFree (), config.cacheUsed (), config.compactionCount ());
+  Serial.println (aszLine);
+  return 0;
+}
+
+int handlerGetTasks (int argc, char *argv[]);
+
+// the arguments of the get command. the table has 4 slots and the hash seed 4.
+#define GET_COMMANDS(X) \
+  X(device, handlerGetDevice) \
+  X(store, handlerGetStore) \
+  X(tasks, handlerGetTasks)
+
+CMD_TABLE(getCommands, GET_COMMANDS, 4, 4)
+
+/*
+ * handlerGet - handle the get command.
+ *
+ *   The get command prints provisioning information.
+ *
+ *   get device
+ *     Prints the device name.
+ *
+ *   get store
+ *     Prints the state of the configuration store, the active segment and its
+ *     sequence number, the bytes free in the segment, the bytes of the RAM cache
+ *     used, and the number of times the settings have been copied to the next
+ *     segment since startup.
+ *
+ *   get tasks
+ *     Prints for each task of the task runtime the number of runs, the CPU
+ *     utilization, the longest run, the latest start, and the deadlines missed
+ *     since the last get tasks.
+ */
+int handlerGet (int argc, char *argv[])
+{
+  CmdEntry  entry;
+
+  if (argc > 1 && cmdFind (&getCommands, argv[1], entry)) {
+    return entry.pHandler (argc - 1, argv + 1);
+  }
   return 0;
 }
 
@@ -147,67 +157,81 @@ int handlerSet (struct token tok)
 // Each of the commands in this command list may have further arguments which
 // the handler for the command must process. This is only a dispatch function
 // that determines which handler to hand the command line to based on the
-// first token on the command line.
+// first argument on the command line. The table has 4 slots and the hash seed 0.
 
-struct cmdList myList [] = {
-  {"set", handlerSet},
-  { 0, 0}
-};
+#define TOP_COMMANDS(X) \
+  X(set, handlerSet) \
+  X(get, handlerGet)
+
+CMD_TABLE(topCommands, TOP_COMMANDS, 4, 0)
 
-int processCmdLine (char *cmdline, int nBytes)
+int processCmdLine (char *cmdline)
 {
-  struct token myTok = {0};
-  
-  myTok.last = cmdline;
-  myTok.strEnd = nBytes + myTok.last;
-  
-  myTok = getToken (myTok);
-
-#if 0
-  // test code to test out the getToken() function to see if it is parsing the
-  // input line of text properly.
-  if (myTok.first) do {
-    Serial.print (myTok.len);
-    Serial.print ("  ."); Serial.print ( (int)*myTok.first); Serial.print (". ");
-    Serial.println (myTok.first);
-    myTok = getToken (myTok);
-   } while (myTok.first && myTok.first < myTok.strEnd);
-#else
-   if (myTok.first && myTok.first < myTok.strEnd) for (int i = 0; myList[i].cmdName; i++) {
-     if (strncmp (myList[i].cmdName, myTok.first, myTok.len) == 0) {
-       myList[i].pHandler (myTok);
-       break;
-     }
-   }
-#endif   
+  char      *argv[CMD_ARGS_MAX];
+  int        argc = cmdTokenize (cmdline, argv, CMD_ARGS_MAX);
+  CmdEntry   entry;
+
+  switch (argc) {
+    case CMD_TOKEN_QUOTE:
+      Serial.println ("unclosed quote");
+      return argc;
+    case CMD_TOKEN_MANY:
+      Serial.println ("too many arguments");
+      return argc;
+  }
+
+  if (argc > 0 && cmdFind (&topCommands, argv[0], entry)) {
+    return entry.pHandler (argc, argv);
+  }
+  return 0;
 }
 
 // -----------------------------------------------------------------------------
+//
+// The command line is assembled by a LineEditor a character at a time as the
+// characters arrive so loop() never waits for the Serial port. See lineeditor.h.
+
+#include "lineeditor.h"
 
-char  cmdline[64];
+LineEditor<64, 4>  lineEditor;     // lines of up to 63 characters, the last 4 lines kept as history
 
 int cmdlinestate = 0;
 
-void loop() {
+void TaskShell (void)
+{
   int nBytes;
-  
-  // put your main code here, to run repeatedly:
 
   switch (cmdlinestate) {
     case 0:    // initial state so prompt the user
       Serial.print ("cmd> ");
       cmdlinestate = 1;
       break;
-    case 1:    // line was entered
-      nBytes = Serial.readBytes (cmdline, 63);
-      if (nBytes) {
-//        Serial.print (" nBytes = "); Serial.println(nBytes);
-        cmdline[nBytes] = 0;
-        // echo the entered command since IDE Serial Monitor has separate control for text entry.
-        Serial.println (cmdline);
-        processCmdLine (cmdline, nBytes);
+    case 1:    // waiting for the line to be entered
+      nBytes = lineEditor.poll (Serial);
+      if (nBytes >= 0) {
+        processCmdLine (lineEditor.line ());
         cmdlinestate = 0;
       }
       break;
   }
 }
+
+// the tasks of the shell. the shell is polled on every pass of loop() and a
+// character should be echoed within 5 msec of arriving.
+Task  tasks[] = {
+  // name      function      period msec   deadline usec
+  { "shell",   TaskShell,    0,            5000 }
+};
+
+TaskRuntime  taskRuntime (tasks, sizeof(tasks) / sizeof(tasks[0]));
+
+int handlerGetTasks (int argc, char *argv[])
+{
+  taskRuntime.report (Serial);
+  return 0;
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+  taskRuntime.run ();
+}
@@ -0,0 +1,175 @@
+/*
+ * Host tests of the configuration store on the EEPROM of the host shim.
+ *
+ * The store, see libraries/ConfigStore, is set up as cmndline.ino has it, all of the
+ * 1 KB EEPROM in 4 segments, and the device name is changed over and over:
+ *   - wear   the device name is set updates times, each name read back, and the most
+ *            any byte of the EEPROM was written is compared with the number of updates
+ *   - power  from each of a range of starting points, which fill the active segment so
+ *            that some of the updates copy the settings to the next segment, the power
+ *            is cut at every byte written by an update. after the restart the name must
+ *            be either the old or the new one, and after a shorter name is then set and
+ *            the power cycled again the log must be read with no repair
+ *
+ * The program exits with 1 if any of the tests fail.
+ *
+ *     storesim [updates]
+ *
+ * See README.md for how to build this program.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "ConfigStore.h"
+#include "ConfigKeys.h"
+
+#define CONFIG_OTHER    CONFIG_SCALE_DEFAULTS     // a second setting so the log has more than one key
+
+typedef ConfigStore<EEPROMClass, 64>  Store;
+
+static const char *names[] = {
+  "lane 1", "lane 12 front", "x", "self checkout 4", "lane 7", "customer service desk",
+  "lane 3 express", "garden", "pharmacy 2", "lane 10"
+};
+static const int  nNames = sizeof(names) / sizeof(names[0]);
+
+// the name of the store, "" if it is not set.
+static void getName (Store &store, char *pszName, int nSize)
+{
+  int  nLength = store.get (CONFIG_DEVICE_NAME, pszName, (uint8_t)(nSize - 1));
+
+  pszName[nLength < 0 ? 0 : nLength] = 0;
+}
+
+static bool setName (Store &store, const char *pszName)
+{
+  return store.set (CONFIG_DEVICE_NAME, pszName, (uint8_t)strlen (pszName));
+}
+
+static unsigned long totalWrites (void)
+{
+  unsigned long  ulWrites = 0;
+
+  for (int i = 0; i < HOST_EEPROM_SIZE; i++) ulWrites += hostEepromWriteCount (i);
+  return ulWrites;
+}
+
+static bool testWear (long nUpdates)
+{
+  Store  store (EEPROM, 0, 1024, 4);
+  char   aszName[32];
+  int    nWrong = 0;
+  unsigned long  ulMost = 0;
+
+  hostEepromErase ();
+  store.begin ();
+  for (long i = 0; i < nUpdates; i++) {
+    setName (store, names[i % nNames]);
+    getName (store, aszName, sizeof(aszName));
+    if (strcmp (aszName, names[i % nNames]) != 0) nWrong++;
+  }
+  for (int i = 0; i < HOST_EEPROM_SIZE; i++) {
+    if (hostEepromWriteCount (i) > ulMost) ulMost = hostEepromWriteCount (i);
+  }
+
+  // and the last name is there after a restart.
+  Store  restart (EEPROM, 0, 1024, 4);
+  restart.begin ();
+  getName (restart, aszName, sizeof(aszName));
+  if (strcmp (aszName, names[(nUpdates - 1) % nNames]) != 0) nWrong++;
+
+  printf ("wear:    %ld updates, %u compactions, no byte written more than %lu times, %d wrong\n",
+      nUpdates, store.compactionCount (), ulMost, nWrong);
+  return nWrong == 0 && ulMost * 10 < (unsigned long)nUpdates;
+}
+
+static bool testPower (void)
+{
+  uint8_t  auchSaved[HOST_EEPROM_SIZE];
+  char     aszName[32];
+  int      nCuts = 0, nWrong = 0, nRepairs = 0, nCompactions = 0;
+  const char  *pszNew = "lane 22 self checkout";    // longer than any of names[]
+
+  for (int nBefore = 0; nBefore < 40; nBefore++) {
+    const char  *pszOld = nBefore ? names[(nBefore - 1) % nNames] : "";
+
+    // the starting point, nBefore updates of the name.
+    hostEepromErase ();
+    {
+      Store  store (EEPROM, 0, 1024, 4);
+      store.begin ();
+      store.set (CONFIG_OTHER, "7", 1);
+      for (int i = 0; i < nBefore; i++) setName (store, names[i % nNames]);
+    }
+    for (int i = 0; i < HOST_EEPROM_SIZE; i++) auchSaved[i] = EEPROM.read (i);
+
+    // the writes of the update with the power on.
+    unsigned long  ulWrites;
+    {
+      Store  store (EEPROM, 0, 1024, 4);
+      uint16_t  usCompactions;
+
+      store.begin ();
+      usCompactions = store.compactionCount ();
+      ulWrites = totalWrites ();
+      setName (store, pszNew);
+      ulWrites = totalWrites () - ulWrites;
+      if (store.compactionCount () != usCompactions) nCompactions++;
+    }
+
+    for (unsigned long ulCut = 0; ulCut < ulWrites; ulCut++) {
+      for (int i = 0; i < HOST_EEPROM_SIZE; i++) EEPROM.update (i, auchSaved[i]);
+
+      {
+        Store  store (EEPROM, 0, 1024, 4);
+        store.begin ();
+        hostEepromFailAfter ((long)ulCut);
+        setName (store, pszNew);
+        hostEepromFailAfter (-1);
+      }
+      nCuts++;
+
+      // the restart after the power cut, then a shorter name and another restart.
+      {
+        Store  store (EEPROM, 0, 1024, 4);
+        store.begin ();
+        getName (store, aszName, sizeof(aszName));
+        if (strcmp (aszName, pszOld) != 0 && strcmp (aszName, pszNew) != 0) {
+          if (nWrong++ < 10) printf ("  %d updates, cut after %lu writes: name \"%s\"\n", nBefore, ulCut, aszName);
+        }
+        setName (store, "x");
+      }
+      {
+        Store  store (EEPROM, 0, 1024, 4);
+        store.begin ();
+        getName (store, aszName, sizeof(aszName));
+        if (store.repairCount () != 0 || strcmp (aszName, "x") != 0) {
+          if (nRepairs++ < 10) printf ("  %d updates, cut after %lu writes: repaired, name \"%s\"\n", nBefore, ulCut, aszName);
+        }
+        char  chOther = 0;
+        if (store.get (CONFIG_OTHER, &chOther, 1) != 1 || chOther != '7') nWrong++;
+      }
+    }
+  }
+
+  printf ("power:   %d cuts in 40 updates, %d of which copied the settings, %d wrong, %d repaired after the next update\n",
+      nCuts, nCompactions, nWrong, nRepairs);
+  return nWrong == 0 && nRepairs == 0;
+}
+
+int main (int argc, char *argv[])
+{
+  long  nUpdates = 4000;
+
+  if (argc > 1) nUpdates = atol (argv[1]);
+  if (nUpdates < 1) nUpdates = 1;
+
+  bool  bGood = testWear (nUpdates);
+  bGood = testPower () && bGood;
+
+  return bGood ? 0 : 1;
+}
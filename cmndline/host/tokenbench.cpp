@@ -0,0 +1,215 @@
+/*
+ * Host tests and benchmark of the command line tokenizer.
+ *
+ * First cmdTokenize(), see cmdtoken.h, is run on a list of command lines and the
+ * arguments it gives are compared with the arguments expected, then the cost of
+ * splitting a command line into arguments is measured two ways:
+ *   - getToken  the getToken() of the earlier shell, which found the next token of the
+ *               line each time it was called, with each token copied out of the line
+ *               with strncpy() so a handler could use it as a string
+ *   - tokenize  cmdTokenize() splitting the line in place in one pass
+ *
+ * The program exits with 1 if any of the tests fail.
+ *
+ *     tokenbench [lines]
+ *
+ * See README.md for how to build this program.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "cmdtoken.h"
+
+#define ARGS_MAX    8
+
+static const struct {
+  const char  *pszLine;
+  int          argc;                // expected argc or CMD_TOKEN_ error
+  const char  *apszArgs[ARGS_MAX];
+} tests[] = {
+  { "", 0, { 0 } },
+  { "   \t ", 0, { 0 } },
+  { "\r\n", 0, { 0 } },
+  { "get device", 2, { "get", "device" } },
+  { "  get   device  ", 2, { "get", "device" } },
+  { "get\tdevice\r\n", 2, { "get", "device" } },
+  { "set device \"lane 7\"", 3, { "set", "device", "lane 7" } },
+  { "set device lane\" 7 \"west", 3, { "set", "device", "lane 7 west" } },
+  { "set device \"\"", 3, { "set", "device", "" } },
+  { "\"\" \"\"", 2, { "", "" } },
+  { "set device lane\\ 7", 3, { "set", "device", "lane 7" } },
+  { "say \\\"hi\\\"", 2, { "say", "\"hi\"" } },
+  { "say \"a \\\" b\"", 2, { "say", "a \" b" } },
+  { "path c:\\\\dir", 2, { "path", "c:\\dir" } },
+  { "trailing\\", 1, { "trailing\\" } },
+  { "set device \"lane 7", CMD_TOKEN_QUOTE, { 0 } },
+  { "\"", CMD_TOKEN_QUOTE, { 0 } },
+  { "a b c d e f g", 7, { "a", "b", "c", "d", "e", "f", "g" } },
+  { "a b c d e f g h", CMD_TOKEN_MANY, { 0 } },
+  { "get device\rset device x", 2, { "get", "device" } },
+};
+
+static int runTests (void)
+{
+  int  nFails = 0;
+
+  for (size_t t = 0; t < sizeof(tests) / sizeof(tests[0]); t++) {
+    char  aszLine[64];
+    char *argv[ARGS_MAX];
+    bool  bFail = false;
+
+    strcpy (aszLine, tests[t].pszLine);
+    int  argc = cmdTokenize (aszLine, argv, ARGS_MAX);
+
+    if (argc != tests[t].argc) {
+      bFail = true;
+    } else if (argc >= 0) {
+      for (int i = 0; i < argc; i++) {
+        if (strcmp (argv[i], tests[t].apszArgs[i]) != 0) bFail = true;
+      }
+      if (argv[argc] != NULL) bFail = true;
+    }
+
+    if (bFail) {
+      nFails++;
+      printf ("FAIL line \"%s\": argc %d expected %d\n", tests[t].pszLine, argc, tests[t].argc);
+      for (int i = 0; i < argc; i++) printf ("    argv[%d] \"%s\"\n", i, argv[i]);
+    }
+  }
+  printf ("%d tests, %d failed\n", (int)(sizeof(tests) / sizeof(tests[0])), nFails);
+  return nFails;
+}
+
+// the tokenizer of the earlier shell.
+typedef unsigned short USHORT;
+
+struct token {
+  char    *first;   // beginning of token
+  char    *last;    // last character of token
+  USHORT  len;      // count of characters of token
+  char    *strEnd;  // points to position after last character of string being parsed
+};
+
+enum tokState { TokInitial = 0, TokStringStart, TokString, TokQuoted, TokEnd };
+static struct token getToken (struct token myTok)
+{
+  tokState   state = TokInitial;
+  char      *line = myTok.last;
+
+  myTok.first = line;
+
+  while (state != TokEnd) {
+    switch (*line) {
+      case 0:      // this is end of string terminator
+        state = TokEnd;
+      case ' ':
+        if (state != TokQuoted && state != TokInitial) state = TokEnd;
+        break;
+      case '"':
+        if (state != TokQuoted) {
+          state = TokQuoted;
+          myTok.first = line;
+        } else {
+          state = TokString;
+        }
+        break;
+      case 1:     // this appears to be same line end
+      case '\r':
+        state = TokEnd;
+        break;
+      default:
+        switch (state) {
+          case TokString:
+          case TokQuoted:
+            break;
+          case TokStringStart:
+            state = TokString;
+            break;
+          default:
+            state = TokStringStart;
+            myTok.first = line;
+            break;
+        }
+        break;
+    }
+    if (state == TokEnd) {
+      myTok.last = line;
+      myTok.len = myTok.last - myTok.first;
+      break;
+    }
+    line++;
+  }
+  return myTok;
+}
+
+static const char *benchLines[] = {
+  "get device\r",
+  "set device lane7\r",
+  "set device \"lane 7 west\"\r",
+  "get store\r",
+};
+#define BENCH_LINES   (sizeof(benchLines) / sizeof(benchLines[0]))
+
+static int splitGetToken (char *pszLine, char aaszArgs[][24])
+{
+  struct token  tok = {0};
+  int  argc = 0;
+
+  tok.last = pszLine;
+  tok.strEnd = pszLine + strlen (pszLine);
+  for (tok = getToken (tok); tok.first && tok.first < tok.strEnd && argc < ARGS_MAX; tok = getToken (tok)) {
+    size_t  nLength = tok.len < 23 ? tok.len : 23;
+    strncpy (aaszArgs[argc], tok.first, nLength);
+    aaszArgs[argc++][nLength] = 0;
+    if (tok.last >= tok.strEnd || *tok.last == '\r') break;
+  }
+  return argc;
+}
+
+static double elapsedSeconds (std::chrono::steady_clock::time_point tStart)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+}
+
+int main (int argc, char *argv[])
+{
+  long  lLines = (argc > 1) ? atol (argv[1]) : 1000000;
+
+  if (lLines < 1) {
+    fprintf (stderr, "usage: tokenbench [lines]\n");
+    return 2;
+  }
+
+  if (runTests ()) return 1;
+
+  char  aszLine[64];
+  unsigned long  ulArgs = 0;
+  std::chrono::steady_clock::time_point  tStart = std::chrono::steady_clock::now();
+
+  for (long l = 0; l < lLines; l++) {
+    char  aaszArgs[ARGS_MAX][24];
+
+    strcpy (aszLine, benchLines[l % BENCH_LINES]);
+    ulArgs += splitGetToken (aszLine, aaszArgs);
+    ulArgs += aaszArgs[0][0] == 0;
+  }
+  double  dSeconds = elapsedSeconds (tStart);
+  printf ("getToken %ld lines, %lu arguments in %.3f sec, %.1f ns per line\n", lLines, ulArgs, dSeconds, dSeconds * 1e9 / lLines);
+
+  ulArgs = 0;
+  tStart = std::chrono::steady_clock::now();
+  for (long l = 0; l < lLines; l++) {
+    char *apszArgs[ARGS_MAX];
+
+    strcpy (aszLine, benchLines[l % BENCH_LINES]);
+    int  n = cmdTokenize (aszLine, apszArgs, ARGS_MAX);
+    ulArgs += n + (apszArgs[0][0] == 0);
+  }
+  dSeconds = elapsedSeconds (tStart);
+  printf ("tokenize %ld lines, %lu arguments in %.3f sec, %.1f ns per line\n", lLines, ulArgs, dSeconds, dSeconds * 1e9 / lLines);
+  return 0;
+}
@@ -0,0 +1,176 @@
+/*
+ * Non-blocking line editor for the command line shell.
+ *
+ * Serial.readBytes() waits for the Stream timeout, a second by default, for the
+ * characters of a command line so while it waits the Arduino does nothing else. The
+ * LineEditor instead takes only the characters which have already arrived each time
+ * poll() is called from loop() and returns as soon as they are handled so the shell
+ * can run alongside other work such as a scale or a sensor.
+ *
+ * The characters are echoed as they are typed and the line can be edited:
+ *   - backspace or delete      erase the last character
+ *   - Ctrl-U                   erase the whole line
+ *   - Ctrl-P or up arrow       recall the previous line of the history
+ *   - Ctrl-N or down arrow     recall the next line of the history
+ *   - carriage return, line feed, or both   end the line
+ *
+ * The history holds the last H lines entered. A line may be at most N - 1 characters,
+ * the characters typed after that are thrown away with a bell and counted as overflows.
+ * The arrow keys and the erasing of a recalled line use ANSI escape sequences which
+ * terminal programs such as PuTTY and screen understand.
+ *
+ * Usage:
+ *     LineEditor<64, 4>  lineEditor;
+ *
+ *     if (lineEditor.poll (Serial) >= 0) processCmdLine (lineEditor.line ());
+ */
+
+#if !defined(LINEEDITOR_H_INCLUDED)
+#define LINEEDITOR_H_INCLUDED
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+template <uint8_t N, uint8_t H>     // size of a line including the zero terminator, number of history lines
+class LineEditor {
+  public:
+    LineEditor () : nLength(0), bDone(false), bLastCr(false), uchEscape(0), nHistory(0), iNewest(0), iRecall(0), usOverflows(0) {
+      aszLine[0] = 0;
+    }
+
+    // handle all of the characters which are available from a serial port, such as
+    // Serial. returns the length of the line when a line has been ended, otherwise -1.
+    // the line is then available from line() until the next call of poll().
+    template <class S> int poll (S &port) {
+      if (bDone) {
+        bDone = false;        // the last line was handled, start a new one
+        nLength = 0;
+        aszLine[0] = 0;
+        iRecall = 0;
+      }
+      while (port.available () > 0) {
+        if (putChar (port, (uint8_t)port.read ())) {
+          bDone = true;
+          return nLength;
+        }
+      }
+      return -1;
+    }
+
+    char *line (void) { return aszLine; }
+    uint8_t length (void) const { return nLength; }
+    uint16_t overflowCount (void) const { return usOverflows; }
+
+  private:
+    // handle one character. returns true if it ended the line.
+    template <class S> bool putChar (S &port, uint8_t c) {
+      bool  bCr = (c == '\r');
+
+      if (uchEscape == 1) {                 // ESC, expect [ or O
+        uchEscape = (c == '[' || c == 'O') ? 2 : 0;
+        return false;
+      }
+      if (uchEscape == 2) {                 // ESC [, the final character of the sequence
+        if (c >= 0x40 && c <= 0x7e) {
+          uchEscape = 0;
+          if (c == 'A') recall (port, 1);
+          if (c == 'B') recall (port, -1);
+        }
+        return false;
+      }
+
+      if (c == '\n' && bLastCr) {           // the line feed of a carriage return line feed pair
+        bLastCr = false;
+        return false;
+      }
+      bLastCr = bCr;
+
+      switch (c) {
+        case '\r':
+        case '\n':
+          port.write ("\r\n");
+          if (nLength) addHistory ();
+          return true;
+        case 0x08:      // backspace
+        case 0x7f:      // delete
+          if (nLength) {
+            aszLine[--nLength] = 0;
+            port.write ("\b \b");
+          }
+          break;
+        case 0x15:      // Ctrl-U
+          erase (port);
+          break;
+        case 0x10:      // Ctrl-P
+          recall (port, 1);
+          break;
+        case 0x0e:      // Ctrl-N
+          recall (port, -1);
+          break;
+        case 0x1b:      // ESC, the start of an arrow key
+          uchEscape = 1;
+          break;
+        default:
+          if (c < ' ') break;       // ignore the other control characters
+          if (nLength >= N - 1) {
+            usOverflows++;
+            port.write ((uint8_t)0x07);     // bell, the line is full
+            break;
+          }
+          aszLine[nLength++] = c;
+          aszLine[nLength] = 0;
+          port.write (c);
+          break;
+      }
+      return false;
+    }
+
+    // erase the line being edited from the terminal and the buffer.
+    template <class S> void erase (S &port) {
+      if (nLength) {
+        char  aszMove[8];
+        snprintf (aszMove, sizeof(aszMove), "\x1b[%uD", (unsigned)nLength);     // move left nLength columns
+        port.write (aszMove);
+        port.write ("\x1b[K");      // erase to the end of the line
+      }
+      nLength = 0;
+      aszLine[0] = 0;
+    }
+
+    // replace the line with a line of the history, iStep 1 for the older line and -1 for
+    // the newer line. going newer than the newest line gives an empty line.
+    template <class S> void recall (S &port, int iStep) {
+      int  iNext = iRecall + iStep;
+
+      if (iNext < 0 || iNext > nHistory) return;
+      iRecall = (uint8_t)iNext;
+      erase (port);
+      if (iRecall) {
+        strcpy (aszLine, aaszHistory[(iNewest + H - (iRecall - 1)) % H]);
+        nLength = (uint8_t)strlen (aszLine);
+        port.write (aszLine);
+      }
+    }
+
+    // add the line to the history unless it is the same as the newest line.
+    void addHistory (void) {
+      if (nHistory && strcmp (aaszHistory[iNewest], aszLine) == 0) return;
+      if (nHistory) iNewest = (iNewest + 1) % H;
+      strcpy (aaszHistory[iNewest], aszLine);
+      if (nHistory < H) nHistory++;
+    }
+
+    char      aszLine[N];
+    uint8_t   nLength;          // number of characters in aszLine
+    bool      bDone;            // the line was ended and returned by poll()
+    bool      bLastCr;          // the last character was a carriage return
+    uint8_t   uchEscape;        // escape sequence state, 0 none, 1 after ESC, 2 after ESC [
+    char      aaszHistory[H][N];
+    uint8_t   nHistory;         // number of lines in the history
+    uint8_t   iNewest;          // index of the newest line of the history
+    uint8_t   iRecall;          // 0 editing a new line, otherwise how far back the line recalled is
+    uint16_t  usOverflows;      // number of characters thrown away since the line was full
+};
+
+#endif    // !defined(LINEEDITOR_H_INCLUDED)
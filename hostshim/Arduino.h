@@ -0,0 +1,156 @@
+/*
+ * Host shim for the Arduino core library.
+ *
+ * This provides enough of the Arduino runtime, the Serial port, the pin
+ * functions, and the timing functions, so that the sketches in this
+ * repository can be compiled and run on a host such as Linux. The sketch
+ * is compiled as C++ with this header forced in the same as the Arduino
+ * IDE does when it builds a sketch:
+ *
+ *     g++ -I hostshim -include Arduino.h -x c++ sketch.ino -x none hostshim/HostShim.cpp host.cpp
+ *
+ * The host program provides main() which calls the sketch setup() and loop()
+ * functions and uses the host functions, the ones whose names begin with host,
+ * to feed input to the sketch and to collect its output.
+ */
+
+#if !defined(HOSTSHIM_ARDUINO_H_INCLUDED)
+#define HOSTSHIM_ARDUINO_H_INCLUDED
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+typedef uint8_t  byte;
+typedef bool     boolean;
+
+#define HIGH            1
+#define LOW             0
+
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+
+#define DEC             10
+#define HEX             16
+
+// constant data in flash. the host has only the one address space so PROGMEM
+// does nothing and the pgm_read functions simply read memory.
+#define PROGMEM
+#define PSTR(s)                 (s)
+#define pgm_read_byte(p)        (*(const uint8_t *)(p))
+#define pgm_read_word(p)        (*(const uint16_t *)(p))
+#define memcpy_P                memcpy
+#define strlen_P                strlen
+
+// the pin change interrupts of the Uno. the pins of a port share an interrupt, pins 8 to
+// 13 are port B with PCINT0_vect, pins A0 to A5, 14 to 19, are port C with PCINT1_vect,
+// and pins 0 to 7 are port D with PCINT2_vect. a sketch defines the service routine of
+// a port with ISR() and it is called when a pin enabled in PCICR and PCMSK changes,
+// whether by hostSetPin(), digitalWrite(), or pinMode() with INPUT_PULLUP.
+#define ISR(vector)                 void vector (void)
+#define _BV(bit)                    (1 << (bit))
+
+void PCINT0_vect (void);
+void PCINT1_vect (void);
+void PCINT2_vect (void);
+
+extern volatile uint8_t  PCICR;
+extern volatile uint8_t  PCIFR;
+extern volatile uint8_t  PCMSK0;
+extern volatile uint8_t  PCMSK1;
+extern volatile uint8_t  PCMSK2;
+extern volatile uint8_t  hostPortInput[3];     // the PINx registers of ports B, C, and D
+
+#define digitalPinToPort(p)         ((p) < 8 ? 2 : (p) < 14 ? 0 : 1)
+#define digitalPinToBitMask(p)      _BV(digitalPinToPCMSKbit(p))
+#define portInputRegister(port)     (&hostPortInput[port])
+#define digitalPinToPCICR(p)        (&PCICR)
+#define digitalPinToPCICRbit(p)     digitalPinToPort(p)
+#define digitalPinToPCMSK(p)        ((p) < 8 ? &PCMSK2 : (p) < 14 ? &PCMSK0 : &PCMSK1)
+#define digitalPinToPCMSKbit(p)     ((p) < 8 ? (p) : (p) < 14 ? (p) - 8 : (p) - 14)
+
+long random (long howbig);
+long random (long howsmall, long howbig);
+void randomSeed (unsigned long seed);
+
+unsigned long millis (void);
+unsigned long micros (void);
+void delay (unsigned long ms);
+void delayMicroseconds (unsigned int us);
+
+void pinMode (uint8_t pin, uint8_t mode);
+int  digitalRead (uint8_t pin);
+void digitalWrite (uint8_t pin, uint8_t val);
+
+// a subset of the Arduino String class, enough for building a command
+// one character at a time as the sketches do.
+class String {
+  public:
+    String (const char *psz = "") : s(psz) {}
+    String &operator = (const char *psz) { s = psz; return *this; }
+    String &operator += (char c) { s += c; return *this; }
+    char operator [] (unsigned int i) const { return (i < s.length()) ? s[i] : 0; }
+    unsigned int length (void) const { return (unsigned int)s.length(); }
+    const char *c_str (void) const { return s.c_str(); }
+
+  private:
+    std::string  s;
+};
+
+// the Serial port. input is provided by the host with hostSerialInput() and
+// output written by the sketch is collected for the host in hostSerialOutput.
+class HardwareSerial {
+  public:
+    void begin (unsigned long baud) { ulBaud = baud; }
+    void end (void) {}
+    operator bool (void) const { return true; }
+
+    int available (void);
+    int availableForWrite (void) { return 64; }
+    int peek (void);
+    int read (void);
+    size_t readBytes (char *buffer, size_t length);
+    void setTimeout (unsigned long timeout) { ulTimeout = timeout; }
+    void flush (void) {}
+
+    size_t write (uint8_t c);
+    size_t write (const char *psz) { return write ((const uint8_t *)psz, strlen (psz)); }
+    size_t write (const uint8_t *buffer, size_t size);
+    size_t write (const char *buffer, size_t size) { return write ((const uint8_t *)buffer, size); }
+
+    size_t print (const char *psz) { return write (psz); }
+    size_t print (char c) { return write ((uint8_t)c); }
+    size_t print (int n, int base = DEC) { return print ((long)n, base); }
+    size_t print (unsigned int n, int base = DEC) { return print ((unsigned long)n, base); }
+    size_t print (long n, int base = DEC);
+    size_t print (unsigned long n, int base = DEC);
+    size_t print (double d, int digits = 2);
+    size_t print (const String &s) { return write (s.c_str()); }
+
+    size_t println (void) { return write ("\r\n"); }
+    template <typename T> size_t println (T x) { size_t n = print (x); return n + println (); }
+    template <typename T> size_t println (T x, int y) { size_t n = print (x, y); return n + println (); }
+
+    unsigned long  ulBaud = 0;
+    unsigned long  ulTimeout = 1000;
+};
+
+extern HardwareSerial Serial;
+
+// host side functions used by the host program to drive a sketch.
+
+void hostSerialInput (const char *pData, size_t nBytes);    // queue bytes for Serial.read()
+extern std::string  hostSerialOutput;                        // bytes written by the sketch
+
+void hostSetPin (uint8_t pin, int val);     // set the value digitalRead() returns for a pin
+int  hostGetPin (uint8_t pin);              // get the value last written with digitalWrite()
+
+// stop, or start again, the host clock so that millis() and micros() move only with
+// delay() and delayMicroseconds(), for simulations which time the edges of a pin.
+void hostClockManual (bool bManual);
+
+#endif    // !defined(HOSTSHIM_ARDUINO_H_INCLUDED)
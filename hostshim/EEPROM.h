@@ -0,0 +1,46 @@
+/*
+ * Host shim for the EEPROM library.
+ *
+ * The 1 KB EEPROM of the Uno is kept in memory. It starts erased, every byte 0xff,
+ * as the EEPROM of a new Arduino is. The host can read the number of times each
+ * byte was written to check wear leveling and can make the writes stop after a
+ * number of bytes to test what a sketch does when the power fails during a write.
+ */
+
+#if !defined(HOSTSHIM_EEPROM_H_INCLUDED)
+#define HOSTSHIM_EEPROM_H_INCLUDED
+
+#include "Arduino.h"
+
+#define HOST_EEPROM_SIZE  1024
+
+uint8_t hostEepromRead (int idx);
+void hostEepromWrite (int idx, uint8_t val);
+
+struct EEPROMClass {
+  uint8_t read (int idx) { return hostEepromRead (idx); }
+  void write (int idx, uint8_t val) { hostEepromWrite (idx, val); }
+  void update (int idx, uint8_t val) { if (read (idx) != val) write (idx, val); }
+  uint16_t length (void) { return HOST_EEPROM_SIZE; }
+
+  template <typename T> T &get (int idx, T &t) {
+    uint8_t  *p = (uint8_t *)&t;
+    for (size_t i = 0; i < sizeof(T); i++) p[i] = read (idx + (int)i);
+    return t;
+  }
+  template <typename T> const T &put (int idx, const T &t) {
+    const uint8_t  *p = (const uint8_t *)&t;
+    for (size_t i = 0; i < sizeof(T); i++) update (idx + (int)i, p[i]);
+    return t;
+  }
+};
+
+extern EEPROMClass EEPROM;
+
+// host side functions used by the host program to check and disturb the EEPROM.
+
+void hostEepromErase (void);                        // set every byte to 0xff and the write counts to 0
+unsigned long hostEepromWriteCount (int idx);       // number of times the byte was written
+void hostEepromFailAfter (long lWrites);            // ignore the writes after the next lWrites, -1 for none
+
+#endif    // !defined(HOSTSHIM_EEPROM_H_INCLUDED)
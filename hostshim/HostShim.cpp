@@ -0,0 +1,272 @@
+/*
+ * Host shim for the Arduino core library.
+ *
+ * See Arduino.h for a description.
+ */
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "Keypad.h"
+
+#include <chrono>
+#include <deque>
+
+HardwareSerial Serial;
+EEPROMClass    EEPROM;
+
+std::string  hostSerialOutput;
+
+static std::deque<uint8_t>  hostSerialIn;
+static std::deque<char>     hostKeys;
+static int                  hostPins[64];
+
+volatile uint8_t            PCICR = 0;
+volatile uint8_t            PCIFR = 0;
+volatile uint8_t            PCMSK0 = 0;
+volatile uint8_t            PCMSK1 = 0;
+volatile uint8_t            PCMSK2 = 0;
+volatile uint8_t            hostPortInput[3];
+
+// the default pin change interrupt service routines for a sketch which does not have one.
+__attribute__((weak)) void PCINT0_vect (void) {}
+__attribute__((weak)) void PCINT1_vect (void) {}
+__attribute__((weak)) void PCINT2_vect (void) {}
+
+static uint8_t              hostEeprom[HOST_EEPROM_SIZE];
+static unsigned long        hostEepromWrites[HOST_EEPROM_SIZE];
+static long                 hostEepromWritesLeft = -1;
+static bool                 hostEepromErased = false;
+
+// the time is the host clock plus the time spent in delay() and delayMicroseconds()
+// which do not wait but instead move the time forward so that simulations run fast.
+static unsigned long long   ullDelayMicros = 0;
+static unsigned long long   ullClockMicros = 0;     // the host clock when it was stopped
+static bool                 bClockManual = false;
+
+static unsigned long long hostClock (void)
+{
+    static const std::chrono::steady_clock::time_point  tStart = std::chrono::steady_clock::now();
+
+    return (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tStart).count();
+}
+
+static unsigned long long hostMicros (void)
+{
+    return (bClockManual ? ullClockMicros : hostClock ()) + ullDelayMicros;
+}
+
+void hostClockManual (bool bManual)
+{
+    if (bManual == bClockManual) return;
+    if (bManual) {
+        ullClockMicros = hostClock ();
+    } else {
+        ullDelayMicros -= hostClock () - ullClockMicros;     // carry on from the same time
+    }
+    bClockManual = bManual;
+}
+
+unsigned long millis (void)
+{
+    return (unsigned long)(hostMicros () / 1000);
+}
+
+unsigned long micros (void)
+{
+    return (unsigned long)hostMicros ();
+}
+
+void delay (unsigned long ms)
+{
+    ullDelayMicros += ms * 1000ULL;
+}
+
+void delayMicroseconds (unsigned int us)
+{
+    ullDelayMicros += us;
+}
+
+long random (long howbig)
+{
+    return (howbig > 0) ? rand () % howbig : 0;
+}
+
+long random (long howsmall, long howbig)
+{
+    return (howbig > howsmall) ? howsmall + random (howbig - howsmall) : howsmall;
+}
+
+void randomSeed (unsigned long seed)
+{
+    srand ((unsigned int)seed);
+}
+
+// change the level of a pin, keep the PINx register of its port, and call the pin
+// change interrupt service routine of the port if the pin has its interrupt enabled.
+static void hostPinLevel (uint8_t pin, int val)
+{
+    pin &= 63;
+    if (hostPins[pin] == val) return;
+    hostPins[pin] = val;
+    if (pin >= 20) return;
+
+    uint8_t  uchPort = digitalPinToPort (pin);
+    uint8_t  uchMask = digitalPinToBitMask (pin);
+
+    if (val) hostPortInput[uchPort] |= uchMask;
+    else hostPortInput[uchPort] &= ~uchMask;
+
+    if ((PCICR & _BV (uchPort)) && (*digitalPinToPCMSK (pin) & uchMask)) {
+        switch (uchPort) {
+            case 0: PCINT0_vect (); break;
+            case 1: PCINT1_vect (); break;
+            case 2: PCINT2_vect (); break;
+        }
+    }
+}
+
+void pinMode (uint8_t pin, uint8_t mode)
+{
+    if (mode == INPUT_PULLUP) hostPinLevel (pin, HIGH);
+}
+
+int digitalRead (uint8_t pin)
+{
+    return hostPins[pin & 63];
+}
+
+void digitalWrite (uint8_t pin, uint8_t val)
+{
+    hostPinLevel (pin, val);
+}
+
+void hostSetPin (uint8_t pin, int val)
+{
+    hostPinLevel (pin, val);
+}
+
+int hostGetPin (uint8_t pin)
+{
+    return hostPins[pin & 63];
+}
+
+int HardwareSerial::available (void)
+{
+    return (int)hostSerialIn.size();
+}
+
+int HardwareSerial::peek (void)
+{
+    return hostSerialIn.empty() ? -1 : hostSerialIn.front();
+}
+
+int HardwareSerial::read (void)
+{
+    if (hostSerialIn.empty()) return -1;
+
+    int c = hostSerialIn.front();
+    hostSerialIn.pop_front();
+    return c;
+}
+
+size_t HardwareSerial::readBytes (char *buffer, size_t length)
+{
+    size_t  n = 0;
+
+    // there is no one to send more data while the sketch waits so rather than
+    // wait for the timeout, move the time forward as if the wait had happened.
+    while (n < length && !hostSerialIn.empty()) {
+        buffer[n++] = (char)read ();
+    }
+    if (n < length) delay (ulTimeout);
+    return n;
+}
+
+size_t HardwareSerial::write (uint8_t c)
+{
+    hostSerialOutput += (char)c;
+    return 1;
+}
+
+size_t HardwareSerial::write (const uint8_t *buffer, size_t size)
+{
+    hostSerialOutput.append ((const char *)buffer, size);
+    return size;
+}
+
+size_t HardwareSerial::print (long n, int base)
+{
+    char  cBuff[40];
+
+    if (base == HEX) snprintf (cBuff, sizeof(cBuff), "%lX", n);
+    else snprintf (cBuff, sizeof(cBuff), "%ld", n);
+    return write (cBuff);
+}
+
+size_t HardwareSerial::print (unsigned long n, int base)
+{
+    char  cBuff[40];
+
+    if (base == HEX) snprintf (cBuff, sizeof(cBuff), "%lX", n);
+    else snprintf (cBuff, sizeof(cBuff), "%lu", n);
+    return write (cBuff);
+}
+
+size_t HardwareSerial::print (double d, int digits)
+{
+    char  cBuff[40];
+
+    snprintf (cBuff, sizeof(cBuff), "%.*f", digits, d);
+    return write (cBuff);
+}
+
+void hostSerialInput (const char *pData, size_t nBytes)
+{
+    hostSerialIn.insert (hostSerialIn.end(), pData, pData + nBytes);
+}
+
+void hostKeyPress (char key)
+{
+    hostKeys.push_back (key);
+}
+
+char hostKeyGet (void)
+{
+    if (hostKeys.empty()) return NO_KEY;
+
+    char key = hostKeys.front();
+    hostKeys.pop_front();
+    return key;
+}
+
+uint8_t hostEepromRead (int idx)
+{
+    if (!hostEepromErased) hostEepromErase ();
+    return (idx >= 0 && idx < HOST_EEPROM_SIZE) ? hostEeprom[idx] : 0xff;
+}
+
+void hostEepromWrite (int idx, uint8_t val)
+{
+    if (!hostEepromErased) hostEepromErase ();
+    if (idx < 0 || idx >= HOST_EEPROM_SIZE || hostEepromWritesLeft == 0) return;
+    if (hostEepromWritesLeft > 0) hostEepromWritesLeft--;
+    hostEeprom[idx] = val;
+    hostEepromWrites[idx]++;
+}
+
+void hostEepromErase (void)
+{
+    memset (hostEeprom, 0xff, sizeof(hostEeprom));
+    memset (hostEepromWrites, 0, sizeof(hostEepromWrites));
+    hostEepromErased = true;
+}
+
+unsigned long hostEepromWriteCount (int idx)
+{
+    return (idx >= 0 && idx < HOST_EEPROM_SIZE) ? hostEepromWrites[idx] : 0;
+}
+
+void hostEepromFailAfter (long lWrites)
+{
+    hostEepromWritesLeft = lWrites;
+}
@@ -0,0 +1,28 @@
+/*
+ * Host shim for the Keypad library.
+ *
+ * Key presses are provided by the host with hostKeyPress() and returned
+ * one at a time by getKey() the same as if the keys were pressed on the
+ * membrane keypad.
+ */
+
+#if !defined(HOSTSHIM_KEYPAD_H_INCLUDED)
+#define HOSTSHIM_KEYPAD_H_INCLUDED
+
+#include "Arduino.h"
+
+#define NO_KEY  '\0'
+
+#define makeKeymap(x)  ((char*)x)
+
+void hostKeyPress (char key);
+char hostKeyGet (void);
+
+class Keypad {
+  public:
+    Keypad (char *userKeymap, byte *row, byte *col, byte numRows, byte numCols) {}
+
+    char getKey (void) { return hostKeyGet (); }
+};
+
+#endif    // !defined(HOSTSHIM_KEYPAD_H_INCLUDED)
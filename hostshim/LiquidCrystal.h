@@ -0,0 +1,34 @@
+/*
+ * Host shim for the LiquidCrystal library.
+ *
+ * The display contents are kept in a text buffer, hostDisplay, so that
+ * a host program can check what a sketch would show on the LCD.
+ */
+
+#if !defined(HOSTSHIM_LIQUIDCRYSTAL_H_INCLUDED)
+#define HOSTSHIM_LIQUIDCRYSTAL_H_INCLUDED
+
+#include "Arduino.h"
+
+class LiquidCrystal {
+  public:
+    LiquidCrystal (uint8_t rs, uint8_t enable, uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3) { clear (); }
+
+    void begin (uint8_t cols, uint8_t rows) { clear (); }
+    void clear (void) { memset (hostDisplay, ' ', sizeof(hostDisplay)); iCol = iRow = 0; }
+    void setCursor (uint8_t col, uint8_t row) { iCol = col; iRow = row; }
+    size_t write (uint8_t c) {
+      if (iRow < 2 && iCol < 16) hostDisplay[iRow][iCol] = c;
+      iCol++;
+      return 1;
+    }
+    size_t print (const char *psz) { size_t n = 0; while (*psz) n += write (*psz++); return n; }
+    size_t print (char c) { return write (c); }
+
+    char  hostDisplay[2][16];
+
+  private:
+    int   iCol, iRow;
+};
+
+#endif    // !defined(HOSTSHIM_LIQUIDCRYSTAL_H_INCLUDED)
@@ -0,0 +1,17 @@
+/*
+ * Keys of the settings kept in the ConfigStore by the sketches of this repository.
+ *
+ * The sketches all keep their store in the whole EEPROM of the Uno, so a board moved from
+ * one sketch to another, or a sketch built from the tasks of several, finds the settings of
+ * the others in the same log. Each key is defined here once so that no two sketches use a
+ * key for different settings. A sketch ignores the keys which are not its own. Never reuse
+ * the number of a key which is no longer used, a board may still have the old record.
+ */
+
+#if !defined(CONFIGKEYS_H_INCLUDED)
+#define CONFIGKEYS_H_INCLUDED
+
+#define CONFIG_DEVICE_NAME      1     // cmndline, text string that identifies the device, up to 23 characters
+#define CONFIG_SCALE_DEFAULTS   2     // serialcommands, iUnits, specInUse, s1, and s2, a byte each
+
+#endif    // !defined(CONFIGKEYS_H_INCLUDED)
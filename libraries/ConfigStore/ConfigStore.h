@@ -0,0 +1,274 @@
+/*
+ * Key and value configuration store kept in EEPROM.
+ *
+ * Writing a setting to the same EEPROM address each time it changes wears out those
+ * cells, an EEPROM cell is good for about 100,000 writes, and if the power fails during
+ * the write the setting is left half written with nothing to show that it is garbage.
+ *
+ * The ConfigStore instead keeps the settings as a log. The EEPROM area is divided into
+ * segments and a change of a setting is a record appended to the log in the active
+ * segment. When the active segment is full the latest value of each setting is copied
+ * to the next segment, which becomes the active segment, so the writes move around all
+ * of the segments rather than wearing out one place.
+ *
+ *     segment    marker 0xa5, sequence number low and high bytes, CRC-8 of the three
+ *                followed by records and then free space which is all 0xff
+ *     record     key, length, the value of length bytes, CRC-8 of the key, length, and value
+ *
+ * The active segment is the one with a good header and the newest sequence number. The
+ * key of a record is written last so a record whose write was cut off by a power failure
+ * still has the key 0xff of free space and is not seen. Its other bytes are still there
+ * though, and a shorter record appended in its place would leave some of them after it
+ * to be read as a record at the next startup, so begin() checks that the free space is
+ * all 0xff and if it is not copies the settings to the next segment. A segment is
+ * activated by writing its marker last, after the records copied to it, so a copy which
+ * is cut off leaves the previous segment active. Any other damage, a record with a bad CRC, ends the log where
+ * it is found and the good records are copied to the next segment at startup.
+ *
+ * The settings are also kept in a RAM cache of CACHE bytes, each a key, a length, and the
+ * value, which begin() loads from the log. Reading a setting never touches the EEPROM
+ * and setting a value which is the same as the one cached writes nothing. The cache must
+ * be large enough for all of the settings and all of the settings must fit in a segment.
+ *
+ * The store is used through the EEPROM object of the Arduino EEPROM library, or any class
+ * with the read() and update() methods of EEPROMClass, so that it can be tested on a host.
+ * Writing a byte of EEPROM takes 3.3 milliseconds on the AVR so set() and, much more,
+ * copying the settings to the next segment hold up loop() while they write.
+ *
+ * Usage:
+ *     ConfigStore<EEPROMClass, 64>  config (EEPROM, 0, 1024, 4);   // all 1 KB in 4 segments
+ *
+ *     config.begin ();
+ *     config.set (CONFIG_DEVICE_NAME, aszName, strlen (aszName));
+ *     int  nLength = config.get (CONFIG_DEVICE_NAME, aszName, sizeof(aszName) - 1);
+ */
+
+#if !defined(CONFIGSTORE_H_INCLUDED)
+#define CONFIGSTORE_H_INCLUDED
+
+#include <stdint.h>
+#include <string.h>
+
+#define CONFIG_SEGMENT_MARKER   0xa5
+#define CONFIG_HEADER_SIZE      4       // marker, sequence number, CRC
+#define CONFIG_RECORD_EXTRA     3       // key, length, and CRC of a record
+#define CONFIG_KEY_FREE         0xff    // the key of free space, not a usable key
+
+template <class E, uint8_t CACHE>     // the EEPROM class, size of the RAM cache in bytes
+class ConfigStore {
+  public:
+    // the store uses usSize bytes of EEPROM starting at usStart divided into nSegs segments.
+    ConfigStore (E &e, uint16_t usStart, uint16_t usSize, uint8_t nSegs) :
+      eeprom(e), usBase(usStart), usSegmentSize(usSize / nSegs), nSegments(nSegs),
+      iActive(0), usSequence(0), usWrite(0), nCacheUsed(0), usCompactions(0), usRepairs(0) {}
+
+    // load the settings from the log. an EEPROM with no good segment, such as a new one,
+    // is made into an empty store. returns false if the store was empty or damaged.
+    bool begin (void) {
+      bool  bFound = false;
+
+      nCacheUsed = 0;
+      for (uint8_t i = 0; i < nSegments; i++) {
+        uint16_t  usSeq;
+        if (readHeader (i, usSeq) && (!bFound || (int16_t)(usSeq - usSequence) > 0)) {
+          bFound = true;
+          iActive = i;
+          usSequence = usSeq;
+        }
+      }
+      if (!bFound) {
+        iActive = nSegments - 1;      // compact() starts the store in segment 0
+        usSequence = 0xffff;
+        compact ();
+        return false;
+      }
+
+      // replay the records of the active segment into the cache.
+      uint16_t  usEnd = segmentStart (iActive) + usSegmentSize;
+      usWrite = segmentStart (iActive) + CONFIG_HEADER_SIZE;
+      while (usWrite < usEnd) {
+        uint8_t  uchKey = eeprom.read (usWrite);
+        if (uchKey == CONFIG_KEY_FREE) {
+          if (isFree (usWrite, usEnd)) return true;
+          break;        // the bytes of a record cut off by a power failure
+        }
+
+        uint8_t  auchValue[CACHE];
+        uint8_t  nLength = eeprom.read (usWrite + 1);
+        if (usWrite + CONFIG_RECORD_EXTRA + nLength > usEnd || nLength > CACHE) break;
+
+        uint8_t  uchCrc = crc8 (crc8 (0, uchKey), nLength);
+        for (uint8_t i = 0; i < nLength; i++) {
+          auchValue[i] = eeprom.read (usWrite + 2 + i);
+          uchCrc = crc8 (uchCrc, auchValue[i]);
+        }
+        if (uchCrc != eeprom.read (usWrite + 2 + nLength)) break;
+
+        cachePut (uchKey, auchValue, nLength);
+        usWrite += CONFIG_RECORD_EXTRA + nLength;
+      }
+
+      // the log ended with a bad record, or free space which is not all 0xff, rather than
+      // free space. copy the good records to the next segment so that new records are not
+      // appended after the damage.
+      usRepairs++;
+      compact ();
+      return false;
+    }
+
+    // copy the value of a setting into pData. returns the length of the value, which
+    // is truncated to nSize, or -1 if the setting has not been set.
+    int get (uint8_t uchKey, void *pData, uint8_t nSize) const {
+      const uint8_t  *pEntry = cacheFind (uchKey);
+
+      if (pEntry == 0) return -1;
+      uint8_t  nLength = (pEntry[1] < nSize) ? pEntry[1] : nSize;
+      memcpy (pData, pEntry + 2, nLength);
+      return nLength;
+    }
+
+    // set the value of a setting, a length of 0 removes the setting. returns false if
+    // the key is not usable or the setting does not fit in the cache or a segment.
+    bool set (uint8_t uchKey, const void *pData, uint8_t nLength) {
+      const uint8_t  *pEntry = cacheFind (uchKey);
+
+      if (uchKey == CONFIG_KEY_FREE) return false;
+      if (pEntry && pEntry[1] == nLength && memcmp (pEntry + 2, pData, nLength) == 0) return true;
+      if (pEntry == 0 && nLength == 0) return true;
+
+      uint16_t  usNeeded = nCacheUsed - (pEntry ? 2 + pEntry[1] : 0) + (nLength ? 2 + nLength : 0);
+      if (usNeeded > CACHE || CONFIG_HEADER_SIZE + cacheRecords (uchKey, nLength) > usSegmentSize) return false;
+
+      cachePut (uchKey, (const uint8_t *)pData, nLength);
+      if (usWrite + CONFIG_RECORD_EXTRA + nLength > segmentStart (iActive) + usSegmentSize) {
+        compact ();       // the new value is copied along with the others
+      } else {
+        writeRecord (usWrite, uchKey, (const uint8_t *)pData, nLength);
+        usWrite += CONFIG_RECORD_EXTRA + nLength;
+      }
+      return true;
+    }
+
+    uint8_t  activeSegment (void) const { return iActive; }
+    uint16_t sequence (void) const { return usSequence; }
+    uint16_t bytesFree (void) const { return segmentStart (iActive) + usSegmentSize - usWrite; }
+    uint8_t  cacheUsed (void) const { return nCacheUsed; }
+    uint16_t compactionCount (void) const { return usCompactions; }
+    uint16_t repairCount (void) const { return usRepairs; }
+
+  private:
+    static uint8_t crc8 (uint8_t uchCrc, uint8_t c) {      // CRC-8, polynomial 0x07
+      uchCrc ^= c;
+      for (uint8_t i = 0; i < 8; i++) uchCrc = (uchCrc & 0x80) ? (uint8_t)((uchCrc << 1) ^ 0x07) : (uint8_t)(uchCrc << 1);
+      return uchCrc;
+    }
+
+    uint16_t segmentStart (uint8_t iSegment) const { return usBase + iSegment * usSegmentSize; }
+
+    bool readHeader (uint8_t iSegment, uint16_t &usSeq) {
+      uint16_t  usAddr = segmentStart (iSegment);
+      uint8_t   uchLow = eeprom.read (usAddr + 1), uchHigh = eeprom.read (usAddr + 2);
+
+      usSeq = uchLow | (uint16_t)(uchHigh << 8);
+      return eeprom.read (usAddr) == CONFIG_SEGMENT_MARKER
+          && eeprom.read (usAddr + 3) == crc8 (crc8 (crc8 (0, CONFIG_SEGMENT_MARKER), uchLow), uchHigh);
+    }
+
+    // true if the bytes from usAddr up to usEnd are all 0xff.
+    bool isFree (uint16_t usAddr, uint16_t usEnd) {
+      for (; usAddr < usEnd; usAddr++) {
+        if (eeprom.read (usAddr) != 0xff) return false;
+      }
+      return true;
+    }
+
+    // write a record with its key last, see above.
+    void writeRecord (uint16_t usAddr, uint8_t uchKey, const uint8_t *pValue, uint8_t nLength) {
+      uint8_t  uchCrc = crc8 (crc8 (0, uchKey), nLength);
+
+      eeprom.update (usAddr + 1, nLength);
+      for (uint8_t i = 0; i < nLength; i++) {
+        eeprom.update (usAddr + 2 + i, pValue[i]);
+        uchCrc = crc8 (uchCrc, pValue[i]);
+      }
+      eeprom.update (usAddr + 2 + nLength, uchCrc);
+      eeprom.update (usAddr, uchKey);
+    }
+
+    // copy the cached settings to the next segment and make it the active segment.
+    void compact (void) {
+      uint8_t   iNext = (iActive + 1) % nSegments;
+      uint16_t  usSeq = usSequence + 1;
+      uint16_t  usAddr = segmentStart (iNext);
+      uint16_t  usEnd = usAddr + usSegmentSize;
+
+      eeprom.update (usAddr, CONFIG_KEY_FREE);      // not a good segment until it is complete
+      usWrite = usAddr + CONFIG_HEADER_SIZE;
+      for (uint8_t i = 0; i < nCacheUsed; i += 2 + auchCache[i + 1]) {
+        writeRecord (usWrite, auchCache[i], auchCache + i + 2, auchCache[i + 1]);
+        usWrite += CONFIG_RECORD_EXTRA + auchCache[i + 1];
+      }
+      // free space must be all 0xff so that a record left from the last time the segment
+      // was used is not taken as part of the log.
+      for (uint16_t a = usWrite; a < usEnd; a++) eeprom.update (a, 0xff);
+
+      eeprom.update (usAddr + 1, (uint8_t)usSeq);
+      eeprom.update (usAddr + 2, (uint8_t)(usSeq >> 8));
+      eeprom.update (usAddr + 3, crc8 (crc8 (crc8 (0, CONFIG_SEGMENT_MARKER), (uint8_t)usSeq), (uint8_t)(usSeq >> 8)));
+      eeprom.update (usAddr, CONFIG_SEGMENT_MARKER);
+
+      iActive = iNext;
+      usSequence = usSeq;
+      usCompactions++;
+    }
+
+    const uint8_t *cacheFind (uint8_t uchKey) const {
+      for (uint8_t i = 0; i < nCacheUsed; i += 2 + auchCache[i + 1]) {
+        if (auchCache[i] == uchKey) return auchCache + i;
+      }
+      return 0;
+    }
+
+    // the bytes the records of the cached settings would take in a segment with the
+    // setting uchKey given the length nLength.
+    uint16_t cacheRecords (uint8_t uchKey, uint8_t nLength) const {
+      uint16_t  usBytes = nLength ? CONFIG_RECORD_EXTRA + nLength : 0;
+
+      for (uint8_t i = 0; i < nCacheUsed; i += 2 + auchCache[i + 1]) {
+        if (auchCache[i] != uchKey) usBytes += CONFIG_RECORD_EXTRA + auchCache[i + 1];
+      }
+      return usBytes;
+    }
+
+    // replace the cached value of a setting, a length of 0 removes it. the caller has
+    // checked that it fits.
+    void cachePut (uint8_t uchKey, const uint8_t *pValue, uint8_t nLength) {
+      const uint8_t  *pEntry = cacheFind (uchKey);
+
+      if (pEntry) {
+        uint8_t  iEntry = (uint8_t)(pEntry - auchCache);
+        uint8_t  nEntry = 2 + pEntry[1];
+        memmove (auchCache + iEntry, auchCache + iEntry + nEntry, nCacheUsed - iEntry - nEntry);
+        nCacheUsed -= nEntry;
+      }
+      if (nLength == 0 || nCacheUsed + 2 + nLength > CACHE) return;
+      auchCache[nCacheUsed] = uchKey;
+      auchCache[nCacheUsed + 1] = nLength;
+      memcpy (auchCache + nCacheUsed + 2, pValue, nLength);
+      nCacheUsed += 2 + nLength;
+    }
+
+    E         &eeprom;
+    uint16_t   usBase;            // address of the first segment
+    uint16_t   usSegmentSize;
+    uint8_t    nSegments;
+    uint8_t    iActive;           // the segment the log is appended to
+    uint16_t   usSequence;        // sequence number of the active segment
+    uint16_t   usWrite;           // address the next record is written to
+    uint8_t    auchCache[CACHE];  // the settings, key, length, and value of each
+    uint8_t    nCacheUsed;
+    uint16_t   usCompactions;     // number of times the settings were copied to the next segment
+    uint16_t   usRepairs;         // number of times a damaged log was found by begin()
+};
+
+#endif    // !defined(CONFIGSTORE_H_INCLUDED)
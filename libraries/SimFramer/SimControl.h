@@ -0,0 +1,189 @@
+/*
+ * Binary control channel of the simulators for automated test rigs.
+ *
+ * The simulators are set up with the keypad, which is fine for a person at the bench
+ * but not for a test script which needs to go through thousands of combinations of
+ * settings. The control channel is a second protocol on the same Serial port as the
+ * commands of the point of sale terminal with length prefixed, CRC checked frames:
+ *
+ *     sync 0xA5, length, payload of length bytes, CRC-16 low byte, CRC-16 high byte
+ *
+ * The CRC is the CRC-16/CCITT, polynomial 0x1021 and initial value 0xFFFF, of the length
+ * and the payload. The first byte of the payload is the command and the rest are its
+ * arguments, numbers of more than one byte are little endian. A reply is a frame whose
+ * command is that of the request with SIMCTL_REPLY set followed by a status byte, one of
+ * SimCtlStatus, and any data. A frame with a bad CRC or length is answered as though its
+ * command were 0, with 0x80 and status SimCtlBadFrame, so the host can send it again
+ * rather than wait for a timeout.
+ *
+ * The commands of the point of sale terminal are 7 bit characters so the sync byte never
+ * appears in them and the port is used for both at once, a byte is given to putByte()
+ * and if it is not part of a control frame it is given to the SimFramer of the commands.
+ * The host must use 8 data bits to send the frames. A frame which stops part way through
+ * is thrown away by reset(), which the sketch calls when the line has been idle for
+ * SIMCTL_IDLE_MSEC.
+ *
+ * The same class is used by a host program to decode the replies and encode() makes
+ * the frames for both.
+ *
+ * Usage:
+ *     SimControl     simControl;
+ *     SimFramer<32>  cmdFramer;
+ *     uint8_t        auchPayload[SIMCTL_PAYLOAD_MAX];
+ *
+ *     if (!simControl.putByte (c)) cmdFramer.putByte (c);
+ *     int  nLength = simControl.getFrame (auchPayload);
+ *     if (nLength != SIMCTL_NO_FRAME) ... handle the command, send the reply ...
+ */
+
+#if !defined(SIMCONTROL_H_INCLUDED)
+#define SIMCONTROL_H_INCLUDED
+
+#include <stdint.h>
+#include <string.h>
+
+#define SIMCTL_SYNC           0xA5    // first byte of a frame
+#define SIMCTL_PAYLOAD_MAX    16      // largest payload, command and arguments
+#define SIMCTL_FRAME_MAX      (SIMCTL_PAYLOAD_MAX + 4)    // sync, length, payload, and CRC
+#define SIMCTL_REPLY          0x80    // set in the command of a reply
+#define SIMCTL_IDLE_MSEC      50      // a frame not finished after the line is idle this long is thrown away
+
+#define SIMCTL_NO_FRAME       -1      // getFrame() has no frame
+#define SIMCTL_BAD_FRAME      0       // getFrame() has a frame with a bad CRC or length
+
+// commands which are the same for each simulator. the commands of a simulator, such as
+// setting the weight of the scale, are numbered from 0x01 to 0x3f.
+#define SIMCTL_CMD_BAUD       0x40    // uint32 baud rate, the reply is sent at the old rate then the rate is changed
+
+enum SimCtlStatus { SimCtlOk = 0, SimCtlBadFrame, SimCtlUnknown, SimCtlBadLength, SimCtlBadValue };
+
+// the baud rates the simulators change to with SIMCTL_CMD_BAUD. 250000, 500000, and
+// 1000000 are exact on a 16 MHz Uno, 115200 and 230400 are within the 2% or so a UART
+// can tolerate.
+inline bool simControlBaud (uint32_t ulBaud)
+{
+  switch (ulBaud) {
+    case 9600: case 19200: case 38400: case 57600: case 115200:
+    case 230400: case 250000: case 500000: case 1000000:
+      return true;
+    default:
+      return false;
+  }
+}
+
+class SimControl {
+  public:
+    SimControl () : uchState(StateSync), uchLength(0), nReceived(0), uchCrcLow(0), usCrc(0), iFrame(SIMCTL_NO_FRAME), usFrames(0), usErrors(0) {}
+
+    // give the decoder the next byte from the port. returns false if the byte is not part
+    // of a control frame, in which case it belongs to the commands of the terminal.
+    bool putByte (uint8_t c) {
+      switch (uchState) {
+        case StateSync:
+          if (c != SIMCTL_SYNC) return false;
+          uchState = StateLength;
+          return true;
+        case StateLength:
+          if (c == 0 || c > SIMCTL_PAYLOAD_MAX) {
+            badFrame ();
+            return true;
+          }
+          uchLength = c;
+          nReceived = 0;
+          usCrc = crc16 (0xFFFF, c);
+          uchState = StatePayload;
+          return true;
+        case StatePayload:
+          auchPayload[nReceived++] = c;
+          usCrc = crc16 (usCrc, c);
+          if (nReceived == uchLength) uchState = StateCrcLow;
+          return true;
+        case StateCrcLow:
+          uchCrcLow = c;
+          uchState = StateCrcHigh;
+          return true;
+        default:
+          if ((uint16_t)(uchCrcLow | (c << 8)) != usCrc) {
+            badFrame ();
+            return true;
+          }
+          uchState = StateSync;
+          iFrame = uchLength;
+          usFrames++;
+          return true;
+      }
+    }
+
+    // copy the payload of the frame received into pPayload, which must be SIMCTL_PAYLOAD_MAX
+    // bytes. returns the length of the payload, SIMCTL_BAD_FRAME for a frame which should be
+    // answered with SimCtlBadFrame, or SIMCTL_NO_FRAME. the decoder keeps one frame so this
+    // is called after each byte which was part of a frame.
+    int getFrame (uint8_t *pPayload) {
+      int  iLength = iFrame;
+
+      if (iLength > 0) memcpy (pPayload, auchPayload, iLength);
+      iFrame = SIMCTL_NO_FRAME;
+      return iLength;
+    }
+
+    // throw away a frame which stopped part way through. returns true if there was one.
+    // the frame is counted as an error but not answered, the host has given up on it.
+    bool reset (void) {
+      if (uchState == StateSync) return false;
+      uchState = StateSync;
+      usErrors++;
+      return true;
+    }
+
+    bool busy (void) const { return uchState != StateSync; }
+
+    uint16_t frameCount (void) const { return usFrames; }     // number of good frames received
+    uint16_t errorCount (void) const { return usErrors; }     // number of frames with a bad CRC or length or cut short
+
+    // make a frame of a payload of 1 to SIMCTL_PAYLOAD_MAX bytes in pFrame, which must be
+    // SIMCTL_FRAME_MAX bytes. returns the length of the frame.
+    static uint8_t encode (uint8_t *pFrame, const uint8_t *pPayload, uint8_t nLength) {
+      uint16_t  usCrc = crc16 (0xFFFF, nLength);
+
+      pFrame[0] = SIMCTL_SYNC;
+      pFrame[1] = nLength;
+      for (uint8_t i = 0; i < nLength; i++) {
+        pFrame[2 + i] = pPayload[i];
+        usCrc = crc16 (usCrc, pPayload[i]);
+      }
+      pFrame[2 + nLength] = (uint8_t)usCrc;
+      pFrame[3 + nLength] = (uint8_t)(usCrc >> 8);
+      return nLength + 4;
+    }
+
+    // CRC-16/CCITT a bit at a time, a table would take 512 bytes of flash for frames of a
+    // few bytes.
+    static uint16_t crc16 (uint16_t usCrc, uint8_t c) {
+      usCrc ^= (uint16_t)c << 8;
+      for (uint8_t i = 0; i < 8; i++) {
+        usCrc = (usCrc & 0x8000) ? (uint16_t)((usCrc << 1) ^ 0x1021) : (uint16_t)(usCrc << 1);
+      }
+      return usCrc;
+    }
+
+  private:
+    enum { StateSync = 0, StateLength, StatePayload, StateCrcLow, StateCrcHigh };
+
+    void badFrame (void) {
+      uchState = StateSync;
+      iFrame = SIMCTL_BAD_FRAME;
+      usErrors++;
+    }
+
+    uint8_t   auchPayload[SIMCTL_PAYLOAD_MAX];
+    uint8_t   uchState;
+    uint8_t   uchLength;        // length of the payload of the frame being received
+    uint8_t   nReceived;        // bytes of the payload received so far
+    uint8_t   uchCrcLow;
+    uint16_t  usCrc;            // CRC of the frame so far
+    int8_t    iFrame;           // length of the frame received, SIMCTL_BAD_FRAME, or SIMCTL_NO_FRAME
+    uint16_t  usFrames;
+    uint16_t  usErrors;
+};
+
+#endif    // !defined(SIMCONTROL_H_INCLUDED)
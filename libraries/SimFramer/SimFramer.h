@@ -0,0 +1,115 @@
+/*
+ * Fixed size ring buffer which collects serial command messages.
+ *
+ * The simulators receive commands from the point of sale terminal as a series of
+ * characters followed by a terminator character. The terminator may be a carriage
+ * return, a line feed, both, or an ETX (0x03) character.
+ *
+ * Using an Arduino String and adding each character as it is received allocates
+ * memory from the heap for each character, which fragments the small 2 KB of SRAM
+ * of the Uno, and a noisy serial line with no terminator can use up all of memory.
+ *
+ * The SimFramer instead uses a static ring buffer whose size is fixed by the template
+ * argument. All of the characters available from the serial port are moved into the
+ * ring buffer by poll() and each complete command is then taken with getFrame().
+ * If a command is too long to fit into the ring buffer then the command is thrown away
+ * up to the next terminator and the overflow count is incremented.
+ *
+ * poll() takes everything which is available, which may be all 64 bytes of the receive
+ * buffer of the Serial port. When the terminal pipelines more short commands than fit into
+ * the ring buffer, take each command as soon as its terminator is put into the ring buffer:
+ *
+ *     while (Serial.available () > 0) {
+ *       cmdFramer.putByte ((uint8_t)Serial.read ());
+ *       if (cmdFramer.getFrame (cmdBuffer, sizeof(cmdBuffer)) >= 0) handle_command (cmdBuffer);
+ *     }
+ *
+ * Usage:
+ *     SimFramer<32>  cmdFramer;
+ *
+ *     cmdFramer.poll (Serial);
+ *     while (cmdFramer.getFrame (cmdBuffer, sizeof(cmdBuffer)) >= 0) handle_command (cmdBuffer);
+ */
+
+#if !defined(SIMFRAMER_H_INCLUDED)
+#define SIMFRAMER_H_INCLUDED
+
+#include <stdint.h>
+
+template <uint8_t N>     // size of the ring buffer, must be a power of 2 no larger than 128
+class SimFramer {
+  public:
+    SimFramer () : head(0), tail(0), start(0), nFrames(0), bDiscard(false), usFrames(0), usOverflows(0) {}
+
+    // move all of the characters which are available from a serial port, such
+    // as Serial, into the ring buffer. returns the number of complete frames.
+    template <class S> uint8_t poll (S &port) {
+      while (port.available () > 0) {
+        putByte ((uint8_t)port.read ());
+      }
+      return nFrames;
+    }
+
+    // add a single character to the ring buffer.
+    void putByte (uint8_t c) {
+      if (c == '\n' || c == '\r' || c == 0x03) {    // newline, carriage return, both, or custom character
+        if (bDiscard) {
+          // end of a command which overflowed, start again with the next character.
+          bDiscard = false;
+        } else if (head != start) {
+          // end of a command. mark the end with a zero so getFrame() knows where it ends.
+          // an empty command, such as the line feed of a carriage return line feed pair, is ignored.
+          ring[head++ & (N - 1)] = 0;
+          nFrames++;
+          usFrames++;
+        }
+        start = head;
+        return;
+      }
+
+      if (c == 0 || bDiscard) return;
+
+      // always leave room for the zero which marks the end of a command.
+      if ((uint8_t)(head - tail) >= N - 1) {
+        usOverflows++;
+        head = start;           // throw away the part of the command received so far
+        bDiscard = true;        // and the rest of it up to the next terminator.
+        return;
+      }
+
+      ring[head++ & (N - 1)] = c;
+    }
+
+    // copy the next complete command into pBuff as a zero terminated string. a command
+    // longer than nSize - 1 is truncated. returns the length of the command copied or -1
+    // if there is no complete command.
+    int getFrame (char *pBuff, uint8_t nSize) {
+      uint8_t  nLength = 0;
+      uint8_t  c;
+
+      if (nFrames == 0) return -1;
+
+      while ((c = ring[tail++ & (N - 1)]) != 0) {
+        if (nLength < nSize - 1) pBuff[nLength++] = c;
+      }
+      pBuff[nLength] = 0;
+      nFrames--;
+      return nLength;
+    }
+
+    uint8_t  framesReady (void) const { return nFrames; }
+    uint16_t frameCount (void) const { return usFrames; }         // number of commands received
+    uint16_t overflowCount (void) const { return usOverflows; }   // number of commands thrown away
+
+  private:
+    uint8_t  ring[N];
+    uint8_t  head;          // where the next character goes, counts up and wraps at 256
+    uint8_t  tail;          // where the next command to take begins
+    uint8_t  start;         // where the command being received begins
+    uint8_t  nFrames;       // number of complete commands in the ring buffer
+    bool     bDiscard;      // throwing away characters until the next terminator
+    uint16_t usFrames;
+    uint16_t usOverflows;
+};
+
+#endif    // !defined(SIMFRAMER_H_INCLUDED)
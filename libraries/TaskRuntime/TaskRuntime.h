@@ -0,0 +1,176 @@
+/*
+ * Cooperative task runtime for the sketches.
+ *
+ * A sketch is made of tasks, a function for each part of its work such as polling the
+ * Serial port, scanning a keypad, or starting a reading of a sensor, which are listed
+ * with their periods in a static table. loop() calls run() which runs each task that is
+ * due once and returns. The tasks must not wait, they do a little work and return, so
+ * the tasks of one sketch can be put together with the tasks of another in one table
+ * and one loop().
+ *
+ * Each task has
+ *   - a period in milliseconds, the task is run once each period, or 0 to run it on each
+ *     call of run() for work such as polling a port
+ *   - a deadline in microseconds, how late the task may start, measured from the time it
+ *     was due, or for a task with a period of 0 from the time it was last run, which is
+ *     the longest time a request for the task can wait. 0 for no deadline
+ * The times are measured with micros() so periods must be less than about 35 minutes and
+ * the counts should be reported and cleared more often than every 70 minutes.
+ * A task which is late is run once and its next time is a period after its last time so
+ * that the average period is kept, unless it is more than a period late in which case its
+ * next time is a period from now so that it is not run several times in a row.
+ *
+ * For each task the runtime counts the runs, the time spent in the task, the longest run,
+ * the latest start, and the deadlines missed. report() writes a line for each task with
+ * the counts and the share of the time since the counts were last cleared spent in the
+ * task, its CPU utilization, along with a line for the time spent outside of the tasks.
+ *
+ * Usage:
+ *     Task  tasks[] = {
+ *       // name      function         period msec   deadline usec
+ *       { "serial",  taskSerial,      0,            2000 },
+ *       { "sensor",  taskSensor,      2000,         0 }
+ *     };
+ *
+ *     TaskRuntime  taskRuntime (tasks, sizeof(tasks) / sizeof(tasks[0]));
+ *
+ *     taskRuntime.run ();              // in loop()
+ *     taskRuntime.report (Serial);     // from a command of the sketch
+ */
+
+#if !defined(TASKRUNTIME_H_INCLUDED)
+#define TASKRUNTIME_H_INCLUDED
+
+#include <stdint.h>
+#include <stdio.h>
+
+struct Task {
+  const char     *pszName;
+  void          (*pRun) (void);
+  uint16_t        usPeriodMsec;     // run the task every usPeriodMsec, 0 to run it on every call of run()
+  unsigned long   ulDeadlineUsec;   // how late the task may start, 0 for no deadline
+
+  // kept by the runtime, left out of the initializer of the table so they start at 0.
+  unsigned long   ulLastUsec;       // micros() the task was last due, or last run for a period of 0
+  unsigned long   ulRuns;           // number of times the task was run
+  unsigned long   ulBusyUsec;       // time spent in the task
+  unsigned long   ulMaxUsec;        // longest run of the task
+  unsigned long   ulLateUsec;       // latest start of the task
+  unsigned long   ulMisses;         // number of starts later than the deadline
+};
+
+class TaskRuntime {
+  public:
+    TaskRuntime (Task *aTasksInit, uint8_t nTasksInit) : aTasks(aTasksInit), nTasks(nTasksInit), ulStartUsec(0), bStarted(false) {}
+
+    // run each task which is due once. micros() is read once and then once after each
+    // task which is run, the end of one task being the start of the next.
+    void run (void) {
+      unsigned long  ulNow;
+
+      if (!bStarted) clear ();
+
+      ulNow = micros ();
+      for (uint8_t i = 0; i < nTasks; i++) {
+        Task           *pTask = aTasks + i;
+        unsigned long   ulLate = ulNow - pTask->ulLastUsec;
+
+        if (pTask->usPeriodMsec) {
+          unsigned long  ulPeriod = pTask->usPeriodMsec * 1000UL;
+
+          if (ulLate < ulPeriod) continue;
+          ulLate -= ulPeriod;
+          pTask->ulLastUsec = (ulLate < ulPeriod) ? pTask->ulLastUsec + ulPeriod : ulNow;
+        } else {
+          pTask->ulLastUsec = ulNow;
+        }
+
+        pTask->pRun ();
+
+        unsigned long  ulEnd = micros ();
+        unsigned long  ulUsed = ulEnd - ulNow;
+
+        pTask->ulRuns++;
+        if (ulStartUsec - ulNow <= ulUsed) {
+          pTask->ulBusyUsec += ulUsed - (ulStartUsec - ulNow);      // the task cleared the counts, count from then
+        } else {
+          pTask->ulBusyUsec += ulUsed;
+        }
+        if (ulUsed > pTask->ulMaxUsec) pTask->ulMaxUsec = ulUsed;
+        if (ulLate > pTask->ulLateUsec) pTask->ulLateUsec = ulLate;
+        if (pTask->ulDeadlineUsec && ulLate > pTask->ulDeadlineUsec) pTask->ulMisses++;
+        ulNow = ulEnd;
+      }
+    }
+
+    // clear the counts of the tasks and start measuring the utilization from now.
+    void clear (void) {
+      ulStartUsec = micros ();
+      for (uint8_t i = 0; i < nTasks; i++) {
+        Task  *pTask = aTasks + i;
+
+        if (!bStarted) pTask->ulLastUsec = ulStartUsec;
+        pTask->ulRuns = pTask->ulBusyUsec = pTask->ulMaxUsec = pTask->ulLateUsec = pTask->ulMisses = 0;
+      }
+      bStarted = true;
+    }
+
+    uint8_t taskCount (void) const { return nTasks; }
+    const Task &task (uint8_t i) const { return aTasks[i]; }
+
+    // the share of the time since the counts were cleared spent in a task, or outside of
+    // the tasks for nTasks, in tenths of a percent.
+    uint16_t utilization (uint8_t i) const {
+      return utilization (i, micros () - ulStartUsec);
+    }
+
+    // write a line for each task to a port, such as Serial, with the runs, the CPU
+    // utilization in percent, the longest run, the latest start, and the deadlines missed,
+    // the times in usec, and a last line for the time outside of the tasks. the counts are
+    // cleared if bClear is true so that each report covers the time since the last.
+    template <class S> void report (S &port, bool bClear = true) {
+      char           aszLine[72];
+      unsigned long  ulElapsed = micros () - ulStartUsec;
+
+      port.println ("task       runs   cpu%  max us  late us  miss");
+      for (uint8_t i = 0; i <= nTasks; i++) {
+        uint16_t  usCpu = utilization (i, ulElapsed);
+
+        if (i < nTasks) {
+          const Task  &t = aTasks[i];
+          snprintf (aszLine, sizeof(aszLine), "%-8.8s %6lu %4u.%u %7lu %8lu %5lu", t.pszName, t.ulRuns, usCpu / 10, usCpu % 10,
+              t.ulMaxUsec, t.ulLateUsec, t.ulMisses);
+        } else {
+          snprintf (aszLine, sizeof(aszLine), "%-8.8s %6s %4u.%u", "other", "", usCpu / 10, usCpu % 10);
+        }
+        port.println (aszLine);
+      }
+      if (bClear) clear ();
+    }
+
+  private:
+    uint16_t utilization (uint8_t i, unsigned long ulElapsed) const {
+      unsigned long  ulBusy = 0;
+
+      if (ulElapsed == 0) return 0;
+      if (i < nTasks) {
+        ulBusy = aTasks[i].ulBusyUsec;
+      } else {
+        for (uint8_t t = 0; t < nTasks; t++) ulBusy += aTasks[t].ulBusyUsec;
+        ulBusy = (ulBusy < ulElapsed) ? ulElapsed - ulBusy : 0;
+      }
+      // 32 bit arithmetic, a 64 bit division would pull a large library routine into the
+      // sketch. ulBusy * 1000 fits while ulElapsed is below about 4.29 seconds, after that
+      // ulElapsed is taken in msec.
+      if (ulBusy > ulElapsed) ulBusy = ulElapsed;
+      if (ulElapsed <= 0xffffffffUL / 1000) return (uint16_t)(ulBusy * 1000 / ulElapsed);
+      return (uint16_t)(ulBusy / (ulElapsed / 1000));
+    }
+
+    Task          *aTasks;
+    uint8_t        nTasks;
+    unsigned long  ulStartUsec;     // micros() the counts were cleared
+    bool           bStarted;
+};
+
+#endif    // !defined(TASKRUNTIME_H_INCLUDED)
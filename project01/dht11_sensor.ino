@@ -6,175 +6,152 @@
 
 #include <stdint.h>
 
+// the sensor is read by a Dht11Reader which timestamps the edges of the data pin
+// in a pin change interrupt so loop() is not held up while the sensor replies.
+// see dht11reader.h.
+#include "dht11reader.h"
+
 // uncomment the following define to enable a basic debug output which
 // will display the statistics for the reading from the DHT11 in order to
 // check if any pulses are being detected by the pin and what is the minimum
-// and maximum pulse width.
-// Testing with an Arduino Uno we have seen the following:
-//    minimum pulse width count -> 2
-//    maximum pulse widht count -> 15
-// With these statistics, threshold for function onewireReadDHT11() set
-// to 5 works great.
+// and maximum width of the high pulses of the bits.
+// The widths are in microseconds, about 26 to 28 for a binary zero and 70 for
+// a binary one, and a pulse as wide as the threshold, half way between the two,
+// or wider is taken as a one.
 //#define CHECK_STATS 1
 
-const int Dht11Pin = 12;       // digital pin on Arduino connected to DHT11 data pin
-const int Dht11Threshold = 5;  // onewireReadDHT11() threshold value
-
-// struct for DHT11 communications to allow access to various parameters
-// such as number of bytes read, minimum count and maximum count to
-// allow fine tuning of the function onewireReadDHT11() and setting the
-// threshold for a pulse width for a binary one versus a binary zero.
-typedef struct {
-  int  iByteCount;
-  int  iMinWait;
-  int  iMaxWait;
-} onewireStats;
+// readings are started by a task of the cooperative task runtime of the libraries
+// folder, see libraries/TaskRuntime, so the time between readings does not depend
+// on how fast loop() runs, and the
+// last readings are kept in fixed point tenths for a rolling minimum, maximum, and
+// average, see rollingstats.h.
+#include <TaskRuntime.h>
+#include "rollingstats.h"
 
+const int Dht11Pin = 12;              // digital pin on Arduino connected to DHT11 data pin
+const unsigned long Dht11Msec = 2000; // time between readings
+const int Dht11StatsCount = 8;        // number of readings in the rolling statistics
 
-int onewireResetWire (int iPin)
-{
-    pinMode (iPin, OUTPUT);
-    digitalWrite (iPin, LOW);
-    delay (18);
+static_assert (Dht11Msec >= 1000, "the DHT11 needs at least 1 second between readings");
 
-    digitalWrite (iPin, HIGH);
-    delayMicroseconds (40);
+Dht11Reader  dht11Reader;
 
-    pinMode (iPin, INPUT);
-    int iSlaveResponse = digitalRead (iPin);
-    delayMicroseconds (410);
+RollingStats<Dht11StatsCount>  humidityStats;       // humidity in tenths of a percent
+RollingStats<Dht11StatsCount>  temperatureStats;    // temperature in tenths of a degree C
+unsigned int  uiBadReadings = 0;                    // count of readings with bad data
 
-    return iSlaveResponse;
+// pin change interrupt of pins 8 to 13, port B, which includes the DHT11 data pin.
+ISR(PCINT0_vect)
+{
+  dht11Reader.edge ();
 }
 
-void  onewireSetup (int iPin)
+int GoodCheckSumDht11 (const unsigned char dht11[])
 {
-    pinMode (iPin, INPUT_PULLUP);
+  return (dht11[4] == ((dht11[0] + dht11[1] + dht11[2] + dht11[3]) & 0xff));
 }
 
-//   DHT11 sensor specific One Wire Protocol functions follow
+// the value of a pair of DHT11 bytes, the integer part and the decimal part, in tenths.
+int16_t Dht11Tenths (uint8_t uchInt, uint8_t uchDec)
+{
+  return (int16_t)(uchInt * 10 + (uchDec < 10 ? uchDec : 9));
+}
 
-onewireStats onewireReadDHT11 (int iPin, int iThreshold, unsigned char bitArray[], int iLen)
+// append a value in tenths to a CSV record as a comma and the value with one decimal.
+int PutTenths (char *pBuff, size_t nSize, int16_t sTenths)
 {
-    onewireStats  myStats = {0};
-    uint8_t laststate = HIGH;
-    uint8_t counter = 0;
-
-    memset (bitArray, 0, iLen);
-
-    //pull pin down to send start signal
-    pinMode( iPin, OUTPUT );
-    digitalWrite( iPin, LOW );
-    delay( 18 );
-
-    //pull pin up and wait for sensor response
-    digitalWrite( iPin, HIGH );
-    delayMicroseconds( 40 );
-    //prepare to read the pin
-    pinMode( iPin, INPUT );
-
-    int iCountMax = 0;
-    int iCountMin = 100;
-
-    //detect change and read data
-    uint8_t j = 0, i = 0;
-    do {
-        counter = 0;
-        while ( digitalRead( iPin ) == laststate )
-        {
-            counter++;
-            delayMicroseconds( 1 );
-            if ( counter == 255 )
-            {
-                break;
-            }
-        }
-        laststate = digitalRead( iPin );
-
-        if ( counter == 255 )
-            break;
-
-        //ignore first 3 transitions
-        if ( (i >= 4) && (i % 2 == 0) )
-        {
-            int iIndex = j >> 3;
-
-            if (iIndex >= iLen) break;
-
-            //shove each bit into the storage bytes
-            bitArray[iIndex] <<= 1;
-            if ( counter > iThreshold )
-                bitArray[iIndex] |= 1;
-            if (counter > iCountMax) iCountMax = counter;
-            if (counter < iCountMin) iCountMin = counter;
-            j++;
-        }
-        i++;
-    } while (1);
-
-    myStats.iByteCount = j;
-    myStats.iMinWait = iCountMin;
-    myStats.iMaxWait = iCountMax;
-    return myStats;
+  const char  *pszSign = (sTenths < 0) ? "-" : "";
+  int          iAbs = (sTenths < 0) ? -sTenths : sTenths;
+
+  return snprintf (pBuff, nSize, ",%s%d.%d", pszSign, iAbs / 10, iAbs % 10);
 }
 
-int GoodCheckSumDht11 (unsigned char dht11[])
+// the readings are written as CSV records, one line for each reading, with the
+// header line below. a reading with bad data is written as a line beginning with #
+// so that a program reading the CSV records can skip it.
+#define CSV_HEADER  "msec,humidity,temperature,humidity_min,humidity_max,humidity_avg,temperature_min,temperature_max,temperature_avg,bad"
+
+void WriteReading (int16_t sHumidity, int16_t sTemperature)
 {
-  return (dht11[4] == (dht11[0] + dht11[1] + dht11[2] + dht11[3]) & 0xff);
+  char  aszRecord[96];
+  int   nLength = snprintf (aszRecord, sizeof(aszRecord), "%lu", millis ());
+  int16_t  asValues[] = {
+      sHumidity, sTemperature,
+      humidityStats.minimum (), humidityStats.maximum (), humidityStats.average (),
+      temperatureStats.minimum (), temperatureStats.maximum (), temperatureStats.average ()
+  };
+
+  for (unsigned i = 0; i < sizeof(asValues) / sizeof(asValues[0]); i++) {
+    nLength += PutTenths (aszRecord + nLength, sizeof(aszRecord) - nLength, asValues[i]);
+  }
+  snprintf (aszRecord + nLength, sizeof(aszRecord) - nLength, ",%u", uiBadReadings);
+  Serial.println (aszRecord);
 }
 
-void setup() {
-  // put your setup code here, to run once:
-  Serial.begin(9600);
+void WriteStats (const char *pszWhat, const Dht11Stats &myStats)
+{
+  char  aszRecord[96];
 
-  Serial.println ("dht11_sensor: begin.");
-  
-  onewireSetup (12);
+  snprintf (aszRecord, sizeof(aszRecord), "# %lu %s bits %u edges %u glitches %u min %u max %u threshold %u",
+      millis (), pszWhat, myStats.nBits, myStats.nEdges, myStats.nGlitches, myStats.usMinHigh, myStats.usMaxHigh,
+      myStats.usThreshold);
+  Serial.println (aszRecord);
 }
 
-void loop() {
-  static  int  iLoopCount = 0;  // count loops in order to slow down pinging of DHT11
-  
-  // put your main code here, to run repeatedly:
-  unsigned char  dht11_dat[8];
+// the tasks of the sketch. a reading is started every Dht11Msec and the reader
+// is polled on every pass of loop() to finish the reading.
+void TaskStartReading (void)
+{
+  dht11Reader.start ();
+}
 
-  iLoopCount++;
+void TaskPollReading (void)
+{
+  Dht11Status  status = dht11Reader.poll ();
 
-  if (iLoopCount % 100000 == 0) {
-    onewireStats  myStats = {0};
-    
-    myStats = onewireReadDHT11 (Dht11Pin, Dht11Threshold, dht11_dat, 8);
+  if (status == Dht11Ready || status == Dht11Error) {
+    const uint8_t     *dht11_dat = dht11Reader.data ();
+    const Dht11Stats  &myStats = dht11Reader.lastStats ();
 
 #if defined(CHECK_STATS)
-    Serial.print (" - stats iByteCount = ");
-    Serial.print (myStats.iByteCount);
-    Serial.print ("  iMinWait ");
-    Serial.print (myStats.iMinWait);
-    Serial.print (", iMaxWait ");
-    Serial.println (myStats.iMaxWait);
+    WriteStats ("stats", myStats);
 #endif
 
-    if (myStats.iByteCount >= 40 && GoodCheckSumDht11 (dht11_dat)) {
-      float f = dht11_dat[2] * 9.0 / 5.0 + 32.0;  // convert temp to fahnrenheit
-      
-      Serial.print ("Humidity read ");
-      Serial.print (dht11_dat[0]);
-      Serial.print (".");
-      Serial.print (dht11_dat[1]);
-      Serial.print ("%  Temp read ");
-      Serial.print (dht11_dat[2]);
-      Serial.print (".");
-      Serial.print (dht11_dat[3]);
-      Serial.print ("C (");
-      Serial.print (f);
-      Serial.println ("F)");
+    if (status == Dht11Ready && GoodCheckSumDht11 (dht11_dat)) {
+      int16_t  sHumidity = Dht11Tenths (dht11_dat[0], dht11_dat[1]);
+      int16_t  sTemperature = Dht11Tenths (dht11_dat[2], dht11_dat[3]);
+
+      humidityStats.add (sHumidity);
+      temperatureStats.add (sTemperature);
+      WriteReading (sHumidity, sTemperature);
     } else {
-      Serial.print ("bad data  bytecount = ");
-      Serial.print (myStats.iByteCount);
-      Serial.print (", min = ");
-      Serial.print (myStats.iMinWait);
-      Serial.print (", max = ");
-      Serial.println (myStats.iMaxWait);
+      uiBadReadings++;
+      WriteStats ("bad data", myStats);
     }
   }
-}
+}
+
+// the reply of the sensor is collected by the interrupt service routine so the
+// poll task has no deadline.
+Task  tasks[] = {
+  // name      function            period msec   deadline usec
+  { "start",   TaskStartReading,   Dht11Msec,    0 },
+  { "poll",    TaskPollReading,    0,            0 }
+};
+
+TaskRuntime  taskRuntime (tasks, sizeof(tasks) / sizeof(tasks[0]));
+
+void setup() {
+  // put your setup code here, to run once:
+  Serial.begin(9600);
+
+  Serial.println ("# dht11_sensor: begin.");
+  Serial.println (CSV_HEADER);
+  
+  dht11Reader.begin (Dht11Pin);
+}
+
+void loop() {
+  // put your main code here, to run repeatedly:
+  taskRuntime.run ();
+}
@@ -0,0 +1,221 @@
+/*
+ * Interrupt driven reader of a DHT11 temperature and humidity sensor.
+ *
+ * The DHT11 sends each of its 40 bits as a low pulse of about 50 usec followed by a high
+ * pulse whose width is the bit, 26 to 28 usec for a 0 and 70 usec for a 1. Rather than
+ * counting the passes of a digitalRead() loop to time the pulses, which takes all of the
+ * CPU for the whole reading and gives counts which depend on the speed of digitalRead()
+ * and the clock, the reader timestamps each change of the data pin with micros() in a
+ * pin change interrupt and decodes the timestamps once the sensor is done. The widths
+ * are then in usec whatever the clock speed so the threshold between a 0 and a 1 does
+ * not need to be tuned.
+ *
+ * A pulse narrower than DHT11_GLITCH_USEC is noise on the wire rather than part of the
+ * reply and is removed before decoding. The threshold between a 0 and a 1 is then set
+ * half way between the narrowest and the widest high pulse of the bits so that a sensor
+ * whose pulses are shorter or longer than the datasheet is still read. If the widths are
+ * too close together for the reading to have both 0s and 1s then DHT11_ONE_USEC is used.
+ *
+ * A reading is a state machine which is advanced by poll() from loop():
+ *   - start() drives the data pin low for the start signal, 18 msec or more
+ *   - poll() then releases the pin, enables the pin change interrupt, and collects the
+ *     edges of the reply of the sensor, about 5 msec
+ *   - poll() then disables the interrupt, decodes the edges, and returns Dht11Ready or
+ *     Dht11Error
+ * so loop() can do other work while the start signal is held and the reply arrives.
+ *
+ * The sketch provides the interrupt service routine of the port of the data pin and
+ * calls edge() from it. For pins 8 to 13 of the Uno that is PCINT0_vect:
+ *     Dht11Reader  dht11Reader;
+ *
+ *     ISR(PCINT0_vect) { dht11Reader.edge (); }
+ *
+ *     dht11Reader.begin (12);                    // in setup()
+ *     dht11Reader.start ();                      // in loop(), no more than once a second
+ *     if (dht11Reader.poll () == Dht11Ready) ... dht11Reader.data () ...
+ */
+
+#if !defined(DHT11READER_H_INCLUDED)
+#define DHT11READER_H_INCLUDED
+
+#include <stdint.h>
+#include <string.h>
+
+#define DHT11_BITS          40      // bits of a reading, humidity, temperature, and checksum
+#define DHT11_EDGES_MAX     128     // edges kept of a reply, a reply has 85 and 2 more for each glitch
+#define DHT11_START_MSEC    20      // how long the start signal is held low
+#define DHT11_REPLY_MSEC    8       // how long the reply of the sensor is waited for
+#define DHT11_ONE_USEC      48      // a high pulse at least this wide is a 1, unless set from the widths
+#define DHT11_SPREAD_USEC   20      // the least difference of the widths of a 0 and a 1
+#define DHT11_GLITCH_USEC   6       // a pulse narrower than this is a glitch, micros() steps by 4 usec
+
+enum Dht11Status { Dht11Idle = 0, Dht11Busy, Dht11Ready, Dht11Error };
+
+// statistics of the last reading to check the pulses being detected by the pin.
+struct Dht11Stats {
+  uint8_t   nEdges;         // number of edges seen
+  uint8_t   nBits;          // number of bits decoded
+  uint16_t  usMinHigh;      // width of the narrowest high pulse of the bits, usec
+  uint16_t  usMaxHigh;      // width of the widest high pulse of the bits, usec
+  uint16_t  usThreshold;    // a high pulse at least this wide was taken as a 1, usec
+  uint8_t   nGlitches;      // number of glitches removed
+};
+
+class Dht11Reader {
+  public:
+    Dht11Reader () : uchPin(0), pInput(0), uchMask(0), uchState(StateIdle), ulStart(0), nEdges(0) {
+      memset (auchData, 0, sizeof(auchData));
+      memset (&stats, 0, sizeof(stats));
+    }
+
+    void begin (uint8_t pin) {
+      uchPin = pin;
+      pInput = portInputRegister (digitalPinToPort (pin));
+      uchMask = digitalPinToBitMask (pin);
+      pinMode (uchPin, INPUT_PULLUP);
+    }
+
+    // start a reading. returns false if a reading is already under way.
+    bool start (void) {
+      if (uchState != StateIdle) return false;
+      pinMode (uchPin, OUTPUT);
+      digitalWrite (uchPin, LOW);
+      ulStart = millis ();
+      uchState = StateStart;
+      return true;
+    }
+
+    // advance the reading. returns Dht11Busy while a reading is under way, then once
+    // Dht11Ready or Dht11Error when it is done, and Dht11Idle otherwise.
+    Dht11Status poll (void) {
+      switch (uchState) {
+        case StateStart:
+          if (millis () - ulStart < DHT11_START_MSEC) return Dht11Busy;
+          nEdges = 0;
+          enableEdges (true);
+          pinMode (uchPin, INPUT_PULLUP);     // release the pin, the sensor replies in 20 to 40 usec
+          ulStart = millis ();
+          uchState = StateReply;
+          return Dht11Busy;
+        case StateReply:
+          if (nEdges < DHT11_EDGES_MAX && millis () - ulStart < DHT11_REPLY_MSEC) return Dht11Busy;
+          enableEdges (false);
+          uchState = StateIdle;
+          return decode () ? Dht11Ready : Dht11Error;
+        default:
+          return Dht11Idle;
+      }
+    }
+
+    bool busy (void) const { return uchState != StateIdle; }
+
+    // the 5 bytes of the last reading, humidity integer and decimal, temperature integer
+    // and decimal, and checksum.
+    const uint8_t *data (void) const { return auchData; }
+    const Dht11Stats &lastStats (void) const { return stats; }
+
+    // called from the pin change interrupt service routine. the level of the pin after
+    // the edge is kept in bit 0 of the timestamp, micros() counts in steps of 4 usec on
+    // a 16 MHz Uno so bit 0 of it is always 0.
+    void edge (void) {
+      uint16_t  usNow = (uint16_t)micros ();
+
+      if (nEdges < DHT11_EDGES_MAX) {
+        ausEdges[nEdges++] = (usNow & ~1u) | ((*pInput & uchMask) ? 1 : 0);
+      }
+    }
+
+  private:
+    enum { StateIdle = 0, StateStart, StateReply };
+
+    void enableEdges (bool bEnable) {
+      if (bEnable) {
+        *digitalPinToPCMSK (uchPin) |= _BV (digitalPinToPCMSKbit (uchPin));
+        PCIFR = _BV (digitalPinToPCICRbit (uchPin));      // forget an edge from before
+        *digitalPinToPCICR (uchPin) |= _BV (digitalPinToPCICRbit (uchPin));
+      } else {
+        *digitalPinToPCMSK (uchPin) &= ~_BV (digitalPinToPCMSKbit (uchPin));
+      }
+    }
+
+    // remove the glitches, the pairs of edges closer together than DHT11_GLITCH_USEC,
+    // so that the levels of the edges left still alternate.
+    void removeGlitches (void) {
+      uint8_t  nKept = 0;
+
+      stats.nGlitches = 0;
+      for (uint8_t i = 0; i < nEdges; i++) {
+        if (nKept && (uint16_t)(ausEdges[i] - ausEdges[nKept - 1]) < DHT11_GLITCH_USEC) {
+          nKept--;                      // drop the edge into the glitch and this edge out of it
+          stats.nGlitches++;
+          continue;
+        }
+        ausEdges[nKept++] = ausEdges[i];
+      }
+      nEdges = nKept;
+    }
+
+    // the width of a high pulse, a rising edge followed by a falling edge, ending with
+    // the edge i, or 0 if the edges are not a high pulse.
+    uint16_t highWidth (uint8_t i) const {
+      if (!(ausEdges[i - 1] & 1) || (ausEdges[i] & 1)) return 0;
+      return (uint16_t)(ausEdges[i] - ausEdges[i - 1]);
+    }
+
+    // decode the bits from the widths of the high pulses. the reply of the sensor
+    // starts with the first falling edge, the sensor pulling the pin low, followed by
+    // the 80 usec high pulse of the response, and the bits are the high pulses after
+    // that. a rising edge from the release of the pin by the start signal may come
+    // before the reply. a reply with more or fewer than DHT11_BITS pulses is an error
+    // rather than trusting the 8 bit checksum to catch bits missing or added.
+    bool decode (void) {
+      uint8_t  iFirst = 1;
+      uint8_t  nHigh = 0;
+      uint8_t  nBits = 0;
+
+      memset (auchData, 0, sizeof(auchData));
+      stats.nEdges = nEdges;
+      removeGlitches ();
+      stats.usMinHigh = 0xffff;
+      stats.usMaxHigh = 0;
+
+      while (iFirst < nEdges && (ausEdges[iFirst - 1] & 1)) iFirst++;      // the first falling edge
+      for (uint8_t i = iFirst; i < nEdges; i++) {
+        uint16_t  usWidth = highWidth (i);
+
+        if (usWidth == 0) continue;
+        if (nHigh++ == 0) {
+          iFirst = i + 1;               // the response, the bits start after it
+          continue;
+        }
+        if (usWidth < stats.usMinHigh) stats.usMinHigh = usWidth;
+        if (usWidth > stats.usMaxHigh) stats.usMaxHigh = usWidth;
+      }
+      stats.nBits = nHigh ? nHigh - 1 : 0;
+      stats.usThreshold = (stats.nBits && stats.usMaxHigh - stats.usMinHigh >= DHT11_SPREAD_USEC)
+          ? (stats.usMinHigh + stats.usMaxHigh + 1) / 2 : DHT11_ONE_USEC;
+      if (stats.nBits != DHT11_BITS) return false;
+
+      for (uint8_t i = iFirst; i < nEdges; i++) {
+        uint16_t  usWidth = highWidth (i);
+
+        if (usWidth == 0) continue;
+        auchData[nBits / 8] <<= 1;
+        if (usWidth >= stats.usThreshold) auchData[nBits / 8] |= 1;
+        nBits++;
+      }
+      return true;
+    }
+
+    uint8_t            uchPin;
+    volatile uint8_t  *pInput;          // input register of the port of the pin
+    uint8_t            uchMask;         // bit of the pin in the port
+    uint8_t            uchState;
+    unsigned long      ulStart;         // millis() at the start of the current state
+    volatile uint8_t   nEdges;
+    uint16_t           ausEdges[DHT11_EDGES_MAX];     // micros() of each edge, level in bit 0
+    uint8_t            auchData[DHT11_BITS / 8];
+    Dht11Stats         stats;
+};
+
+#endif    // !defined(DHT11READER_H_INCLUDED)
@@ -0,0 +1,221 @@
+/*
+ * Host simulation of the DHT11 sensor for the dht11_sensor sketch.
+ *
+ * The sketch is compiled for the host with the host shim, see hostshim/README.md, and
+ * this program plays the part of the sensor. For each reading it starts the reading of
+ * the Dht11Reader of the sketch, checks that the data pin is held low for the start
+ * signal, and then replays a timeline of edges on the pin with hostSetPin(), moving the
+ * clock of the shim to the time of each edge, so the pin change interrupt service
+ * routine of the sketch timestamps the edges as it would on an Arduino.
+ *
+ * The timelines are synthesized from random readings with a valid checksum for each of
+ * a list of cases: the widths of the datasheet, jitter, a sensor with shorter or longer
+ * pulses, glitches, and frames cut short. Each case checks that every reading which is
+ * accepted, decoded with a good checksum, is the reading sent, and that the readings
+ * expected to be read are read. The widths of the high pulses seen, the min and max of
+ * the statistics of the reader, and the threshold it set are shown for each case along
+ * with the time taken to decode a frame.
+ *
+ * A timeline recorded from a sensor, with a logic analyzer for instance, can be replayed
+ * with -r. The file has a line for each edge with the time of the edge in usec since the
+ * sensor was released and the level of the pin after the edge, 0 or 1.
+ *
+ *     dht11sim [frames]
+ *     dht11sim -r timeline.txt
+ *
+ * The program exits with 1 if any case fails. See README.md for how to build it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+#include "Arduino.h"
+#include "dht11reader.h"
+
+extern Dht11Reader  dht11Reader;
+
+static const uint8_t  Dht11Pin = 12;      // the data pin of the sketch
+
+void setup ();
+int GoodCheckSumDht11 (const unsigned char dht11[]);
+
+struct Edge {
+  unsigned long  ulUsec;      // time of the edge since the sensor was released
+  int            iLevel;      // level of the pin after the edge
+};
+
+// how a synthesized reply is timed and damaged.
+struct SimCase {
+  const char  *pszName;
+  int          iZeroUsec;       // width of the high pulse of a 0
+  int          iOneUsec;        // width of the high pulse of a 1
+  int          iJitterUsec;     // each pulse is made up to this much wider or narrower
+  int          iGlitchPct;      // percent of the bits with a glitch in the high pulse
+  int          iCutBits;        // the frame stops after this many bits, 0 for a whole frame
+  bool         bExpectRead;     // the readings are expected to be read
+};
+
+static const SimCase  simCases[] = {
+  { "datasheet", 27, 70, 0, 0, 0, true },
+  { "jitter 8 usec", 27, 70, 8, 0, 0, true },
+  { "short pulses", 19, 49, 3, 0, 0, true },
+  { "long pulses", 35, 91, 3, 0, 0, true },
+  { "glitches", 27, 70, 4, 10, 0, true },
+  { "cut at 39 bits", 27, 70, 4, 0, 39, false },
+  { "cut at 20 bits", 27, 70, 4, 0, 20, false },
+};
+
+static int jitter (int iUsec, int iJitterUsec)
+{
+  return iJitterUsec ? iUsec + (int)random (-iJitterUsec, iJitterUsec + 1) : iUsec;
+}
+
+// the reply of the sensor to the start signal for the 5 bytes of a reading.
+static void synthesize (const SimCase &simCase, const uint8_t auchData[5], std::vector<Edge> &edges)
+{
+  unsigned long  ulUsec = 0;
+  int            nBits = simCase.iCutBits ? simCase.iCutBits : DHT11_BITS;
+
+  edges.clear ();
+  ulUsec += jitter (30, 10);                          // the sensor pulls the pin low
+  edges.push_back ({ ulUsec, 0 });
+  ulUsec += jitter (80, simCase.iJitterUsec);
+  edges.push_back ({ ulUsec, 1 });
+  ulUsec += jitter (80, simCase.iJitterUsec);
+
+  for (int i = 0; i < nBits; i++) {
+    bool  bOne = (auchData[i / 8] >> (7 - i % 8)) & 1;
+    int   iHigh = jitter (bOne ? simCase.iOneUsec : simCase.iZeroUsec, simCase.iJitterUsec);
+
+    edges.push_back ({ ulUsec, 0 });                  // the low pulse before each bit
+    ulUsec += jitter (50, simCase.iJitterUsec);
+    edges.push_back ({ ulUsec, 1 });
+    if (random (100) < simCase.iGlitchPct) {          // a spike low of 1 to 3 usec at least 10 usec into the high pulse
+      unsigned long  ulGlitch = ulUsec + 10 + random (iHigh > 23 ? iHigh - 23 : 1);
+      edges.push_back ({ ulGlitch, 0 });
+      edges.push_back ({ ulGlitch + 1 + random (3), 1 });
+    }
+    ulUsec += iHigh;
+  }
+  edges.push_back ({ ulUsec, 0 });                    // the end of the frame
+  ulUsec += jitter (50, simCase.iJitterUsec);
+  edges.push_back ({ ulUsec, 1 });
+}
+
+static double  dDecodeSeconds = 0;
+
+// have the sketch read the sensor while the sensor replies with the edges. returns the
+// status of the reading.
+static Dht11Status replay (const std::vector<Edge> &edges)
+{
+  dht11Reader.start ();
+  if (hostGetPin (Dht11Pin) != LOW) {
+    printf ("the start signal did not pull the pin low\n");
+    exit (1);
+  }
+  delay (DHT11_START_MSEC);
+  dht11Reader.poll ();              // releases the pin
+
+  unsigned long  ulRelease = micros ();
+  for (size_t i = 0; i < edges.size (); i++) {
+    unsigned long  ulNow = micros () - ulRelease;
+    if (edges[i].ulUsec > ulNow) delayMicroseconds ((unsigned int)(edges[i].ulUsec - ulNow));
+    hostSetPin (Dht11Pin, edges[i].iLevel);
+  }
+  hostSetPin (Dht11Pin, HIGH);
+  delay (DHT11_REPLY_MSEC);
+
+  std::chrono::steady_clock::time_point  tStart = std::chrono::steady_clock::now();
+  Dht11Status  status = dht11Reader.poll ();      // decodes the edges
+  dDecodeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+  delay (1000);                     // the DHT11 needs a second between readings
+  return status;
+}
+
+static bool runCase (const SimCase &simCase, long lFrames)
+{
+  std::vector<Edge>  edges;
+  long      lRead = 0, lWrong = 0;
+  uint16_t  usMinHigh = 0xffff, usMaxHigh = 0, usMinThreshold = 0xffff, usMaxThreshold = 0;
+
+  dDecodeSeconds = 0;
+  for (long l = 0; l < lFrames; l++) {
+    uint8_t  auchData[5] = { (uint8_t)random (20, 95), 0, (uint8_t)random (0, 51), (uint8_t)random (0, 10), 0 };
+
+    auchData[4] = (uint8_t)(auchData[0] + auchData[1] + auchData[2] + auchData[3]);
+    synthesize (simCase, auchData, edges);
+
+    Dht11Status  status = replay (edges);
+    const Dht11Stats  &stats = dht11Reader.lastStats ();
+
+    if (status == Dht11Ready && GoodCheckSumDht11 (dht11Reader.data ())) {
+      lRead++;
+      if (memcmp (dht11Reader.data (), auchData, sizeof(auchData)) != 0) lWrong++;
+    }
+    if (stats.nBits) {
+      if (stats.usMinHigh < usMinHigh) usMinHigh = stats.usMinHigh;
+      if (stats.usMaxHigh > usMaxHigh) usMaxHigh = stats.usMaxHigh;
+      if (stats.usThreshold < usMinThreshold) usMinThreshold = stats.usThreshold;
+      if (stats.usThreshold > usMaxThreshold) usMaxThreshold = stats.usThreshold;
+    }
+  }
+
+  // every reading is expected to be read, or none from frames which were cut short.
+  bool  bPass = lWrong == 0 && lRead == (simCase.bExpectRead ? lFrames : 0);
+
+  printf ("%-16s %s  read %ld of %ld, wrong %ld, high %u to %u usec, threshold %u to %u usec, decode %.0f ns\n",
+      simCase.pszName, bPass ? "pass" : "FAIL", lRead, lFrames, lWrong, usMinHigh, usMaxHigh,
+      usMinThreshold, usMaxThreshold, dDecodeSeconds * 1e9 / lFrames);
+  return bPass;
+}
+
+static int replayFile (const char *pszFile)
+{
+  FILE  *pFile = fopen (pszFile, "r");
+  std::vector<Edge>  edges;
+  Edge   edge;
+
+  if (!pFile) {
+    perror (pszFile);
+    return 2;
+  }
+  while (fscanf (pFile, "%lu %d", &edge.ulUsec, &edge.iLevel) == 2) edges.push_back (edge);
+  fclose (pFile);
+
+  Dht11Status  status = replay (edges);
+  const uint8_t     *pData = dht11Reader.data ();
+  const Dht11Stats  &stats = dht11Reader.lastStats ();
+
+  printf ("%u edges, %u glitches, %u bits, high %u to %u usec, threshold %u usec\n", stats.nEdges, stats.nGlitches,
+      stats.nBits, stats.usMinHigh, stats.usMaxHigh, stats.usThreshold);
+  printf ("data %02x %02x %02x %02x %02x, %s\n", pData[0], pData[1], pData[2], pData[3], pData[4],
+      (status == Dht11Ready && GoodCheckSumDht11 (pData)) ? "good" : "bad");
+  return (status == Dht11Ready && GoodCheckSumDht11 (pData)) ? 0 : 1;
+}
+
+int main (int argc, char *argv[])
+{
+  hostClockManual (true);
+  setup ();
+
+  if (argc > 2 && strcmp (argv[1], "-r") == 0) return replayFile (argv[2]);
+
+  long  lFrames = (argc > 1) ? atol (argv[1]) : 10000;
+  int   nFails = 0;
+
+  if (lFrames < 1) {
+    fprintf (stderr, "usage: dht11sim [frames] | -r timeline.txt\n");
+    return 2;
+  }
+
+  randomSeed (1);
+  for (size_t i = 0; i < sizeof(simCases) / sizeof(simCases[0]); i++) {
+    if (!runCase (simCases[i], lFrames)) nFails++;
+  }
+  return nFails ? 1 : 0;
+}
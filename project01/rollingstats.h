@@ -0,0 +1,64 @@
+/*
+ * Rolling minimum, maximum, and average of the last readings of a sensor.
+ *
+ * The readings are fixed point integers, such as tenths of a degree, so that no floating
+ * point arithmetic is needed on the Arduino. The last N readings are kept in a ring and
+ * the sum of them is kept as readings are added and dropped so the average costs a
+ * division, rounded to the nearest, and the minimum and maximum a pass over N readings.
+ *
+ * Usage:
+ *     RollingStats<8>  tempStats;      // the last 8 readings
+ *
+ *     tempStats.add (iTenths);
+ *     tempStats.minimum (), tempStats.maximum (), tempStats.average ()
+ */
+
+#if !defined(ROLLINGSTATS_H_INCLUDED)
+#define ROLLINGSTATS_H_INCLUDED
+
+#include <stdint.h>
+
+template <uint8_t N>     // number of readings kept
+class RollingStats {
+  public:
+    RollingStats () : nCount(0), iNext(0), lSum(0) {}
+
+    void add (int16_t sValue) {
+      if (nCount < N) {
+        nCount++;
+      } else {
+        lSum -= asValues[iNext];      // drop the oldest reading
+      }
+      asValues[iNext] = sValue;
+      lSum += sValue;
+      iNext = (iNext + 1) % N;
+    }
+
+    uint8_t count (void) const { return nCount; }
+
+    int16_t minimum (void) const {
+      int16_t  sMin = nCount ? asValues[0] : 0;
+      for (uint8_t i = 1; i < nCount; i++) if (asValues[i] < sMin) sMin = asValues[i];
+      return sMin;
+    }
+
+    int16_t maximum (void) const {
+      int16_t  sMax = nCount ? asValues[0] : 0;
+      for (uint8_t i = 1; i < nCount; i++) if (asValues[i] > sMax) sMax = asValues[i];
+      return sMax;
+    }
+
+    int16_t average (void) const {
+      if (nCount == 0) return 0;
+      long  lHalf = (lSum < 0) ? -(long)(nCount / 2) : (long)(nCount / 2);
+      return (int16_t)((lSum + lHalf) / nCount);
+    }
+
+  private:
+    int16_t  asValues[N];
+    uint8_t  nCount;        // number of readings kept, up to N
+    uint8_t  iNext;         // where the next reading goes
+    long     lSum;          // sum of the readings kept
+};
+
+#endif    // !defined(ROLLINGSTATS_H_INCLUDED)
@@ -0,0 +1,460 @@
+/*
+ * Host driver for the scale simulator.
+ *
+ * This program drives the scale simulator on a host such as Linux with
+ * synthetic W, S, and Z requests and reports the number of requests per
+ * second handled. There are four parts:
+ *   - sprintf formats each response with sprintf() and the run time table
+ *             of format strings the way the sketch originally did
+ *   - policy  calls buildResponse() of scalecore.cpp which formats each
+ *             response with the compile time SCP-01 or SCP-02 policy
+ *   - frame   calls getResponseFrame() of scalecore.cpp which returns the
+ *             ready-built response frame the way the sketch does now
+ *   - sketch  queues requests for Serial and calls the sketch loop() so the
+ *             command buffering of serialcommands.ino is included
+ *
+ * Before the benchmarks the policy responses and the LCD info line are checked
+ * against the sprintf ones for every specification, units, and status setting,
+ * and the SRAM the format tables took on the AVR is reported. The weight
+ * trajectories of scaletrajectory.cpp are checked too: the settling table
+ * against the curve it was computed from, and the weight and status bits of
+ * each trajectory at points along it, and the time of an update is measured.
+ *
+ * See README.md for how to build this program.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "Arduino.h"
+#include "scalecore.h"
+#include "scaletrajectory.h"
+#include "SimFramer.h"
+#include "EEPROM.h"
+#include "ConfigStore.h"
+#include "ConfigKeys.h"
+#include "Keypad.h"
+
+extern SimFramer<32>  cmdFramer;        // the command ring buffer of the sketch
+extern ConfigStore<EEPROMClass, 16>  config;     // the defaults kept by the sketch
+void loadScaleDefaults (void);
+
+void setup ();
+void loop ();
+
+static const char *requestList[] = { "W", "S", "Z", "W", "W", "S", "W", "Z" };
+static const int   nRequestList = sizeof(requestList) / sizeof(requestList[0]);
+
+static volatile unsigned char  uchSink;
+
+static double elapsedSeconds (std::chrono::steady_clock::time_point tStart)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+}
+
+// the response formats as they were before the SCP-01 and SCP-02 policy types of scalecore.h.
+// on the AVR these strings and the table of pointers to them were copied to SRAM at startup.
+struct SpecFormat {
+  const char *specWeight;
+  const char *specStatus;
+  short maxMsp;
+  short maxLsp;
+};
+
+static const SpecFormat specInUseFmt [] = {
+      //weight then units then status
+      { "\n%4.4d.%2.2d%s\r\n%c%c\r\x03", "\n%c%c\r\x03", 4, 2},    // SCP-01 specification for response
+      { "\n%2.2d.%3.3d%s\r\nS%c%c\r\x03", "\nS%c%c\r\x03", 2, 3 }  // SCP-02 specification for response
+};
+
+static const char * const lcdInfoFmt[] = {
+      // max of 16 characters for 16x2 LCD module
+      "%4.4d.%2.2d%-2.2s %2.2x %2.2x",    // SCP-01 specification for response
+      "%2.2d.%3.3d%-2.2s %2.2x %2.2x "    // SCP-02 specification for response
+};
+
+static int buildResponseSprintf (const char *inCommand, char *cBuff)
+{
+    switch (inCommand[0]) {
+      case 'W':    // weight command
+      case 'w':
+        return sprintf (cBuff, specInUseFmt[specInUse].specWeight, lb1, lb2, (iUnits == English) ? "LB" : "KG", s1, s2);
+      case 'S':    // status command
+      case 's':
+      case 'Z':    // zero scale command (zeros scale but response is same as status command)
+      case 'z':
+        return sprintf (cBuff, specInUseFmt[specInUse].specStatus, s1, s2);
+      default:     // unrecognized command
+        return sprintf (cBuff, "\n?\r\x03");
+    }
+}
+
+// SRAM the format tables took on the AVR, where a pointer and a short are 2 bytes.
+static int formatTableSram (void)
+{
+    int  nBytes = (int)(sizeof(specInUseFmt) / sizeof(specInUseFmt[0])) * 8 + (int)(sizeof(lcdInfoFmt) / sizeof(lcdInfoFmt[0])) * 2;
+
+    for (const SpecFormat &fmt : specInUseFmt) nBytes += (int)(strlen (fmt.specWeight) + strlen (fmt.specStatus) + 2);
+    for (const char *psz : lcdInfoFmt) nBytes += (int)strlen (psz) + 1;
+    return nBytes;
+}
+
+// compare the policy responses and LCD line with the sprintf ones for every setting.
+static bool checkPolicy (void)
+{
+    static const char *checkList[] = { "W", "S", "Z", "?" };
+    int   nChecked = 0, nWrong = 0;
+    int   lb1Save = lb1, lb2Save = lb2;
+    unsigned char  s1Save = s1, s2Save = s2;
+    ScaleUnits  iUnitsSave = iUnits;
+    SpecInUse  specSave = specInUse;
+
+    for (int spec = Scp_01; spec <= Scp_02; spec++) {
+      for (int units = English; units <= Metric; units++) {
+        for (int st = 0; st < 16; st++) {
+          for (int w = 0; w < 1000; w += 37) {
+            char  cPolicy[64], cSprintf[64];
+            int   nPolicy, nSprintf;
+
+            specInUse = (SpecInUse)spec;
+            iUnits = (ScaleUnits)units;
+            s1 = 0x30 | (st & 3);
+            s2 = 0x30 | (st >> 2);
+            lb1 = w * 7;
+            lb2 = w;
+            modWeightValues ();
+
+            for (const char *pRequest : checkList) {
+              nPolicy = buildResponse (pRequest, cPolicy);
+              nSprintf = buildResponseSprintf (pRequest, cSprintf);
+              nChecked++;
+              if (nPolicy != nSprintf || memcmp (cPolicy, cSprintf, nPolicy) != 0) nWrong++;
+            }
+
+            nPolicy = buildLcdInfo (cPolicy);
+            nSprintf = sprintf (cSprintf, lcdInfoFmt[specInUse], lb1, lb2, (iUnits == English) ? "LB" : "KG", s1, s2);
+            nChecked++;
+            if (nPolicy != nSprintf || memcmp (cPolicy, cSprintf, nPolicy) != 0) nWrong++;
+          }
+        }
+      }
+    }
+
+    lb1 = lb1Save;  lb2 = lb2Save;  s1 = s1Save;  s2 = s2Save;
+    iUnits = iUnitsSave;  specInUse = specSave;
+    scaleDataChanged ();
+
+    printf ("check:   %d responses and LCD lines compared with sprintf, %d different\n", nChecked, nWrong);
+    printf ("sram:    the format tables used %d bytes of SRAM, the policy types use none\n", formatTableSram ());
+    return nWrong == 0;
+}
+
+// a point along a trajectory, started at time 0 with an empty scale, and what the weight
+// and the status bits are expected to be there.
+struct TrajPoint {
+  unsigned char  uchTrajectory;
+  unsigned long  ulMsec;
+  long           lMin, lMax;        // weight before it is limited to 0 to SCALE_CAPACITY, thousandths
+  unsigned char  uchS1, uchS2;      // bits 0 and 1 of the status bytes
+};
+
+static const TrajPoint  trajPoints[] = {
+  { 1, 1900,  -2, 2, 2, 0 },            // empty and stable
+  { 1, 2500,  1000, 3100, 1, 0 },       // placed, settling
+  { 1, 5900,  2497, 2503, 0, 0 },       // settled
+  { 1, 6100,  -400, 1000, 1, 0 },       // removed, settling
+  { 1, 9900,  -2, 2, 2, 0 },            // empty again as the trajectory repeats
+  { 2, 6000,  12005, 12015, 0xff, 0 },  // creeping, 3 thousandths a second after it has settled
+  { 2, 10900, 12018, 12030, 0xff, 0 },
+  { 3, 3500,  34990, 35010, 0, 2 },     // over capacity
+  { 4, 3000,  1240, 1260, 0xff, 0 },    // noisy, the motion bit comes and goes
+  { 4, 8000,  -203, -197, 0, 1 },       // under capacity
+  { 4, 10900, -2, 2, 2, 0 },            // zeroed
+};
+
+// the settling table against exp(-8x) cos(5 pi x) (1 - x), and the trajectories at the
+// points of trajPoints[] with the weight stepped every 10 msec as the sketch does.
+static bool checkTrajectory (void)
+{
+    int   nWrong = 0, iMaxDiff = 0;
+    int   lb1Save = lb1, lb2Save = lb2;
+    unsigned char  s1Save = s1, s2Save = s2;
+    SpecInUse  specSave = specInUse;
+
+    for (int i = 0; i <= SCALE_SETTLE_SAMPLES; i++) {
+        double  x = (double)i / SCALE_SETTLE_SAMPLES;
+        int     iDiff = abs (scaleSettleSample (i) - (int)lround (16384 * exp (-8 * x) * cos (5 * M_PI * x) * (1 - x)));
+
+        if (iDiff > iMaxDiff) iMaxDiff = iDiff;
+    }
+    if (iMaxDiff > 1) nWrong++;
+
+    for (const TrajPoint &point : trajPoints) {
+        specInUse = Scp_02;
+        lb1 = lb2 = 0;
+        scaleTrajectoryStart (point.uchTrajectory, 0);
+        for (unsigned long ulMsec = 10; ulMsec <= point.ulMsec; ulMsec += 10) scaleTrajectoryUpdate (ulMsec);
+
+        long  lWeight = scaleTrajectoryWeight ();
+        bool  bGood = lWeight >= point.lMin && lWeight <= point.lMax && (s2 & 3) == point.uchS2
+            && (point.uchS1 == 0xff ? (s1 & 2) == 0 : (s1 & 3) == point.uchS1);
+
+        if (!bGood) {
+            printf ("trajectory %u at %lu msec: weight %ld, %02x %02x\n", point.uchTrajectory, point.ulMsec, lWeight, s1, s2);
+            nWrong++;
+        }
+    }
+    scaleTrajectoryStart (0, 0);
+
+    lb1 = lb1Save;  lb2 = lb2Save;  s1 = s1Save;  s2 = s2Save;
+    specInUse = specSave;
+    scaleDataChanged ();
+
+    printf ("motion:  settling table within %d of the curve, %d trajectory points checked, %d wrong\n", iMaxDiff,
+        (int)(sizeof(trajPoints) / sizeof(trajPoints[0])), nWrong);
+    return nWrong == 0;
+}
+
+// a burst of requests pipelined by the terminal, as many as fill the 64 byte receive buffer
+// of the Serial port, each of which must be answered.
+static bool checkPipelined (void)
+{
+    const int  nBurst = 32;
+    int   nResponses = 0;
+    uint16_t  usOverflows = cmdFramer.overflowCount ();
+
+    hostSerialOutput.clear ();
+    for (int i = 0; i < nBurst; i++) hostSerialInput ("W\r", 2);
+    while (Serial.available ()) loop ();
+
+    for (char c : hostSerialOutput) {
+        if (c == 0x03) nResponses++;
+    }
+    hostSerialOutput.clear ();
+
+    printf ("burst:   %d requests in one read, %d responses, %d overflows\n", nBurst, nResponses,
+        cmdFramer.overflowCount () - usOverflows);
+    return nResponses == nBurst && cmdFramer.overflowCount () == usOverflows;
+}
+
+static unsigned long eepromWrites (void)
+{
+    unsigned long  ulWrites = 0;
+
+    for (int i = 0; i < HOST_EEPROM_SIZE; i++) ulWrites += hostEepromWriteCount (i);
+    return ulWrites;
+}
+
+// run the sketch for ulMsec on the host clock, with a W request every ulRequestMsec if not 0.
+static void runSketch (unsigned long ulMsec, unsigned long ulRequestMsec)
+{
+    for (unsigned long t = 0; t < ulMsec; t += 5) {
+        if (ulRequestMsec && t % ulRequestMsec == 0) hostSerialInput ("W\r", 2);
+        loop ();
+        delay (5);
+    }
+    hostSerialOutput.clear ();
+}
+
+// a key which changes the defaults writes nothing to the EEPROM while the terminal is
+// sending requests, and once it stops the defaults are saved with the status bits the
+// keypad set rather than those of a trajectory.
+static bool checkSaveDefaults (void)
+{
+    uint8_t  auchBefore[4], auchAfter[4];
+    int   nWrong = 0;
+
+    hostClockManual (true);
+    runSketch (3000, 0);        // anything left from setup() is saved
+    if (config.get (CONFIG_SCALE_DEFAULTS, auchBefore, sizeof(auchBefore)) != sizeof(auchBefore)) {
+        auchBefore[0] = (uint8_t)iUnits;     // nothing saved yet, the defaults of scalecore.cpp
+        auchBefore[2] = s1;
+        auchBefore[3] = s2;
+    }
+
+    unsigned long  ulWrites = eepromWrites ();
+    hostKeyPress ('C');
+    hostKeyPress ('2');         // trajectory 1, which sets the motion and zero bits
+    hostKeyPress ('#');         // change the units
+    runSketch (5000, 100);
+    unsigned long  ulBusy = eepromWrites () - ulWrites;
+    if (ulBusy != 0) nWrong++;
+
+    runSketch (3000, 0);
+    unsigned long  ulIdle = eepromWrites () - ulWrites;
+    if (config.get (CONFIG_SCALE_DEFAULTS, auchAfter, sizeof(auchAfter)) != sizeof(auchAfter) || auchAfter[0] != (uint8_t)iUnits
+        || auchAfter[0] == auchBefore[0] || (auchAfter[2] & 3) != (auchBefore[2] & 3) || (auchAfter[3] & 3) != (auchBefore[3] & 3)) {
+        nWrong++;
+    }
+
+    hostKeyPress ('*');         // stop the trajectory
+    hostKeyPress ('#');         // and change the units back
+    runSketch (3000, 0);
+    hostClockManual (false);
+
+    printf ("save:    %lu EEPROM writes while requests came in, %lu once idle, %d wrong\n", ulBusy, ulIdle, nWrong);
+    return nWrong == 0;
+}
+
+// defaults with a status byte which is not printable, as a record of another sketch could
+// have, leave the status bytes as they were, and good ones are loaded.
+static bool checkLoadDefaults (void)
+{
+    unsigned char  s1Save = s1, s2Save = s2;
+    uint8_t  auchSaved[4];
+    int   nSaved = config.get (CONFIG_SCALE_DEFAULTS, auchSaved, sizeof(auchSaved));
+    int   nWrong = 0;
+
+    uint8_t  auchBad[4] = { (uint8_t)iUnits, (uint8_t)specInUse, 0x03, 0x30 };
+    config.set (CONFIG_SCALE_DEFAULTS, auchBad, sizeof(auchBad));
+    s1 = 0x31;  s2 = 0x32;
+    loadScaleDefaults ();
+    if (s1 != 0x31 || s2 != 0x32) nWrong++;
+
+    uint8_t  auchGood[4] = { (uint8_t)iUnits, (uint8_t)specInUse, 0x32, 0x33 };
+    config.set (CONFIG_SCALE_DEFAULTS, auchGood, sizeof(auchGood));
+    loadScaleDefaults ();
+    if (s1 != 0x32 || s2 != 0x33) nWrong++;
+
+    config.set (CONFIG_SCALE_DEFAULTS, auchSaved, nSaved > 0 ? (uint8_t)nSaved : 0);
+    s1 = s1Save;  s2 = s2Save;
+    scaleDataChanged ();
+
+    printf ("load:    defaults with a status byte of 0x03 and good ones loaded, %d wrong\n", nWrong);
+    return nWrong == 0;
+}
+
+// an update of the trajectory a msec apart, with the response frames rebuilt when the
+// weight changes as they would be for the next request.
+static void benchTrajectory (long nUpdates)
+{
+    int     lb1Save = lb1, lb2Save = lb2;
+    unsigned char  s1Save = s1, s2Save = s2;
+    long    lChanged = 0;
+    auto    tStart = std::chrono::steady_clock::now();
+
+    scaleTrajectoryStart (1, 0);
+    for (long i = 1; i <= nUpdates; i++) {
+        int     nLength;
+
+        if (scaleTrajectoryUpdate ((unsigned long)i)) {
+            lChanged++;
+            uchSink ^= getResponseFrame ("W", &nLength)[1];
+        }
+    }
+
+    double  dSeconds = elapsedSeconds (tStart);
+
+    scaleTrajectoryStart (0, 0);
+    lb1 = lb1Save;  lb2 = lb2Save;  s1 = s1Save;  s2 = s2Save;
+    scaleDataChanged ();
+
+    printf ("motion:  %ld updates, %ld changed the weight, %.3f sec, %.1f nsec/update\n",
+        nUpdates, lChanged, dSeconds, dSeconds * 1e9 / nUpdates);
+}
+
+static void benchSprintf (long nRequests)
+{
+    char    cBuff[64];
+    long    lBytes = 0;
+    auto    tStart = std::chrono::steady_clock::now();
+
+    for (long i = 0; i < nRequests; i++) {
+        lBytes += buildResponseSprintf (requestList[i % nRequestList], cBuff);
+        uchSink ^= cBuff[0];
+    }
+
+    double  dSeconds = elapsedSeconds (tStart);
+    printf ("sprintf: %ld requests, %ld response bytes, %.3f sec, %.0f requests/sec, %.1f nsec/request\n",
+        nRequests, lBytes, dSeconds, nRequests / dSeconds, dSeconds * 1e9 / nRequests);
+}
+
+static void benchPolicy (long nRequests)
+{
+    char    cBuff[64];
+    long    lBytes = 0;
+    auto    tStart = std::chrono::steady_clock::now();
+
+    for (long i = 0; i < nRequests; i++) {
+        lBytes += buildResponse (requestList[i % nRequestList], cBuff);
+        uchSink ^= cBuff[0];
+    }
+
+    double  dSeconds = elapsedSeconds (tStart);
+    printf ("policy:  %ld requests, %ld response bytes, %.3f sec, %.0f requests/sec, %.1f nsec/request\n",
+        nRequests, lBytes, dSeconds, nRequests / dSeconds, dSeconds * 1e9 / nRequests);
+}
+
+static void benchFrame (long nRequests)
+{
+    long    lBytes = 0;
+    auto    tStart = std::chrono::steady_clock::now();
+
+    for (long i = 0; i < nRequests; i++) {
+        int     nLength;
+        const char *pFrame = getResponseFrame (requestList[i % nRequestList], &nLength);
+
+        lBytes += nLength;
+        uchSink ^= pFrame[nLength - 1];     // use the frame so it is not optimized away
+        // change the weight every 1000 requests as the keypad would, which is far more often than
+        // an operator could, so that the cost of rebuilding the frames is included.
+        if (i % 1000 == 999) {
+            lb2 = (lb2 + 1) % 1000;
+            scaleDataChanged ();
+        }
+    }
+
+    double  dSeconds = elapsedSeconds (tStart);
+    printf ("frame:   %ld requests, %ld response bytes, %.3f sec, %.0f requests/sec, %.1f nsec/request\n",
+        nRequests, lBytes, dSeconds, nRequests / dSeconds, dSeconds * 1e9 / nRequests);
+}
+
+static void benchSketch (long nRequests)
+{
+    long    lBytes = 0;
+    auto    tStart = std::chrono::steady_clock::now();
+
+    for (long i = 0; i < nRequests; i++) {
+        const char *pRequest = requestList[i % nRequestList];
+
+        hostSerialInput (pRequest, 1);
+        hostSerialInput ("\r", 1);
+        while (Serial.available ()) loop ();
+
+        lBytes += hostSerialOutput.length ();
+        hostSerialOutput.clear ();
+    }
+
+    double  dSeconds = elapsedSeconds (tStart);
+    printf ("sketch:  %ld requests, %ld response bytes, %.3f sec, %.0f requests/sec, %.1f nsec/request\n",
+        nRequests, lBytes, dSeconds, nRequests / dSeconds, dSeconds * 1e9 / nRequests);
+}
+
+int main (int argc, char *argv[])
+{
+    long    nRequests = 1000000;
+
+    if (argc > 1) nRequests = atol (argv[1]);
+    if (nRequests < 1) nRequests = 1;
+
+    setup ();
+    hostSerialOutput.clear ();
+
+    bool  bGood = checkPolicy ();
+    bGood = checkTrajectory () && bGood;
+    bGood = checkPipelined () && bGood;
+    bGood = checkSaveDefaults () && bGood;
+    bGood = checkLoadDefaults () && bGood;
+
+    benchSprintf (nRequests);
+    benchPolicy (nRequests);
+    benchFrame (nRequests);
+    benchSketch (nRequests);
+    benchTrajectory (nRequests);
+
+    return bGood ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+/*
+ * Hardware independent part of the scale simulator.
+ *
+ * See scalecore.h for a description.
+ */
+
+#include <string.h>
+
+#include "scalecore.h"
+
+// constant data is kept in flash on the AVR rather than being copied to SRAM at startup.
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#elif !defined(PROGMEM)
+#define PROGMEM
+#define pgm_read_byte(p)    (*(const unsigned char *)(p))
+#endif
+
+int   lb1 = 0, lb2 = 250;    // most significant and least signicant parts of weight.
+unsigned char s1 = 0x30, s2 = 0x30;   // status byte 1 and status byte 2
+
+ScaleUnits   iUnits = English;
+
+SpecInUse  specInUse = Scp_02;
+
+static const char  unitsText[2][2] PROGMEM = { {'L', 'B'}, {'K', 'G'} };    // indexed by iUnits
+static const char  hexDigits[16] PROGMEM = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+
+// write v as exactly nDigits decimal digits with leading zeros, as %N.Nd would for a value
+// which fits. higher digits are dropped, modWeightValues() keeps lb1 and lb2 in range.
+template <int nDigits> static inline char *putDigits (char *p, unsigned int v)
+{
+  for (int i = nDigits - 1; i >= 0; i--) {
+    p[i] = '0' + (v % 10);
+    v /= 10;
+  }
+  return p + nDigits;
+}
+
+// the weight and units, xxxx.xxuu for SCP-01 or xx.xxxuu for SCP-02.
+template <class Spec> static inline char *putWeight (char *p)
+{
+  p = putDigits<Spec::maxMsp> (p, lb1);
+  *p++ = '.';
+  p = putDigits<Spec::maxLsp> (p, lb2);
+  *p++ = pgm_read_byte (&unitsText[iUnits][0]);
+  *p++ = pgm_read_byte (&unitsText[iUnits][1]);
+  return p;
+}
+
+// the status bytes and the end of the response, hh<CR><ETX> or Shh<CR><ETX>.
+template <class Spec> static inline char *putStatus (char *p)
+{
+  if (Spec::statusPrefix) *p++ = Spec::statusPrefix;
+  *p++ = s1;
+  *p++ = s2;
+  *p++ = '\r';
+  *p++ = '\x03';
+  return p;
+}
+
+template <class Spec> static int buildWeight (char *cBuff)
+{
+  char *p = cBuff;
+
+  *p++ = '\n';
+  p = putWeight<Spec> (p);
+  *p++ = '\r';
+  *p++ = '\n';
+  p = putStatus<Spec> (p);
+  *p = 0;
+  return p - cBuff;
+}
+
+template <class Spec> static int buildStatus (char *cBuff)
+{
+  char *p = cBuff;
+
+  *p++ = '\n';
+  p = putStatus<Spec> (p);
+  *p = 0;
+  return p - cBuff;
+}
+
+static const char  unknownFrame[] = "\n?\r\x03";
+
+void modWeightValues()
+{
+    if (specInUse == Scp_01) {
+      lb1 %= scalePow10 (Scp01Spec::maxMsp);
+      lb2 %= scalePow10 (Scp01Spec::maxLsp);
+    } else {
+      lb1 %= scalePow10 (Scp02Spec::maxMsp);
+      lb2 %= scalePow10 (Scp02Spec::maxLsp);
+    }
+}
+
+bool scaleStatusByteOk(unsigned char c)
+{
+    return c >= 0x20 && c < 0x7f;
+}
+
+bool scaleSetData(const unsigned char *pData)
+{
+    unsigned int  newLb1 = pData[0] | ((unsigned int)pData[1] << 8);
+    unsigned int  newLb2 = pData[2] | ((unsigned int)pData[3] << 8);
+
+    if (pData[6] != English && pData[6] != Metric) return false;
+    if (pData[7] != Scp_01 && pData[7] != Scp_02) return false;
+    if (newLb1 >= (unsigned int)scalePow10 (specMaxMsp ((SpecInUse)pData[7]))) return false;
+    if (newLb2 >= (unsigned int)scalePow10 (specMaxLsp ((SpecInUse)pData[7]))) return false;
+    if (!scaleStatusByteOk (pData[4]) || !scaleStatusByteOk (pData[5])) return false;
+
+    lb1 = (int)newLb1;
+    lb2 = (int)newLb2;
+    s1 = pData[4];
+    s2 = pData[5];
+    iUnits = (ScaleUnits)pData[6];
+    specInUse = (SpecInUse)pData[7];
+    scaleDataChanged();
+    return true;
+}
+
+void scaleGetData(unsigned char *pData)
+{
+    pData[0] = (unsigned char)lb1;
+    pData[1] = (unsigned char)(lb1 >> 8);
+    pData[2] = (unsigned char)lb2;
+    pData[3] = (unsigned char)(lb2 >> 8);
+    pData[4] = s1;
+    pData[5] = s2;
+    pData[6] = (unsigned char)iUnits;
+    pData[7] = (unsigned char)specInUse;
+}
+
+int buildResponse(const char *inCommand, char *cBuff)
+{
+    switch (inCommand[0]) {
+      case 'W':    // weight command
+      case 'w':
+        return (specInUse == Scp_01) ? buildWeight<Scp01Spec> (cBuff) : buildWeight<Scp02Spec> (cBuff);
+      case 'S':    // status command
+      case 's':
+      case 'Z':    // zero scale command (zeros scale but response is same as status command)
+      case 'z':
+        return (specInUse == Scp_01) ? buildStatus<Scp01Spec> (cBuff) : buildStatus<Scp02Spec> (cBuff);
+      default:     // unrecognized command
+        memcpy (cBuff, unknownFrame, sizeof(unknownFrame));
+        return sizeof(unknownFrame) - 1;
+    }
+}
+
+// response frames for the weight and the status requests which are rebuilt by
+// updateResponseFrames() when the scale measurement data changes.
+static char  weightFrame[32];
+static char  statusFrame[16];
+static int   nWeightFrame, nStatusFrame;
+static bool  bFramesValid = false;
+
+void scaleDataChanged(void)
+{
+    bFramesValid = false;
+}
+
+void updateResponseFrames(void)
+{
+    if (specInUse == Scp_01) {
+      nWeightFrame = buildWeight<Scp01Spec> (weightFrame);
+      nStatusFrame = buildStatus<Scp01Spec> (statusFrame);
+    } else {
+      nWeightFrame = buildWeight<Scp02Spec> (weightFrame);
+      nStatusFrame = buildStatus<Scp02Spec> (statusFrame);
+    }
+    bFramesValid = true;
+}
+
+const char *getResponseFrame(const char *inCommand, int *pnLength)
+{
+    if (!bFramesValid) updateResponseFrames();
+
+    switch (inCommand[0]) {
+      case 'W':    // weight command
+      case 'w':
+        *pnLength = nWeightFrame;
+        return weightFrame;
+      case 'S':    // status command
+      case 's':
+      case 'Z':    // zero scale command (zeros scale but response is same as status command)
+      case 'z':
+        *pnLength = nStatusFrame;
+        return statusFrame;
+      default:     // unrecognized command
+        *pnLength = sizeof(unknownFrame) - 1;
+        return unknownFrame;
+    }
+}
+
+// the 16 character LCD info line, xxxx.xxuu hh hh for SCP-01 or xx.xxxuu hh hh for SCP-02.
+template <class Spec> static int buildLcdLine (char *cBuff)
+{
+  char *p = putWeight<Spec> (cBuff);
+
+  *p++ = ' ';
+  *p++ = pgm_read_byte (&hexDigits[s1 >> 4]);
+  *p++ = pgm_read_byte (&hexDigits[s1 & 0x0f]);
+  *p++ = ' ';
+  *p++ = pgm_read_byte (&hexDigits[s2 >> 4]);
+  *p++ = pgm_read_byte (&hexDigits[s2 & 0x0f]);
+  if (Spec::lcdPad) *p++ = Spec::lcdPad;
+  *p = 0;
+  return p - cBuff;
+}
+
+int buildLcdInfo(char *cBuff)
+{
+    return (specInUse == Scp_01) ? buildLcdLine<Scp01Spec> (cBuff) : buildLcdLine<Scp02Spec> (cBuff);
+}
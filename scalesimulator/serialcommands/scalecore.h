@@ -0,0 +1,103 @@
+/*
+ * Hardware independent part of the scale simulator.
+ *
+ * This contains the scale measurement data and the formatting of the
+ * response messages for the SCP-01 and SCP-02 specifications. It does
+ * not use any of the Arduino libraries so that the same source can be
+ * compiled for the Arduino as part of the sketch and compiled on a host
+ * such as Linux in order to test and profile the response logic.
+ *
+ * The sketch, serialcommands.ino, provides the hardware parts: the Serial
+ * port, the LCD, and the keypad.
+ */
+
+#if !defined(SCALECORE_H_INCLUDED)
+#define SCALECORE_H_INCLUDED
+
+enum  ScaleUnits {English, Metric};
+enum SpecInUse { Scp_01 = 0, Scp_02 = 1};
+
+// the response formats of the SCP-01 and SCP-02 specifications are policy types whose
+// digit widths and framing are compile time constants. the response builders are
+// templates on the policy so each specification gets its own straight line code with
+// the widths built in rather than a run time table of printf format strings, which the
+// AVR keeps in SRAM, and a lookup of specInUse on every use.
+//
+//   SCP-01  <LF>xxxx.xxuu<CR><LF>hh<CR><ETX>     status  <LF>hh<CR><ETX>
+//   SCP-02  <LF>xx.xxxuu<CR><LF>Shh<CR><ETX>     status  <LF>Shh<CR><ETX>
+
+constexpr int scalePow10 (int n) { return (n <= 0) ? 1 : 10 * scalePow10 (n - 1); }
+
+struct Scp01Spec {
+  static constexpr int   maxMsp = 4;             // digits before the decimal point
+  static constexpr int   maxLsp = 2;             // digits after the decimal point
+  static constexpr char  statusPrefix = 0;       // no character before the status bytes
+  static constexpr char  lcdPad = 0;             // the LCD info line is 16 characters
+};
+
+struct Scp02Spec {
+  static constexpr int   maxMsp = 2;
+  static constexpr int   maxLsp = 3;
+  static constexpr char  statusPrefix = 'S';     // an S before the status bytes
+  static constexpr char  lcdPad = ' ';           // pad the shorter LCD info line with a space
+};
+
+// the longest weight response, <LF> digits . digits uu <CR><LF> S hh <CR><ETX>
+constexpr int maxWeightFrame (int nDigits) { return 1 + nDigits + 1 + 2 + 2 + 1 + 2 + 2; }
+static_assert (maxWeightFrame (Scp01Spec::maxMsp + Scp01Spec::maxLsp) < 32, "SCP-01 weight response too long for the frame");
+static_assert (maxWeightFrame (Scp02Spec::maxMsp + Scp02Spec::maxLsp) < 32, "SCP-02 weight response too long for the frame");
+
+// the digit widths of the specification in use, for the keypad weight entry.
+inline int specMaxMsp (SpecInUse spec) { return (spec == Scp_01) ? Scp01Spec::maxMsp : Scp02Spec::maxMsp; }
+inline int specMaxLsp (SpecInUse spec) { return (spec == Scp_01) ? Scp01Spec::maxLsp : Scp02Spec::maxLsp; }
+
+// scale measurement data. this determines values returned in a weight response.
+
+extern int   lb1, lb2;                  // most significant and least signicant parts of weight.
+extern unsigned char s1, s2;            // status byte 1 and status byte 2
+extern ScaleUnits   iUnits;
+extern SpecInUse  specInUse;
+
+// reduce lb1 and lb2 to the digit widths of the specification in use.
+void modWeightValues();
+
+// format the response message for the command in inCommand into cBuff,
+// which must be at least 32 bytes. returns the length of the response.
+// this formats the response each time, see getResponseFrame() below.
+int buildResponse(const char *inCommand, char *cBuff);
+
+// the response messages are kept ready-built in response frames so that a request
+// does not need to format its response. the frames are rebuilt only when the scale
+// measurement data changes. scaleDataChanged() must be called after changing any of
+// lb1, lb2, s1, s2, iUnits, or specInUse so that the frames are rebuilt before the
+// next request. updateResponseFrames() rebuilds the frames immediately.
+void scaleDataChanged(void);
+void updateResponseFrames(void);
+
+// return the ready-built response frame for the command in inCommand and
+// its length in *pnLength.
+const char *getResponseFrame(const char *inCommand, int *pnLength);
+
+// the scale measurement data in the 8 bytes of a control frame of the test rig, see
+// libraries/SimFramer/SimControl.h. lb1 and lb2 as 16 bit little endian numbers then
+// s1, s2, iUnits, and specInUse.
+#define SCALE_CTL_SET       0x01    // set the scale measurement data, the reply is the status
+#define SCALE_CTL_GET       0x02    // the reply is the status and the scale measurement data
+#define SCALE_CTL_MOTION    0x03    // uint8 trajectory to start, 0 to stop, see scaletrajectory.h
+#define SCALE_DATA_SIZE     8
+
+// set the scale measurement data from pData and call scaleDataChanged(). returns false
+// and changes nothing if a value is out of range: the units or the specification is not
+// known, the weight has more digits than the specification allows, or a status byte is
+// not a 7 bit printable character, which would break the framing of the responses.
+bool scaleSetData(const unsigned char *pData);
+void scaleGetData(unsigned char *pData);
+
+// true if c can be a status byte, a 7 bit printable character.
+bool scaleStatusByteOk(unsigned char c);
+
+// format the current settings for the first line of the 16x2 LCD into cBuff,
+// which must be at least 32 bytes. returns the length of the text.
+int buildLcdInfo(char *cBuff);
+
+#endif    // !defined(SCALECORE_H_INCLUDED)
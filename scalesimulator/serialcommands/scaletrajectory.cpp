@@ -0,0 +1,218 @@
+/*
+ * Weight trajectories of the scale simulator.
+ *
+ * See scaletrajectory.h for a description.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "scalecore.h"
+#include "scaletrajectory.h"
+
+// constant data is kept in flash on the AVR rather than being copied to SRAM at startup.
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#elif !defined(PROGMEM)
+#define PROGMEM
+#define pgm_read_word(p)    (*(const uint16_t *)(p))
+#define memcpy_P            memcpy
+#endif
+#if !defined(pgm_read_ptr)
+#define pgm_read_ptr(p)     (*(const void * const *)(p))
+#endif
+
+// the settling curve, exp(-8x) cos(5 pi x) (1 - x) for x from 0 to 1 in steps of 1/64, with
+// 1.0 as 16384. the weight starts at 1.0 of the way from the target, swings past it by 19%,
+// and is at the target at the end. the (1 - x) makes the last sample exactly 0.
+static const int16_t  settleCurve[SCALE_SETTLE_SAMPLES + 1] PROGMEM = {
+   16384,  13806,  10902,   7952,   5176,   2724,    687,   -893,
+   -2018,  -2723,  -3062,  -3101,  -2913,  -2568,  -2129,  -1650,
+   -1176,   -739,   -360,    -53,    180,    341,    436,    476,
+     471,    434,    375,    305,    231,    160,     96,     43,
+       0,    -31,    -52,    -63,    -66,    -64,    -57,    -48,
+     -38,    -28,    -19,    -11,     -4,      1,      4,      6,
+       7,      7,      7,      6,      5,      3,      2,      1,
+       1,      0,      0,      0,      0,      0,      0,      0,
+       0
+};
+
+struct TrajSegment {
+  int32_t   lTarget;        // weight the segment settles to, thousandths
+  uint16_t  usSettleMsec;   // time to settle from the weight at the start of the segment, 0 for a step
+  uint16_t  usMsec;         // length of the segment, 0 ends the trajectory
+  int16_t   sCreep;         // drift once settled, thousandths per second
+  uint8_t   uchNoise;       // noise, up to this many thousandths either way
+};
+
+// item placed and removed, the weight a point of sale application waits on most often.
+static const TrajSegment  trajPlaceRemove[] PROGMEM = {
+  { 0,      0,     2000, 0, 1 },
+  { 2500,   1500,  4000, 0, 1 },
+  { 0,      1000,  2000, 0, 1 },
+  { 0,      0,     0,    0, 0 }
+};
+
+// heavy item left on the scale, the load cell creeps and the weight never quite stops.
+static const TrajSegment  trajCreep[] PROGMEM = {
+  { 0,      0,     1000,  0, 1 },
+  { 12000,  2000,  10000, 3, 1 },
+  { 0,      1500,  2000,  0, 1 },
+  { 0,      0,     0,     0, 0 }
+};
+
+// more than the capacity of the scale.
+static const TrajSegment  trajOverload[] PROGMEM = {
+  { 0,      0,     1000, 0, 1 },
+  { 35000,  1000,  3000, 0, 2 },
+  { 0,      1000,  2000, 0, 1 },
+  { 0,      0,     0,    0, 0 }
+};
+
+// vibration, a fan or a bump, so the weight is seldom stable, and then below zero when the
+// item is removed until the scale is zeroed.
+static const TrajSegment  trajVibration[] PROGMEM = {
+  { 1250,   1000,  6000, 0, 8 },
+  { -200,   800,   3000, 0, 1 },
+  { 0,      500,   2000, 0, 1 },
+  { 0,      0,     0,    0, 0 }
+};
+
+static const TrajSegment * const  trajectories[SCALE_TRAJECTORIES] PROGMEM = {
+  trajPlaceRemove, trajCreep, trajOverload, trajVibration
+};
+
+// the state of the trajectory running.
+static unsigned char  uchRunning = 0;
+static const TrajSegment  *pSegment;          // segment in flash
+static TrajSegment    segment;                // copy of the segment in SRAM
+static unsigned long  ulSegmentMsec;          // time the segment started
+static long           lSegmentStart;          // weight at the start of the segment, without the noise
+static long           lWeight;                // weight of the last update
+static long           lMotionRef;             // weight the motion band is centered on
+static unsigned long  ulMotionMsec;           // time the weight last left the motion band
+static uint16_t       usNoise = 0xace1;       // state of the noise generator
+
+// x * h where h is 1.0 as 16384, split so that neither product overflows 32 bits.
+static long mulQ14(long x, int h)
+{
+  return (x >> 14) * h + (((x & 0x3fff) * (long)h) >> 14);
+}
+
+// the settling curve at t of d msec, interpolated between samples.
+static int settleAt(uint16_t t, uint16_t d)
+{
+  unsigned long  ulPos = ((unsigned long)t * SCALE_SETTLE_SAMPLES * 256) / d;    // sample number with 8 fraction bits
+  uint8_t  i = (uint8_t)(ulPos >> 8);
+  int  h0 = (int16_t)pgm_read_word(&settleCurve[i]);
+  int  h1 = (int16_t)pgm_read_word(&settleCurve[i + 1]);
+
+  return h0 + (int)(((long)(h1 - h0) * (long)(ulPos & 0xff)) >> 8);
+}
+
+// the weight t msec into the segment without the noise.
+static long segmentWeight(uint16_t t)
+{
+  if (t < segment.usSettleMsec) {
+    return segment.lTarget + mulQ14(lSegmentStart - segment.lTarget, settleAt(t, segment.usSettleMsec));
+  }
+  return segment.lTarget + (long)segment.sCreep * (long)(t - segment.usSettleMsec) / 1000;
+}
+
+static void loadSegment(const TrajSegment *p)
+{
+  memcpy_P(&segment, p, sizeof(segment));
+  if (segment.usMsec == 0) {
+    // the end, start again from the first segment.
+    p = (const TrajSegment *)pgm_read_ptr(&trajectories[uchRunning - 1]);
+    memcpy_P(&segment, p, sizeof(segment));
+  }
+  pSegment = p;
+}
+
+// the current weight in thousandths, from lb1 and lb2 as the specification in use has them.
+static long currentWeight(void)
+{
+  return (specInUse == Scp_01) ? (long)lb1 * 1000 + (long)lb2 * 10 : (long)lb1 * 1000 + lb2;
+}
+
+bool scaleTrajectoryStart(unsigned char uchTrajectory, unsigned long ulMsec)
+{
+  if (uchTrajectory > SCALE_TRAJECTORIES) return false;
+
+  uchRunning = uchTrajectory;
+  if (uchTrajectory == 0) return true;
+
+  lSegmentStart = lWeight = lMotionRef = currentWeight();
+  ulSegmentMsec = ulMotionMsec = ulMsec;
+  loadSegment((const TrajSegment *)pgm_read_ptr(&trajectories[uchTrajectory - 1]));
+  return true;
+}
+
+unsigned char scaleTrajectoryRunning(void)
+{
+  return uchRunning;
+}
+
+long scaleTrajectoryWeight(void)
+{
+  return lWeight;
+}
+
+int scaleSettleSample(int i)
+{
+  return (int16_t)pgm_read_word(&settleCurve[i]);
+}
+
+bool scaleTrajectoryUpdate(unsigned long ulMsec)
+{
+  if (!uchRunning) return false;
+
+  // move on to the segment of ulMsec. after a long gap, such as the time a host program
+  // was stopped in a debugger, carry on from the segment it was in rather than catching up.
+  if (ulMsec - ulSegmentMsec > 0xffffUL) ulSegmentMsec = ulMsec;
+  while (ulMsec - ulSegmentMsec >= segment.usMsec) {
+    lSegmentStart = segmentWeight(segment.usMsec);
+    ulSegmentMsec += segment.usMsec;
+    loadSegment(pSegment + 1);
+  }
+
+  // xorshift noise, evenly spread over -uchNoise to +uchNoise.
+  usNoise ^= usNoise << 7;
+  usNoise ^= usNoise >> 9;
+  usNoise ^= usNoise << 8;
+  lWeight = segmentWeight((uint16_t)(ulMsec - ulSegmentMsec));
+  if (segment.uchNoise) lWeight += (long)(usNoise % (2 * segment.uchNoise + 1)) - segment.uchNoise;
+
+  // the status bits as the scale derives them from the weight.
+  if (lWeight - lMotionRef > SCALE_MOTION_BAND || lMotionRef - lWeight > SCALE_MOTION_BAND) {
+    lMotionRef = lWeight;
+    ulMotionMsec = ulMsec;
+  }
+  unsigned char  uchS1 = (unsigned char)((s1 & 0xfc) | ((ulMsec - ulMotionMsec < SCALE_STABLE_MSEC) ? 0x01 : 0)
+      | ((lWeight >= -SCALE_ZERO_BAND && lWeight <= SCALE_ZERO_BAND) ? 0x02 : 0));
+  unsigned char  uchS2 = (unsigned char)((s2 & 0xfc) | ((lWeight < -SCALE_ZERO_BAND) ? 0x01 : 0)
+      | ((lWeight > SCALE_CAPACITY) ? 0x02 : 0));
+
+  // the weight as the digits of the specification in use, rounded to hundredths for SCP-01.
+  long  lShown = (lWeight < 0) ? 0 : (lWeight > SCALE_CAPACITY) ? SCALE_CAPACITY : lWeight;
+  int   newLb1, newLb2;
+
+  if (specInUse == Scp_01) {
+    lShown = (lShown + 5) / 10;
+    newLb1 = (int)(lShown / 100);
+    newLb2 = (int)(lShown % 100);
+  } else {
+    newLb1 = (int)(lShown / 1000);
+    newLb2 = (int)(lShown % 1000);
+  }
+
+  if (newLb1 == lb1 && newLb2 == lb2 && uchS1 == s1 && uchS2 == s2) return false;
+  lb1 = newLb1;
+  lb2 = newLb2;
+  s1 = uchS1;
+  s2 = uchS2;
+  modWeightValues();
+  scaleDataChanged();
+  return true;
+}
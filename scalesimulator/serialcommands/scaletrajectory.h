@@ -0,0 +1,59 @@
+/*
+ * Weight trajectories of the scale simulator.
+ *
+ * With the keypad the weight and the status bytes are fixed until someone presses a key,
+ * so the motion bit is set by hand and a point of sale application never sees a weight
+ * which is still settling. A trajectory instead moves the weight over time the way a real
+ * scale does when an item is put on it or taken off: the weight swings past the new load,
+ * settles, may creep slowly afterwards, and always has a little noise. The status bits are
+ * derived from the weight the way the scale would derive them:
+ *   - motion          the weight has moved more than SCALE_MOTION_BAND in the last
+ *                     SCALE_STABLE_MSEC, status byte 1 bit 0
+ *   - at zero         the weight is within SCALE_ZERO_BAND of zero, status byte 1 bit 1
+ *   - under capacity  the weight is below zero by more than SCALE_ZERO_BAND, status byte 2 bit 0
+ *   - over capacity   the weight is more than SCALE_CAPACITY, status byte 2 bit 1
+ * An under or over capacity weight is reported as 0 or SCALE_CAPACITY.
+ *
+ * A trajectory is a list of segments kept in flash. Each segment moves from the weight at
+ * its start to its target weight over its settle time following a damped oscillation which
+ * is a precomputed table of 65 samples in flash, interpolated between samples, and then
+ * drifts at its creep rate until the segment ends. The trajectories repeat from their first
+ * segment. The weights are fixed point, thousandths of a unit, and the arithmetic is 32 bit
+ * with no floating point or 64 bit multiply so an update takes little time on the AVR.
+ *
+ * Usage:
+ *     scaleTrajectoryStart (1, millis ());                     // item placed and removed
+ *     if (scaleTrajectoryUpdate (millis ())) updateLCDInfo (); // every 10 msec or so
+ *     scaleTrajectoryStart (0, millis ());                     // stop, the weight stays as it is
+ */
+
+#if !defined(SCALETRAJECTORY_H_INCLUDED)
+#define SCALETRAJECTORY_H_INCLUDED
+
+#define SCALE_TRAJECTORIES      4         // number of trajectories, 1 to SCALE_TRAJECTORIES
+#define SCALE_CAPACITY          30000L    // capacity of the scale, thousandths of a unit
+#define SCALE_ZERO_BAND         2         // at zero if within this many thousandths of zero
+#define SCALE_MOTION_BAND       5         // a change of more than this many thousandths is motion
+#define SCALE_STABLE_MSEC       500       // stable once the weight has stayed within the band this long
+
+#define SCALE_SETTLE_SAMPLES    64        // samples of the settling curve, the table has one more
+
+// start trajectory uchTrajectory, 1 to SCALE_TRAJECTORIES, from the current weight at time
+// ulMsec, or stop the trajectory with 0. returns false if there is no such trajectory.
+bool scaleTrajectoryStart(unsigned char uchTrajectory, unsigned long ulMsec);
+
+// the trajectory running, 0 if none.
+unsigned char scaleTrajectoryRunning(void);
+
+// move the weight and the status bits to where the trajectory is at time ulMsec. returns
+// true if lb1, lb2, s1, or s2 changed, in which case scaleDataChanged() has been called.
+bool scaleTrajectoryUpdate(unsigned long ulMsec);
+
+// the weight of the last update before it was limited to 0 to SCALE_CAPACITY, thousandths.
+long scaleTrajectoryWeight(void);
+
+// the settling curve, sample i of 0 to SCALE_SETTLE_SAMPLES, 1.0 is 16384. for checking
+// the table against the curve it was computed from.
+int scaleSettleSample(int i);
+
+#endif    // !defined(SCALETRAJECTORY_H_INCLUDED)
@@ -78,59 +78,86 @@
  */
 
  
-byte incoming;
-String inBuffer;
-
-// scale measurement data. this determines values returned in a weight response.
-
-int   lb1 = 0, lb2 = 250;    // most significant and least signicant parts of weight.
-unsigned char s1 = 0x30, s2 = 0x30;   // status byte 1 and status byte 2
-
-enum  ScaleUnits {English, Metric};
-ScaleUnits   iUnits = English;
-
-struct {
-  char *specWeight;
-  char *specStatus;
-  short maxMsp;
-  short maxLsp;
-} specInUseFmt [] = {
-      //weight then units then status
-      { "\n%4.4d.%2.2d%s\r\n%c%c\r\x03", "\n%c%c\r\x03", 4, 2},    // SCP-01 specification for response
-      { "\n%2.2d.%3.3d%s\r\nS%c%c\r\x03", "\nS%c%c\r\x03", 2, 3 }  // SCP-02 specification for response
-};
-
-char *lcdInfoFmt[] = {
-      // max of 16 characters for 16x2 LCD module
-      "%4.4d.%2.2d%-2.2s %2.2x %2.2x",    // SCP-01 specification for response
-      "%2.2d.%3.3d%-2.2s %2.2x %2.2x "    // SCP-02 specification for response
-};
-
-enum SpecInUse { Scp_01 = 0, Scp_02 = 1};
-SpecInUse  specInUse = Scp_02;
-
-int mypow (int baseVal, int expVal)
+// commands from the point of sale terminal are collected in a fixed size ring buffer
+// rather than a String so that no memory is allocated as characters are received.
+// a command longer than will fit is thrown away and counted as an overflow.
+#include <SimFramer.h>
+
+SimFramer<32>  cmdFramer;
+char  cmdBuffer[16];        // the command being handled, the SCP-01 commands are a single letter
+
+// worst case time through loop() in microseconds. this is the longest a scale
+// request may wait before it is seen. shown on the LCD with the D key.
+unsigned long  loopMaxMicros = 0;
+
+// the scale measurement data, lb1, lb2, s1, s2, iUnits, and specInUse, along with
+// the formatting of the response messages is in scalecore.cpp which does not use
+// any of the Arduino libraries so that it can also be compiled and tested on a host.
+#include "scalecore.h"
+
+// the weight and the status bits can also follow a trajectory, an item put on the scale
+// which settles, creeps, and has some noise, rather than being fixed until a key is pressed.
+// see scaletrajectory.h. a trajectory is started with the C key followed by 2 to 5 and is
+// stopped with the * key.
+#include "scaletrajectory.h"
+
+// the units, specification, and status bytes set with the keypad are kept in the wear
+// leveled configuration store, see libraries/ConfigStore, as the defaults for the next
+// startup. the weight is not kept, a scale starts with what is on it.
+#include <EEPROM.h>
+#include <ConfigStore.h>
+#include <ConfigKeys.h>     // CONFIG_SCALE_DEFAULTS, the key of the defaults
+#define CONFIG_SAVE_IDLE_MSEC   2000  // quiet time before the defaults are written
+
+ConfigStore<EEPROMClass, 16>  config (EEPROM, 0, 1024, 4);
+
+// writing a byte of EEPROM takes 3.3 msec and a change can copy all of the settings to the
+// next segment, so the keypad only marks the defaults as changed and they are saved once
+// there have been no keys or requests for CONFIG_SAVE_IDLE_MSEC. a request which arrives
+// while they are written waits, but several keys make a single write.
+bool           bDefaultsChanged = false;
+unsigned long  ulLastActivity = 0;        // millis() of the last key or request
+
+void loadScaleDefaults (void)
 {
-  int iVal = 1;
+  uint8_t  auchDefaults[4];
+
+  if (config.get (CONFIG_SCALE_DEFAULTS, auchDefaults, sizeof(auchDefaults)) != sizeof(auchDefaults)) return;
+  if (auchDefaults[0] == English || auchDefaults[0] == Metric) iUnits = (ScaleUnits)auchDefaults[0];
+  if (auchDefaults[1] == Scp_01 || auchDefaults[1] == Scp_02) specInUse = (SpecInUse)auchDefaults[1];
+  // the status bytes go into every status reply, a byte which is not printable would
+  // break the framing so keep the compiled in ones, as scaleSetData() does.
+  if (scaleStatusByteOk (auchDefaults[2]) && scaleStatusByteOk (auchDefaults[3])) {
+    s1 = auchDefaults[2];
+    s2 = auchDefaults[3];
+  }
+  scaleDataChanged();
+}
 
-  if (expVal == 0) {
-    iVal = 0;
-  } else if (expVal > 0) {
-    for ( ; expVal > 0; expVal--) {
-      iVal *= baseVal;
+// the store writes only if the defaults changed.
+void saveScaleDefaults (void)
+{
+  uint8_t  auchDefaults[4] = { (uint8_t)iUnits, (uint8_t)specInUse, s1, s2 };
+  uint8_t  auchSaved[4];
+
+  // while a trajectory runs bits 0 and 1 of the status bytes follow the weight rather than
+  // the keypad, keep the ones saved.
+  if (scaleTrajectoryRunning()) {
+    if (config.get (CONFIG_SCALE_DEFAULTS, auchSaved, sizeof(auchSaved)) != sizeof(auchSaved)) {
+      auchSaved[2] = auchSaved[3] = 0;
     }
+    auchDefaults[2] = (s1 & 0xfc) | (auchSaved[2] & 0x03);
+    auchDefaults[3] = (s2 & 0xfc) | (auchSaved[3] & 0x03);
   }
-
-  return iVal;
+  config.set (CONFIG_SCALE_DEFAULTS, auchDefaults, sizeof(auchDefaults));
 }
-void modWeightValues()
-{
-    int iModVal = 1;
 
-    iModVal = mypow(10, specInUseFmt[specInUse].maxMsp);
-    lb1 %= iModVal;
-    iModVal = mypow(10, specInUseFmt[specInUse].maxLsp);
-    lb2 %= iModVal;
+// save the defaults changed with the keypad once the keypad and the Serial port are idle.
+void TaskSave (void)
+{
+  if (!bDefaultsChanged || millis() - ulLastActivity < CONFIG_SAVE_IDLE_MSEC) return;
+  bDefaultsChanged = false;
+  saveScaleDefaults();
 }
 
 #define USE_LCD
@@ -140,7 +167,7 @@ void modWeightValues()
 
 #if defined(USE_LCD)
 // A 16x2 LCD can be attached to the Arduino to show
-// status information. See format specifier lcdInfoFmt[] above.
+// status information. See buildLcdInfo() in scalecore.cpp.
 //  - d  -> a digit or a decimal point for the current weight setting
 //  - u  -> a letter of current weight units:  lb, kg
 //  - s  -> a letter of current scale specification
@@ -163,6 +190,67 @@ void modWeightValues()
 // use the six analog pins as digital pins.
 // Analog pin 0 is digital pin 14, Analog pin 1 is digital pin 15, etc.
 LiquidCrystal lcd(14, 15, 16, 17, 18, 19);
+
+// Writing to the LCD is slow. Each character is sent 4 bits at a time and then the LCD
+// needs time to process it so a full line can take a couple of milliseconds. If the LCD
+// were written all at once then a scale request arriving during the update would wait.
+//
+// Instead the text to display is put into a shadow buffer, lcdShadow[], and the range of
+// columns of each line which were changed is remembered. serviceLcd() is called each time
+// through loop() and does at most one LCD operation, moving the cursor or writing one
+// character, so that the Serial port is checked between each character.
+char    lcdShadow[2][16];       // what the LCD should be showing
+char    lcdActual[2][16];       // what has been written to the LCD
+uint8_t lcdDirtyFirst[2] = {16, 16};   // first changed column of each line, 16 if none
+uint8_t lcdDirtyLast[2] = {0, 0};      // last changed column of each line
+uint8_t lcdCursorCol = 255, lcdCursorRow = 255;   // where the LCD will write next, 255 if not known
+
+void lcdShadowClear (void)
+{
+  lcd.begin(16, 2);     // also clears the display
+  memset (lcdShadow, ' ', sizeof(lcdShadow));
+  memset (lcdActual, ' ', sizeof(lcdActual));
+  lcdCursorCol = lcdCursorRow = 255;
+}
+
+void lcdShadowPrint (uint8_t col, uint8_t row, const char *psz)
+{
+  for ( ; *psz && col < 16; col++, psz++) {
+    if (lcdShadow[row][col] != *psz) {
+      lcdShadow[row][col] = *psz;
+      if (col < lcdDirtyFirst[row]) lcdDirtyFirst[row] = col;
+      if (col > lcdDirtyLast[row]) lcdDirtyLast[row] = col;
+    }
+  }
+}
+
+void serviceLcd (void)
+{
+  for (uint8_t row = 0; row < 2; row++) {
+    while (lcdDirtyFirst[row] <= lcdDirtyLast[row]) {
+      uint8_t col = lcdDirtyFirst[row];
+
+      if (lcdShadow[row][col] == lcdActual[row][col]) {
+        // changed and then changed back so nothing to write.
+        lcdDirtyFirst[row]++;
+        continue;
+      }
+      if (lcdCursorCol != col || lcdCursorRow != row) {
+        lcd.setCursor(col, row);
+        lcdCursorCol = col;
+        lcdCursorRow = row;
+        return;         // the cursor move is this tick's LCD operation
+      }
+      lcd.write(lcdShadow[row][col]);
+      lcdActual[row][col] = lcdShadow[row][col];
+      lcdCursorCol++;
+      lcdDirtyFirst[row]++;
+      return;
+    }
+    lcdDirtyFirst[row] = 16;    // nothing left to write on this line
+    lcdDirtyLast[row] = 0;
+  }
+}
 #endif
 
 #if defined(USE_KEYPAD)
@@ -191,6 +279,11 @@ byte colPins[COLS] = {5, 4, 3, 2}; //connect to the column pinouts of the keypad
 //initialize an instance of class NewKeypad
 Keypad customKeypad = Keypad( makeKeymap(hexaKeys), rowPins, colPins, ROWS, COLS);
 
+// the keypad is scanned by a task every keypadScanMsec rather than each time through
+// loop(). the Keypad library debounces keys for 10 milliseconds so scanning more often
+// does not help.
+const uint16_t keypadScanMsec = 10;
+
 short lbNdx = 0;    // index for keypad data entry into lb1 and lb2 to change weight
 short stNdx = 0;    // set status indicator, 0 no set, 1 set byte 1, 2 set byte 2, 100 set Spec in use
 
@@ -200,8 +293,7 @@ int setLcdIndicator (int c)
   cBuff[0] = c;
   
 #if defined(USE_LCD)
-  lcd.setCursor(0,1);    // beginning at column 0, line 1 (begining of first column on second line)
-  lcd.print(cBuff);
+  lcdShadowPrint(0, 1, cBuff);    // beginning at column 0, line 1 (begining of first column on second line)
 #endif
 #if defined(USE_SERIAL)
   Serial.print("setLcdIndicator: "); 
@@ -210,18 +302,30 @@ int setLcdIndicator (int c)
   return 0;
 }
 
+// show a free form message on the second line of the LCD after the indicator.
+int setLcdMessage (const char *pMsg)
+{
+  char cBuff[16]= {0};
+
+  snprintf (cBuff, sizeof(cBuff), "%-15.15s", pMsg);
+#if defined(USE_LCD)
+  lcdShadowPrint(1, 1, cBuff);    // beginning at column 1, line 1 (after the indicator on second line)
+#endif
+#if defined(USE_SERIAL)
+  Serial.print("setLcdMessage: "); 
+  Serial.println(cBuff);
+#endif
+  return 0;
+}
+
 int updateLCDInfo (void)
 {
     char cBuff[32] = {0};
 
-     if (iUnits == English)
-      sprintf (cBuff, lcdInfoFmt[specInUse], lb1, lb2, "LB", s1, s2);
-    else
-      sprintf (cBuff, lcdInfoFmt[specInUse], lb1, lb2, "KG", s1, s2);
+    buildLcdInfo (cBuff);
           
 #if defined(USE_LCD)
-    lcd.setCursor(1,0);
-    lcd.print(cBuff);
+    lcdShadowPrint(1, 0, cBuff);
 #endif
 #if defined(USE_SERIAL)
     Serial.println(cBuff);
@@ -234,8 +338,13 @@ void handleKeyPad ()
   char customKey = customKeypad.getKey();
   
   if (customKey){
+    // any key may change the scale measurement data so have the response
+    // frames rebuilt before the next request.
+    scaleDataChanged();
+
     switch (customKey) {
     case '*':     // clear key to restart the data entry sequence
+        scaleTrajectoryStart(0, millis());    // stop a trajectory so the weight entered stays
         lbNdx = 0;        // set the weight entry state indicator to allow input
         stNdx = 0;        // set the stNdx state indicator indicating weight entry
         lb1 = lb2 = 0;
@@ -272,6 +381,15 @@ void handleKeyPad ()
         lbNdx = 100;        // set the weight entry state indicator to ignore input
         updateLCDInfo();
         setLcdIndicator('R');
+        {
+          char cBuff[32];
+
+          // number of commands received, number thrown away as too long, and the
+          // longest time through loop() in microseconds since the last D key.
+          snprintf (cBuff, sizeof(cBuff), "c%u o%u L%lu", cmdFramer.frameCount(), cmdFramer.overflowCount(), loopMaxMicros);
+          setLcdMessage (cBuff);
+          loopMaxMicros = 0;
+        }
         break;
     case '0':
         if (stNdx == 100) {
@@ -310,6 +428,14 @@ void handleKeyPad ()
     case '7':
     case '8':
     case '9':
+        if (stNdx == 100 && customKey >= '2' && customKey <= '5') {
+          // C followed by 2 to 5 starts trajectory 1 to 4
+          scaleTrajectoryStart(customKey - '1', millis());
+          stNdx = 0;
+          lbNdx = 100;
+          setLcdIndicator('T');
+          break;
+        }
         if (stNdx) {
           // if status byte change or spec change was requested then just ignore this
           stNdx = 0;
@@ -319,49 +445,35 @@ void handleKeyPad ()
           break;
         }
 
-        if (lbNdx < specInUseFmt[specInUse].maxMsp) {
+        if (lbNdx < specMaxMsp(specInUse)) {
           lb1 *= 10;
           lb1 += customKey - '0';
-        } else if (lbNdx < specInUseFmt[specInUse].maxMsp + specInUseFmt[specInUse].maxLsp) {
+        } else if (lbNdx < specMaxMsp(specInUse) + specMaxLsp(specInUse)) {
           lb2 *= 10;
           lb2 += customKey - '0';
          }
         lbNdx++;
-        if (lbNdx == specInUseFmt[specInUse].maxMsp + specInUseFmt[specInUse].maxLsp) {
+        if (lbNdx == specMaxMsp(specInUse) + specMaxLsp(specInUse)) {
           updateLCDInfo();
           setLcdIndicator('R');
         }
         break;  
     }
+
+    bDefaultsChanged = true;
+    ulLastActivity = millis();
   }
 }
 #endif    // defined(USE_KEYPAD)
 
-void handle_command(String &inCommand) {
-    char cBuff[64];
+void handle_command(const char *inCommand) {
+    int  nLength;
 
-    switch (inCommand[0]) {
-      case 'W':    // weight command
-      case 'w':
-        {
-          if (iUnits == English)
-            sprintf (cBuff, specInUseFmt[specInUse].specWeight, lb1, lb2, "LB", s1, s2);
-          else
-            sprintf (cBuff, specInUseFmt[specInUse].specWeight, lb1, lb2, "KG", s1, s2);
-        }
-        break;
-      case 'S':    // status command
-      case 's':
-      case 'Z':    // zero scale command (zeros scale but response is same as status command)
-      case 'z':
-        sprintf (cBuff, specInUseFmt[specInUse].specStatus, s1, s2);
-        break;
-      default:     // unrecognized command
-        sprintf (cBuff, "\n?\r\x03");
-        break;
-    }
+    // the response is ready-built so just send it. see updateResponseFrames().
+    const char *pFrame = getResponseFrame (inCommand, &nLength);
     
-    Serial.print(cBuff);
+    Serial.write(pFrame, nLength);
+    ulLastActivity = millis();
 }
 
 void setup() {
@@ -370,30 +482,169 @@ void setup() {
 
   delay (1000);
 
+  config.begin();
+  loadScaleDefaults();
+
+#if defined(USE_LCD)
+  lcdShadowClear();
+#endif
   updateLCDInfo();
   setLcdIndicator('R');
  
 }
 
-void loop() {
-   // put your main code here, to run repeatedly:
+// the work of the simulator is done by the tasks of a cooperative task runtime, see
+// libraries/TaskRuntime. the Serial port is checked by a task with a period of 0, on
+// every pass of loop(), and the other tasks are kept short so that a request never waits
+// long. a request should be seen within 2 msec, the deadline of the commands task.
+#include <TaskRuntime.h>
+
+// a test rig sets the scale measurement data and the baud rate with the frames of the
+// binary control channel, see libraries/SimFramer/SimControl.h, which share the Serial
+// port with the commands. the data set by the test rig is not saved in the configuration
+// store since a sweep of thousands of settings would wear out the EEPROM.
+#include <SimControl.h>
+
+SimControl     simControl;
+uint8_t        controlPayload[SIMCTL_PAYLOAD_MAX];
+unsigned long  controlLastMillis = 0;     // millis() of the last byte of a control frame
 
+void sendControlReply (uint8_t uchCommand, uint8_t uchStatus, const uint8_t *pData, uint8_t nData)
+{
+  uint8_t  auchReply[SIMCTL_PAYLOAD_MAX];
+  uint8_t  auchFrame[SIMCTL_FRAME_MAX];
+
+  auchReply[0] = uchCommand | SIMCTL_REPLY;
+  auchReply[1] = uchStatus;
+  memcpy (auchReply + 2, pData, nData);
+  Serial.write (auchFrame, SimControl::encode (auchFrame, auchReply, nData + 2));
+}
+
+void handleControl (const uint8_t *pPayload, int nLength)
+{
+  uint8_t  auchData[SCALE_DATA_SIZE];
+  uint32_t ulBaud;
+
+  if (nLength == SIMCTL_BAD_FRAME) {
+    sendControlReply (0, SimCtlBadFrame, 0, 0);
+    return;
+  }
+
+  switch (pPayload[0]) {
+    case SCALE_CTL_SET:
+      if (nLength != 1 + SCALE_DATA_SIZE) {
+        sendControlReply (pPayload[0], SimCtlBadLength, 0, 0);
+      } else if (!scaleSetData (pPayload + 1)) {
+        sendControlReply (pPayload[0], SimCtlBadValue, 0, 0);
+      } else {
+        scaleTrajectoryStart (0, millis ());    // the data set stays until the next is set
+        updateLCDInfo ();
+        sendControlReply (pPayload[0], SimCtlOk, 0, 0);
+      }
+      break;
+    case SCALE_CTL_GET:
+      if (nLength != 1) {
+        sendControlReply (pPayload[0], SimCtlBadLength, 0, 0);
+      } else {
+        scaleGetData (auchData);
+        sendControlReply (pPayload[0], SimCtlOk, auchData, sizeof(auchData));
+      }
+      break;
+    case SCALE_CTL_MOTION:
+      if (nLength != 2) {
+        sendControlReply (pPayload[0], SimCtlBadLength, 0, 0);
+      } else if (!scaleTrajectoryStart (pPayload[1], millis ())) {
+        sendControlReply (pPayload[0], SimCtlBadValue, 0, 0);
+      } else {
+        sendControlReply (pPayload[0], SimCtlOk, 0, 0);
+      }
+      break;
+    case SIMCTL_CMD_BAUD:
+      if (nLength != 5) {
+        sendControlReply (pPayload[0], SimCtlBadLength, 0, 0);
+        break;
+      }
+      ulBaud = pPayload[1] | ((uint32_t)pPayload[2] << 8) | ((uint32_t)pPayload[3] << 16) | ((uint32_t)pPayload[4] << 24);
+      if (!simControlBaud (ulBaud)) {
+        sendControlReply (pPayload[0], SimCtlBadValue, 0, 0);
+        break;
+      }
+      // the reply goes out at the old rate, flush() waits until it has been sent.
+      sendControlReply (pPayload[0], SimCtlOk, 0, 0);
+      Serial.flush ();
+      Serial.begin (ulBaud);
+      break;
+    default:
+      sendControlReply (pPayload[0], SimCtlUnknown, 0, 0);
+      break;
+  }
+}
+
+// take everything the Serial port has received, sorting the bytes into the commands of
+// the terminal and the control frames of a test rig, and handle each command as soon as its
+// terminator arrives. the receive buffer of the Serial port holds more than the ring buffer
+// of cmdFramer so a burst of pipelined commands would overflow it if they were all taken first.
+void TaskCommands (void)
+{
+   // throw away a control frame cut short before the next bytes are taken as part of it.
+   if (simControl.busy() && millis() - controlLastMillis >= SIMCTL_IDLE_MSEC) {
+      simControl.reset();
+   }
+
+   while (Serial.available() > 0) {
+      uint8_t  c = (uint8_t)Serial.read();
+      int      nLength;
+
+      if (!simControl.putByte(c)) {
+         cmdFramer.putByte(c);
+         if (cmdFramer.getFrame(cmdBuffer, sizeof(cmdBuffer)) >= 0) {
+            handle_command(cmdBuffer);
+         }
+         continue;
+      }
+      controlLastMillis = millis();
+      nLength = simControl.getFrame(controlPayload);
+      if (nLength != SIMCTL_NO_FRAME) {
+         // answer the commands which came before the frame first so the replies are in order.
+         while (cmdFramer.getFrame(cmdBuffer, sizeof(cmdBuffer)) >= 0) {
+            handle_command(cmdBuffer);
+         }
+         handleControl(controlPayload, nLength);
+      }
+   }
+   while (cmdFramer.getFrame(cmdBuffer, sizeof(cmdBuffer)) >= 0) {
+      handle_command(cmdBuffer);
+   }
+}
+
+// move the weight along the trajectory, if one is running. a 10 msec step is finer than
+// the fastest a point of sale terminal polls the scale.
+void TaskMotion (void)
+{
+   if (scaleTrajectoryUpdate(millis())) updateLCDInfo();
+}
+
+Task  tasks[] = {
+   // name       function        period msec       deadline usec
+   { "commands", TaskCommands,   0,                2000 },
+   { "motion",   TaskMotion,     10,               0 },
 #if defined(USE_KEYPAD)
-   handleKeyPad();
+   { "keypad",   handleKeyPad,   keypadScanMsec,   0 },
+   { "save",     TaskSave,       500,              0 },      // write the defaults when idle
 #endif
-  
-   // setup as non-blocking code
-   incoming = Serial.read();
-   if(incoming < 255) {
-         if(incoming == '\n' || incoming == '\r' || incoming == '\x03') {  // newline, carriage return, both, or custom character
-            // handle the incoming command
-            handle_command(inBuffer);
-
-            // Clear the string for the next command
-            inBuffer = "";
-        } else{
-            // add the character to the buffer
-            inBuffer += (char)incoming;
-        }
-    }
+#if defined(USE_LCD)
+   { "lcd",      serviceLcd,     0,                0 },      // write at most one character to the LCD
+#endif
+};
+
+TaskRuntime  taskRuntime (tasks, sizeof(tasks) / sizeof(tasks[0]));
+
+void loop() {
+   // put your main code here, to run repeatedly:
+   unsigned long  loopStart = micros();
+
+   taskRuntime.run();
+
+   unsigned long  loopMicros = micros() - loopStart;
+   if (loopMicros > loopMaxMicros) loopMaxMicros = loopMicros;
 }
@@ -0,0 +1,151 @@
+// ControlSweep.cpp : sweep of scale settings through the binary control channel of the simulator.
+//
+// See ControlSweep.h for a description.
+
+#include "ControlSweep.h"
+#include "ScaleParser.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../libraries/SimFramer/SimControl.h"
+
+// the commands of the scale simulator, SCALE_CTL_SET and SCALE_CTL_GET of scalecore.h, which
+// can't be included along with ScaleParser.h since both declare a ScaleUnits.
+#define SWEEP_CTL_SET       0x01
+#define SWEEP_DATA_SIZE     8
+
+// the digits before and after the decimal point of SCP-01 and SCP-02.
+static const int  aiMaxMsp[2] = { 4, 2 };
+static const int  aiMaxLsp[2] = { 2, 3 };
+
+static long Pow10(int n)
+{
+    long  l = 1;
+    while (n-- > 0) l *= 10;
+    return l;
+}
+
+// send a control frame and wait for its reply. the bytes of anything else which arrives are
+// thrown away. returns the status of the reply or -1 if there was no reply.
+static int ControlSweepCommand(HANDLE hPort, SerialReader& reader, const uint8_t* pPayload, uint8_t nLength, int iTimeoutMsec)
+{
+    uint8_t     auchFrame[SIMCTL_FRAME_MAX];
+    uint8_t     auchReply[SIMCTL_PAYLOAD_MAX];
+    SimControl  decoder;
+    ComFrame    frame;
+
+    PifWriteCom(hPort, auchFrame, SimControl::encode(auchFrame, pPayload, nLength));
+    while (reader.WaitFrame(frame, iTimeoutMsec)) {
+        for (int i = 0; i < frame.usLength; i++) {
+            decoder.putByte((uint8_t)frame.auchData[i]);
+            int  nReply = decoder.getFrame(auchReply);
+            if (nReply >= 2 && auchReply[0] == (pPayload[0] | SIMCTL_REPLY)) return auchReply[1];
+            if (nReply != SIMCTL_NO_FRAME) return SimCtlBadFrame;
+        }
+    }
+    return -1;
+}
+
+bool ControlSweepRun(HANDLE hPort, SerialReader& reader, const ControlSweepOptions& options, ControlSweepResults& results)
+{
+    ScaleParser  parser;
+    SimControl   decoder;
+    ComFrame     frame;
+
+    results = ControlSweepResults();
+
+    if (options.ulBaud) {
+        uint8_t  auchBaud[5] = { SIMCTL_CMD_BAUD, (uint8_t)options.ulBaud, (uint8_t)(options.ulBaud >> 8),
+            (uint8_t)(options.ulBaud >> 16), (uint8_t)(options.ulBaud >> 24) };
+        int  iStatus = ControlSweepCommand(hPort, reader, auchBaud, sizeof(auchBaud), options.iTimeoutMsec);
+
+        if (iStatus != SimCtlOk) {
+            printf("ERROR: simulator did not change to %lu baud, status %d\n", options.ulBaud, iStatus);
+            return false;
+        }
+        if (PifSetComBaud(hPort, options.ulBaud) != PIF_OK) {
+            printf("ERROR: port can not be set to %lu baud\n", options.ulBaud);
+            return false;
+        }
+    }
+
+    srand(1);
+    long long  llStart = SerialReaderMicros();
+
+    for (long l = 0; l < options.lCount; l++) {
+        // the specification and units alternate and the low nibbles of the status bytes count
+        // up so that every combination of them is seen, each with a random weight.
+        int  iSpec = (int)(l & 1);
+        int  iUnits = (int)((l >> 1) & 1);
+        uint8_t  uchS1 = (uint8_t)(0x30 | ((l >> 2) & 0x0f));
+        uint8_t  uchS2 = (uint8_t)(0x30 | ((l >> 6) & 0x0f));
+        long  lLb1 = rand() % Pow10(aiMaxMsp[iSpec]);
+        long  lLb2 = rand() % Pow10(aiMaxLsp[iSpec]);
+
+        uint8_t  auchPayload[1 + SWEEP_DATA_SIZE] = { SWEEP_CTL_SET, (uint8_t)lLb1, (uint8_t)(lLb1 >> 8),
+            (uint8_t)lLb2, (uint8_t)(lLb2 >> 8), uchS1, uchS2, (uint8_t)iUnits, (uint8_t)iSpec };
+        uint8_t  auchRequest[SIMCTL_FRAME_MAX + 2];
+        uint8_t  nRequest = SimControl::encode(auchRequest, auchPayload, sizeof(auchPayload));
+
+        // throw away anything left from a setting which timed out.
+        while (reader.TryFrame(frame)) ;
+        parser.Reset();
+        decoder.reset();
+
+        auchRequest[nRequest++] = 'W';
+        auchRequest[nRequest++] = '\r';
+        PifWriteCom(hPort, auchRequest, nRequest);
+        results.ulSent++;
+
+        // the reply to the frame and then the weight response.
+        int   iStatus = -1;
+        bool  bRecord = false;
+        ScaleRecord  record;
+
+        while (!bRecord && reader.WaitFrame(frame, options.iTimeoutMsec)) {
+            for (int i = 0; i < frame.usLength && !bRecord; i++) {
+                uint8_t  c = (uint8_t)frame.auchData[i];
+                uint8_t  auchReply[SIMCTL_PAYLOAD_MAX];
+
+                if (!decoder.putByte(c)) {
+                    bRecord = parser.PutByte((char)c, record);
+                    continue;
+                }
+                int  nReply = decoder.getFrame(auchReply);
+                if (nReply >= 2) iStatus = (auchReply[0] == (SWEEP_CTL_SET | SIMCTL_REPLY)) ? (int)auchReply[1] : (int)SimCtlBadFrame;
+                else if (nReply == SIMCTL_BAD_FRAME) iStatus = SimCtlBadFrame;
+            }
+        }
+
+        if (!bRecord || iStatus < 0) {
+            results.ulTimeouts++;
+        }
+        else if (iStatus != SimCtlOk) {
+            results.ulRejected++;
+        }
+        else if (record.iType == SCALE_RECORD_WEIGHT && record.bScp02 == (iSpec == 1)
+            && record.lWeight == lLb1 * Pow10(aiMaxLsp[iSpec]) + lLb2 && record.iDecimals == aiMaxLsp[iSpec]
+            && record.iUnits == (iUnits ? SCALE_UNITS_KG : SCALE_UNITS_LB)
+            && record.st.iError == 0 && record.st.s1 == uchS1 && record.st.s2 == uchS2) {
+            results.ulGood++;
+        }
+        else {
+            results.ulMismatches++;
+        }
+    }
+
+    results.llElapsedUsec = SerialReaderMicros() - llStart;
+    return true;
+}
+
+void ControlSweepReport(const char* pszTitle, const ControlSweepResults& results)
+{
+    double  dMinutes = results.llElapsedUsec / 60000000.0;
+
+    printf("%s: %lu settings in %.2f sec, %.0f settings/min\n", pszTitle, results.ulSent,
+        results.llElapsedUsec / 1000000.0, dMinutes > 0 ? results.ulSent / dMinutes : 0.0);
+    printf("  good %lu  rejected %lu  mismatches %lu  timeouts %lu\n", results.ulGood, results.ulRejected,
+        results.ulMismatches, results.ulTimeouts);
+    fflush(stdout);
+}
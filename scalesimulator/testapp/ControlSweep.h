@@ -0,0 +1,41 @@
+// ControlSweep.h : sweep of scale settings through the binary control channel of the simulator.
+//
+// A test rig sets the weight, units, status bytes, and specification of the scale simulator
+// with the control frames of libraries/SimFramer/SimControl.h rather than the keypad. The
+// sweep goes through a given number of settings and for each one sends the frame which sets
+// it followed by a W request in one write, then checks that the frame was accepted and that
+// the weight response, parsed by the ScaleParser, has the weight, units, status bytes, and
+// format of the specification which were set. The simulator answers the commands and the
+// frames in the order they were received so the reply to the frame always comes before the
+// weight response, and since the weight response ends with an ETX the SerialReader hands the
+// bytes over as soon as they arrive.
+//
+// The frames use 8 bit bytes so the port must be opened with 8 data bits and no parity. The
+// sweep can first tell the simulator to change to a faster baud rate and then change the
+// port to the same rate with PifSetComBaud().
+
+#pragma once
+
+#include "PifCom.h"
+#include "SerialReader.h"
+
+struct ControlSweepOptions {
+    long    lCount;             // number of settings to go through
+    ULONG   ulBaud;             // baud rate to change the simulator and the port to first, 0 to keep the rate
+    int     iTimeoutMsec;       // time to wait for the replies to a setting
+};
+
+struct ControlSweepResults {
+    unsigned long  ulSent;          // settings sent
+    unsigned long  ulGood;          // settings accepted and seen in the weight response
+    unsigned long  ulRejected;      // frames answered with a status other than SimCtlOk
+    unsigned long  ulMismatches;    // weight responses which were not the setting sent
+    unsigned long  ulTimeouts;
+    long long      llElapsedUsec;
+};
+
+// change the baud rate if asked and run the sweep on an open port whose reader thread has been
+// started. returns false if the change of baud rate failed.
+bool ControlSweepRun(HANDLE hPort, SerialReader& reader, const ControlSweepOptions& options, ControlSweepResults& results);
+
+void ControlSweepReport(const char* pszTitle, const ControlSweepResults& results);
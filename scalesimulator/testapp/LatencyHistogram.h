@@ -0,0 +1,102 @@
+// LatencyHistogram.h : HDR style histogram of round trip times in microseconds.
+//
+// Times below 64 microseconds each have their own bucket. Above that each power of two
+// range is divided into 32 buckets so a time is recorded with a precision of about 3%
+// whatever its size, from microseconds to minutes, in a fixed 928 bucket array. Recording
+// a time is a few shifts and an increment so it doesn't disturb the measurement.
+//
+// Percentiles are reported as the highest time that falls in the bucket so a reported
+// p99 is never less than the true p99.
+
+#pragma once
+
+#include <string.h>
+
+#define LATENCY_SUB_BITS      5                           // 32 buckets per power of two
+#define LATENCY_SUB_COUNT     (1 << LATENCY_SUB_BITS)
+#define LATENCY_LINEAR_MAX    (2 * LATENCY_SUB_COUNT)      // times below this have a bucket each
+#define LATENCY_BUCKETS       (LATENCY_LINEAR_MAX + 27 * LATENCY_SUB_COUNT)
+
+class LatencyHistogram {
+public:
+    LatencyHistogram() { Reset(); }
+
+    void Reset()
+    {
+        memset(aulCounts, 0, sizeof(aulCounts));
+        ulCount = 0;
+        llMin = -1;
+        llMax = 0;
+        llTotal = 0;
+    }
+
+    void Record(long long llUsec)
+    {
+        if (llUsec < 0) llUsec = 0;
+        aulCounts[BucketIndex(llUsec)]++;
+        ulCount++;
+        llTotal += llUsec;
+        if (llMin < 0 || llUsec < llMin) llMin = llUsec;
+        if (llUsec > llMax) llMax = llUsec;
+    }
+
+    // add the counts of another histogram, used to combine the results of several ports.
+    void Add(const LatencyHistogram& other)
+    {
+        for (int i = 0; i < LATENCY_BUCKETS; i++) aulCounts[i] += other.aulCounts[i];
+        ulCount += other.ulCount;
+        llTotal += other.llTotal;
+        if (other.ulCount && (llMin < 0 || other.llMin < llMin)) llMin = other.llMin;
+        if (other.llMax > llMax) llMax = other.llMax;
+    }
+
+    // the time which dPercent percent of the recorded times are less than or equal to.
+    long long Percentile(double dPercent) const
+    {
+        unsigned long  ulTarget = (unsigned long)(dPercent / 100.0 * ulCount + 0.5);
+        unsigned long  ulSeen = 0;
+
+        if (ulTarget < 1) ulTarget = 1;
+        for (int i = 0; i < LATENCY_BUCKETS; i++) {
+            ulSeen += aulCounts[i];
+            if (ulSeen >= ulTarget) {
+                long long llHigh = BucketHighest(i);
+                return llHigh < llMax ? llHigh : llMax;
+            }
+        }
+        return llMax;
+    }
+
+    unsigned long Count() const { return ulCount; }
+    long long Min() const { return llMin < 0 ? 0 : llMin; }
+    long long Max() const { return llMax; }
+    long long Mean() const { return ulCount ? llTotal / (long long)ulCount : 0; }
+
+private:
+    static int BucketIndex(long long llUsec)
+    {
+        if (llUsec < LATENCY_LINEAR_MAX) return (int)llUsec;
+
+        int  iShift = 0;
+        while ((llUsec >> iShift) >= LATENCY_LINEAR_MAX) iShift++;
+        // llUsec >> iShift is now in the range 32 to 63 and iShift is at least 1.
+        int  iNdex = LATENCY_LINEAR_MAX + (iShift - 1) * LATENCY_SUB_COUNT + (int)((llUsec >> iShift) - LATENCY_SUB_COUNT);
+        if (iNdex >= LATENCY_BUCKETS) iNdex = LATENCY_BUCKETS - 1;
+        return iNdex;
+    }
+
+    static long long BucketHighest(int iNdex)
+    {
+        if (iNdex < LATENCY_LINEAR_MAX) return iNdex;
+
+        int  iShift = (iNdex - LATENCY_LINEAR_MAX) / LATENCY_SUB_COUNT + 1;
+        long long  llSub = (iNdex - LATENCY_LINEAR_MAX) % LATENCY_SUB_COUNT + LATENCY_SUB_COUNT;
+        return ((llSub + 1) << iShift) - 1;
+    }
+
+    unsigned long  aulCounts[LATENCY_BUCKETS];
+    unsigned long  ulCount;
+    long long      llMin;
+    long long      llMax;
+    long long      llTotal;
+};
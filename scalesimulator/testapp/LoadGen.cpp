@@ -0,0 +1,135 @@
+// LoadGen.cpp : non-interactive load generator for the scale protocol.
+//
+// See LoadGen.h for a description.
+
+#include "LoadGen.h"
+#include "ScaleParser.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <thread>
+
+void LoadGenDefaults(LoadGenOptions& options)
+{
+    memset(&options, 0, sizeof(options));
+    strcpy(options.aszMix, "w");
+    options.dRate = 0;
+    options.dDuration = 10;
+    options.lCount = 0;
+    options.iTimeoutMsec = 2000;
+}
+
+bool LoadGenMixTable(const char* pszMix, char aszTable[100])
+{
+    char  achLetter[16];
+    int   aiWeight[16];
+    int   nLetters = 0, iTotal = 0;
+
+    while (*pszMix) {
+        char c = (char)toupper((unsigned char)*pszMix++);
+        if ((c != 'W' && c != 'S' && c != 'Z') || nLetters >= 16) return false;
+
+        int  iWeight = 0;
+        while (isdigit((unsigned char)*pszMix)) iWeight = iWeight * 10 + (*pszMix++ - '0');
+        if (iWeight == 0) iWeight = 1;
+
+        achLetter[nLetters] = c;
+        aiWeight[nLetters++] = iWeight;
+        iTotal += iWeight;
+    }
+    if (nLetters == 0) return false;
+
+    // each letter gets a share of the table in proportion to its weight.
+    int  iNdex = 0, iSum = 0;
+    for (int i = 0; i < nLetters; i++) {
+        iSum += aiWeight[i];
+        int  iEnd = iSum * 100 / iTotal;
+        while (iNdex < iEnd) aszTable[iNdex++] = achLetter[i];
+    }
+    while (iNdex < 100) aszTable[iNdex++] = achLetter[nLetters - 1];
+    return true;
+}
+
+bool LoadGenRun(HANDLE hPort, SerialReader& reader, const LoadGenOptions& options, LoadGenResults& results)
+{
+    char  aszTable[100];
+    ScaleParser  parser;
+    ComFrame  frame;
+
+    results = LoadGenResults();
+    if (!LoadGenMixTable(options.aszMix, aszTable)) return false;
+
+    srand(1);
+    long long  llStart = SerialReaderMicros();
+    long long  llNext = llStart;
+    long long  llPeriod = options.dRate > 0 ? (long long)(1000000.0 / options.dRate) : 0;
+    long long  llDuration = (long long)(options.dDuration * 1000000.0);
+
+    while (1) {
+        long long  llNow = SerialReaderMicros();
+        if (llDuration > 0 && llNow - llStart >= llDuration) break;
+        if (options.lCount > 0 && results.ulSent >= (unsigned long)options.lCount) break;
+
+        long long  llScheduled = llNow;
+        if (llPeriod) {
+            if (llNow < llNext) {
+                std::this_thread::sleep_for(std::chrono::microseconds(llNext - llNow));
+            }
+            llScheduled = llNext;
+            llNext += llPeriod;
+        }
+
+        // throw away a response which arrived after its request timed out.
+        while (reader.TryFrame(frame)) ;
+
+        char  achRequest[2] = { aszTable[rand() % 100], '\r' };
+        switch (achRequest[0]) {
+        case 'W':  results.aulSent[0]++; break;
+        case 'S':  results.aulSent[1]++; break;
+        case 'Z':  results.aulSent[2]++; break;
+        }
+        if (!llPeriod) llScheduled = SerialReaderMicros();
+        PifWriteCom(hPort, achRequest, 2);
+        results.ulSent++;
+
+        if (!reader.WaitFrame(frame, options.iTimeoutMsec)) {
+            results.ulTimeouts++;
+            parser.Reset();
+            continue;
+        }
+
+        ScaleRecord  record;
+        int  nRecords = parser.Parse(frame.auchData, frame.usLength, &record, 1);
+        ScaleRecordType  iExpected = (achRequest[0] == 'W') ? SCALE_RECORD_WEIGHT : SCALE_RECORD_STATUS;
+        if (nRecords == 1 && record.iType == iExpected) {
+            results.ulGood++;
+            results.histogram.Record(frame.llTimeUsec - llScheduled);
+        }
+        else {
+            results.ulParseErrors++;
+            parser.Reset();
+        }
+    }
+
+    results.llElapsedUsec = SerialReaderMicros() - llStart;
+    return true;
+}
+
+void LoadGenReport(const char* pszTitle, const LoadGenResults& results)
+{
+    double  dSeconds = results.llElapsedUsec / 1000000.0;
+    const LatencyHistogram&  h = results.histogram;
+
+    printf("%s: %lu requests (W %lu, S %lu, Z %lu) in %.2f sec, %.1f requests/sec\n", pszTitle,
+        results.ulSent, results.aulSent[0], results.aulSent[1], results.aulSent[2],
+        dSeconds, dSeconds > 0 ? results.ulSent / dSeconds : 0.0);
+    printf("  good %lu  timeouts %lu  parse errors %lu\n", results.ulGood, results.ulTimeouts, results.ulParseErrors);
+    if (h.Count()) {
+        printf("  round trip usec  min %lld  p50 %lld  p99 %lld  p99.9 %lld  max %lld  mean %lld\n",
+            h.Min(), h.Percentile(50), h.Percentile(99), h.Percentile(99.9), h.Max(), h.Mean());
+    }
+    fflush(stdout);
+}
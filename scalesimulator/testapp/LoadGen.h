@@ -0,0 +1,53 @@
+// LoadGen.h : non-interactive load generator for the scale protocol.
+//
+// Sends a mix of W, S, and Z requests to a port at a given rate for a given time and
+// records the round trip time of each request in a LatencyHistogram. At the end the
+// p50, p99, and p99.9 round trip times are reported along with the number of requests
+// that timed out or whose response could not be parsed or was the wrong kind.
+//
+// When a rate is given, requests are scheduled at fixed intervals and the round trip is
+// measured from the time the request was scheduled to be sent rather than the time it
+// was actually sent. Otherwise a slow response delays the following requests and the
+// delay they suffer is never counted, making the scale look better than it is.
+
+#pragma once
+
+#include "PifCom.h"
+#include "SerialReader.h"
+#include "LatencyHistogram.h"
+
+struct LoadGenOptions {
+    char    aszMix[16];         // request mix, letter and weight pairs such as w8s1z1
+    double  dRate;              // requests per second, 0 to send each request as soon as the last response arrives
+    double  dDuration;          // seconds to run
+    long    lCount;             // stop after this many requests if not 0
+    int     iTimeoutMsec;       // time to wait for a response
+};
+
+struct LoadGenResults {
+    LatencyHistogram  histogram;    // round trip times of the good responses
+    unsigned long  ulSent;
+    unsigned long  ulGood;
+    unsigned long  ulTimeouts;
+    unsigned long  ulParseErrors;   // response malformed or not the kind expected for the request
+    unsigned long  aulSent[3];      // requests sent of each kind, W, S, and Z
+    long long      llElapsedUsec;
+};
+
+void LoadGenDefaults(LoadGenOptions& options);
+
+// check the mix and turn it into a table of 100 request letters. returns false if the
+// mix contains anything other than w, s, and z letters each followed by an optional weight.
+bool LoadGenMixTable(const char* pszMix, char aszTable[100]);
+
+// run the load on an open port whose reader thread has been started.
+bool LoadGenRun(HANDLE hPort, SerialReader& reader, const LoadGenOptions& options, LoadGenResults& results);
+
+// run the load on several open ports at once from one event loop with no reader threads,
+// see LoadGenMulti.cpp. the results of each port are put into aResults.
+bool LoadGenRunMulti(HANDLE* ahPorts, int nPorts, const LoadGenOptions& options, LoadGenResults* aResults);
+
+// add the results of one port to a total for all ports.
+void LoadGenAdd(LoadGenResults& total, const LoadGenResults& results);
+
+void LoadGenReport(const char* pszTitle, const LoadGenResults& results);
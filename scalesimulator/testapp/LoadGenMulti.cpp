@@ -0,0 +1,246 @@
+// LoadGenMulti.cpp : load generator for many ports on one event loop.
+//
+// LoadGenRun() uses a SerialReader thread for its port. A lane bank has dozens of scales
+// so rather than a thread per port, LoadGenRunMulti() waits on every port at once, with
+// epoll on Linux and an I/O completion port on Windows, and each port is a small state
+// machine: idle until its next request is due, then waiting for the response or the
+// timeout. The bytes read from a port go to the ScaleParser of that port.
+
+#include "LoadGen.h"
+#include "PifTrace.h"
+#include "ScaleParser.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+struct LoadGenPort {
+    HANDLE       hPort;
+    ScaleParser  parser;
+    bool         bWaiting;          // a request has been sent and its response not received
+    char         chRequest;         // the request letter sent, W, S, or Z
+    long long    llScheduled;       // time the request was due to be sent
+    long long    llNext;            // time the next request is due
+    long long    llDeadline;        // time the response times out
+#if defined(_WIN32)
+    OVERLAPPED   ov;                // the read outstanding on the port
+    char         auchRead[64];
+#endif
+};
+
+static void LoadGenSend(LoadGenPort& port, LoadGenResults& results, const char aszTable[100],
+    const LoadGenOptions& options, long long llPeriod, long long llNow)
+{
+    port.chRequest = aszTable[rand() % 100];
+    switch (port.chRequest) {
+    case 'W':  results.aulSent[0]++; break;
+    case 'S':  results.aulSent[1]++; break;
+    case 'Z':  results.aulSent[2]++; break;
+    }
+
+    // with a rate the round trip is measured from when the request was due, see LoadGen.h.
+    port.llScheduled = llPeriod ? port.llNext : llNow;
+    port.llNext = llPeriod ? port.llNext + llPeriod : llNow;
+    port.llDeadline = llNow + options.iTimeoutMsec * 1000LL;
+    port.bWaiting = true;
+    results.ulSent++;
+
+    char  achRequest[2] = { port.chRequest, '\r' };
+#if defined(_WIN32)
+    // the port is attached to the completion port so the write has its own event with
+    // the low bit set, which keeps its completion from being queued to the completion port.
+    OVERLAPPED  ov = { 0 };
+    DWORD  dwWritten = 0;
+    HANDLE  hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    ov.hEvent = (HANDLE)((ULONG_PTR)hEvent | 1);
+    PifTraceData(port.hPort, PIF_TRACE_WRITE, achRequest, 2);
+    if (!WriteFile(port.hPort, achRequest, 2, &dwWritten, &ov) && GetLastError() == ERROR_IO_PENDING) {
+        GetOverlappedResult(port.hPort, &ov, &dwWritten, TRUE);
+    }
+    CloseHandle(hEvent);
+#else
+    PifWriteCom(port.hPort, achRequest, 2);
+#endif
+}
+
+// give the bytes read from a port to its parser and complete the request on a response.
+static void LoadGenReceive(LoadGenPort& port, LoadGenResults& results, const char* pData, int nBytes, long long llNow)
+{
+    // the ports are read directly rather than with PifReadCom() so trace the bytes here.
+    PifTraceData(port.hPort, PIF_TRACE_READ, pData, (USHORT)nBytes);
+
+    while (nBytes > 0) {
+        ScaleRecord  record;
+        int  nUsed = 0;
+        int  nRecords = port.parser.Parse(pData, nBytes, &record, 1, &nUsed);
+
+        pData += nUsed;
+        nBytes -= nUsed;
+        if (nRecords == 0) break;
+        if (!port.bWaiting) continue;       // a late response to a request that timed out
+
+        ScaleRecordType  iExpected = (port.chRequest == 'W') ? SCALE_RECORD_WEIGHT : SCALE_RECORD_STATUS;
+        if (record.iType == iExpected) {
+            results.ulGood++;
+            results.histogram.Record(llNow - port.llScheduled);
+        }
+        else {
+            results.ulParseErrors++;
+        }
+        port.bWaiting = false;
+    }
+}
+
+bool LoadGenRunMulti(HANDLE* ahPorts, int nPorts, const LoadGenOptions& options, LoadGenResults* aResults)
+{
+    char  aszTable[100];
+
+    if (nPorts < 1 || !LoadGenMixTable(options.aszMix, aszTable)) return false;
+
+    LoadGenPort*  aPorts = new LoadGenPort[nPorts];
+    long long  llPeriod = options.dRate > 0 ? (long long)(1000000.0 / options.dRate) : 0;
+    long long  llDuration = (long long)(options.dDuration * 1000000.0);
+    long long  llStart = SerialReaderMicros();
+
+    srand(1);
+    for (int i = 0; i < nPorts; i++) {
+        aResults[i] = LoadGenResults();
+        aPorts[i].hPort = ahPorts[i];
+        aPorts[i].bWaiting = false;
+        // spread the first requests of the ports over one period so they are not all sent at once.
+        aPorts[i].llNext = llStart + (llPeriod * i) / nPorts;
+    }
+
+#if defined(_WIN32)
+    HANDLE  hIocp = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    COMMTIMEOUTS  comTimer = { 0 };
+
+    // a read completes as soon as any data arrives, or after a second with no data.
+    comTimer.ReadIntervalTimeout = MAXDWORD;
+    comTimer.ReadTotalTimeoutMultiplier = MAXDWORD;
+    comTimer.ReadTotalTimeoutConstant = 1000;
+    for (int i = 0; i < nPorts; i++) {
+        SetCommTimeouts(aPorts[i].hPort, &comTimer);
+        CreateIoCompletionPort(aPorts[i].hPort, hIocp, (ULONG_PTR)i, 0);
+        memset(&aPorts[i].ov, 0, sizeof(aPorts[i].ov));
+        ReadFile(aPorts[i].hPort, aPorts[i].auchRead, sizeof(aPorts[i].auchRead), NULL, &aPorts[i].ov);
+    }
+#else
+    int  fdEpoll = epoll_create1(0);
+    for (int i = 0; i < nPorts; i++) {
+        struct epoll_event  ev = { 0 };
+        ev.events = EPOLLIN;
+        ev.data.u32 = (uint32_t)i;
+        epoll_ctl(fdEpoll, EPOLL_CTL_ADD, PIF_HANDLE_TO_FD(aPorts[i].hPort), &ev);
+    }
+#endif
+
+    while (1) {
+        long long  llNow = SerialReaderMicros();
+        bool  bDone = (llDuration > 0 && llNow - llStart >= llDuration);
+        bool  bWaiting = false;
+
+        // send the requests that are due and time out the responses that are overdue. the
+        // time until the next of these events is how long to wait for data.
+        long long  llWake = llNow + 1000000;
+        for (int i = 0; i < nPorts; i++) {
+            LoadGenPort&  port = aPorts[i];
+
+            if (port.bWaiting && llNow >= port.llDeadline) {
+                aResults[i].ulTimeouts++;
+                port.bWaiting = false;
+                port.parser.Reset();
+            }
+            if (!port.bWaiting && !bDone && (options.lCount == 0 || aResults[i].ulSent < (unsigned long)options.lCount)
+                && llNow >= port.llNext) {
+                LoadGenSend(port, aResults[i], aszTable, options, llPeriod, llNow);
+            }
+
+            if (port.bWaiting) {
+                bWaiting = true;
+                if (port.llDeadline < llWake) llWake = port.llDeadline;
+            }
+            else if (!bDone && (options.lCount == 0 || aResults[i].ulSent < (unsigned long)options.lCount)) {
+                bWaiting = true;
+                if (port.llNext < llWake) llWake = port.llNext;
+            }
+        }
+        if (!bWaiting) break;
+
+        if (llDuration > 0 && !bDone && llStart + llDuration < llWake) llWake = llStart + llDuration;
+
+        // the wait is in milliseconds so round down and poll for the last fraction of a
+        // millisecond, otherwise requests are sent up to a millisecond late.
+        int  iWaitMsec = (int)((llWake - llNow) / 1000);
+        if (iWaitMsec < 0) iWaitMsec = 0;
+
+#if defined(_WIN32)
+        DWORD  dwBytes = 0;
+        ULONG_PTR  ulKey = 0;
+        OVERLAPPED*  pov = NULL;
+
+        // take all of the completed reads before going back to the timers.
+        for (DWORD dwWait = (DWORD)iWaitMsec; ; dwWait = 0) {
+            BOOL  fResult = GetQueuedCompletionStatus(hIocp, &dwBytes, &ulKey, &pov, dwWait);
+            if (pov == NULL) break;
+
+            LoadGenPort&  port = aPorts[ulKey];
+            if (fResult && dwBytes > 0) {
+                LoadGenReceive(port, aResults[ulKey], port.auchRead, (int)dwBytes, SerialReaderMicros());
+            }
+            memset(&port.ov, 0, sizeof(port.ov));
+            ReadFile(port.hPort, port.auchRead, sizeof(port.auchRead), NULL, &port.ov);
+        }
+#else
+        struct epoll_event  aEvents[64];
+        int  nEvents = epoll_wait(fdEpoll, aEvents, 64, iWaitMsec);
+        if (nEvents < 0 && errno != EINTR) break;
+
+        for (int e = 0; e < nEvents; e++) {
+            int  i = (int)aEvents[e].data.u32;
+            char  auchRead[256];
+            ssize_t  nRead;
+
+            // the ports are non-blocking so read until there is nothing left.
+            while ((nRead = read(PIF_HANDLE_TO_FD(aPorts[i].hPort), auchRead, sizeof(auchRead))) > 0) {
+                LoadGenReceive(aPorts[i], aResults[i], auchRead, (int)nRead, SerialReaderMicros());
+            }
+        }
+#endif
+    }
+
+    long long  llElapsed = SerialReaderMicros() - llStart;
+    for (int i = 0; i < nPorts; i++) {
+        aResults[i].llElapsedUsec = llElapsed;
+    }
+
+#if defined(_WIN32)
+    // cancel the outstanding reads and wait for them so the OVERLAPPED structs can be freed.
+    for (int i = 0; i < nPorts; i++) {
+        DWORD  dwBytes;
+        CancelIoEx(aPorts[i].hPort, &aPorts[i].ov);
+        GetOverlappedResult(aPorts[i].hPort, &aPorts[i].ov, &dwBytes, TRUE);
+    }
+    CloseHandle(hIocp);
+#else
+    close(fdEpoll);
+#endif
+    delete[] aPorts;
+    return true;
+}
+
+void LoadGenAdd(LoadGenResults& total, const LoadGenResults& results)
+{
+    total.histogram.Add(results.histogram);
+    total.ulSent += results.ulSent;
+    total.ulGood += results.ulGood;
+    total.ulTimeouts += results.ulTimeouts;
+    total.ulParseErrors += results.ulParseErrors;
+    for (int i = 0; i < 3; i++) total.aulSent[i] += results.aulSent[i];
+    if (results.llElapsedUsec > total.llElapsedUsec) total.llElapsedUsec = results.llElapsedUsec;
+}
@@ -0,0 +1,122 @@
+// PifCom.h : serial communications port interface (Pif) used by the SerialConsole.
+//
+// The Pif functions provide a small portability layer over the operating system
+// serial port API. There are two implementations:
+//   - PifComWin32.cpp  uses the Win32 API (CreateFile(), SetCommState(), etc.)
+//   - PifComPosix.cpp  uses POSIX termios on Linux and similar systems
+//
+// Both implementations use the same PROTOCOL struct to describe the baud rate,
+// the byte format and the handshake to use so that the console application
+// does not need to know which implementation is being used.
+
+#pragma once
+
+#if defined(_WIN32)
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <windows.h>
+
+#else
+#include <stdint.h>
+#include <stdio.h>
+
+// provide the Windows types used by the Pif interface so that the
+// same declarations can be used with both implementations.
+typedef short           SHORT;
+typedef unsigned short  USHORT;
+typedef unsigned char   UCHAR;
+typedef unsigned long   ULONG;
+typedef void            VOID;
+typedef void *          HANDLE;
+
+#define CONST   const
+
+#define INVALID_HANDLE_VALUE    ((HANDLE)(intptr_t)-1)
+
+// a POSIX file descriptor is carried in a HANDLE so that the
+// error codes below, which are negative values, can be returned.
+#define PIF_FD_TO_HANDLE(fd)    ((HANDLE)(intptr_t)(fd))
+#define PIF_HANDLE_TO_FD(h)     ((int)(intptr_t)(h))
+
+#define sprintf_s   snprintf
+#endif
+
+#define PIF_OK  1
+
+#define PIF_ERROR_SYSTEM                (HANDLE)(-1)
+
+#define PIF_ERROR_FILE_EXIST            (HANDLE)(-5)
+#define PIF_ERROR_FILE_EOF              (HANDLE)(-6)
+#define PIF_ERROR_FILE_DISK_FULL        (HANDLE)(-7)
+#define PIF_ERROR_FILE_NOT_FOUND        (HANDLE)(-8)
+
+#define PIF_ERROR_COM_POWER_FAILURE     (HANDLE)(-2)
+#define PIF_ERROR_COM_TIMEOUT           (HANDLE)(-3)
+#define PIF_ERROR_COM_NOT_PROVIDED      (HANDLE)(-4)
+#define PIF_ERROR_COM_BUSY              (HANDLE)(-5)
+#define PIF_ERROR_COM_EOF               (HANDLE)(-6)
+#define PIF_ERROR_COM_ABORTED           (HANDLE)(-9)
+#define PIF_ERROR_COM_ACCESS_DENIED     (HANDLE)(-10)      // same as PIF_ERROR_NET_ACCESS_DENIED
+#define PIF_ERROR_COM_ERRORS            (HANDLE)(-10)      // same as PIF_ERROR_NET_ERRORS
+#define PIF_ERROR_COM_OFFLINE           (HANDLE)(-13)
+#define PIF_ERROR_COM_LOOT_TEST         (HANDLE)(-55)
+#define PIF_ERROR_COM_NO_DSR_AND_CTS    (HANDLE)(-57)
+#define PIF_ERROR_COM_NO_CTS            (HANDLE)(-59)
+#define PIF_ERROR_COM_NO_DSR            (HANDLE)(-60)
+#define PIF_ERROR_COM_OVERRUN           (HANDLE)(-62)
+#define PIF_ERROR_COM_FRAMING           (HANDLE)(-63)
+#define PIF_ERROR_COM_PARITY            (HANDLE)(-64)
+#define PIF_ERROR_COM_MONITOR           (HANDLE)(-66)
+#define PIF_ERROR_COM_BUFFER_OVERFLOW   (HANDLE)(-150)
+#define PIF_ERROR_COM_NO_INTERRUPT      (HANDLE)(-151)
+#define PIF_ERROR_COM_TIMEOUT_M_L       (HANDLE)(-162)
+#define PIF_ERROR_COM_COMM_M_L          (HANDLE)(-163)
+
+#define COM_BYTE_ODD_PARITY     0x08
+#define COM_BYTE_EVEN_PARITY    0x18
+#define COM_BYTE_2_STOP_BITS    0x04
+#define COM_BYTE_7_BITS_DATA    0x02
+#define COM_BYTE_8_BITS_DATA    0x03
+
+// for device config option for handshake with serial connections JHHJ 9-13-05
+#define COM_BYTE_HANDSHAKE_NONE		0x01
+#define COM_BYTE_HANDSHAKE_RTSCTS	0x02
+#define COM_BYTE_HANDSHAKE_CTS		0x04
+#define COM_BYTE_HANDSHAKE_RTS		0x08
+#define COM_BYTE_HANDSHAKE_XONOFF	0x10
+#define COM_BYTE_HANDSHAKE_DTRDSR	0x20
+
+typedef struct {
+    SHORT   fPip;
+    USHORT  usPipAddr;
+    ULONG   ulComBaud;
+    UCHAR   uchComByteFormat;
+    UCHAR   uchComTextFormat;
+    UCHAR   auchComNonEndChar[4];
+    UCHAR   auchComEndChar[3];
+    UCHAR   uchComDLEChar;
+    UCHAR   auchComHandShakePro;
+} PROTOCOL;
+
+
+HANDLE  PifOpenCom(USHORT usPortId, CONST PROTOCOL* pProtocol);
+SHORT   PifReadCom(HANDLE  hHandle, void * pBuffer, USHORT usBytes);
+SHORT   PifWriteCom(HANDLE  hHandle, const void * pBuffer, USHORT usBytes);
+VOID    PifCloseCom(HANDLE  hHandle);
+
+// change the baud rate of an open port, such as after telling a simulator to change its
+// baud rate with the control channel, without closing the port. closing and opening the
+// port again would drop DTR which resets an Arduino Uno back to its startup baud rate.
+SHORT   PifSetComBaud(HANDLE  hHandle, ULONG ulBaud);
+
+#if !defined(_WIN32)
+// POSIX only. open a serial device by its path such as /dev/ttyACM0
+// rather than by port number. PifOpenCom() uses /dev/ttyS<n>.
+HANDLE  PifOpenComPath(const char *pszPath, CONST PROTOCOL* pProtocol);
+
+// POSIX only. open a pseudo-terminal pair. the master side is returned in
+// *phMaster and is used by the console like any other port. the slave side
+// is returned in *phSlave, configured per pProtocol, and is used by an
+// in-process simulator so that no hardware is needed.
+SHORT   PifOpenPtyPair(CONST PROTOCOL* pProtocol, HANDLE *phMaster, HANDLE *phSlave);
+#endif
@@ -0,0 +1,441 @@
+// PifComPosix.cpp : POSIX termios implementation of the Pif serial communications interface.
+//
+// See PifCom.h for the interface description and PifComWin32.cpp for the
+// Win32 implementation. This implementation follows the Win32 version as
+// closely as termios allows so that the console behaves the same on both.
+//
+// The Win32 version uses COMMTIMEOUTS to limit how long a ReadFile() or WriteFile()
+// will wait. termios has only VMIN and VTIME which can not express the total
+// timeout so the same timeouts are implemented here with poll().
+
+#include "PifCom.h"
+#include "PifTrace.h"
+
+#if !defined(_WIN32)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+// same values as the COMMTIMEOUTS used by PifOpenCom() in PifComWin32.cpp
+#define PIF_READ_INTERVAL_MSEC      250     // ReadIntervalTimeout
+#define PIF_READ_MULTIPLIER_MSEC    10      // ReadTotalTimeoutMultiplier
+#define PIF_READ_CONSTANT_MSEC      2000    // ReadTotalTimeoutConstant
+#define PIF_WRITE_CONSTANT_MSEC     1000    // WriteTotalTimeoutConstant
+
+static long PifSubGetTickMsec(void)
+{
+    struct timespec  ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+// translate an errno value into one of the PIF_ERROR_COM_ error codes.
+static SHORT PifSubGetErrorCode(int iErrno)
+{
+    switch (iErrno) {
+    case ENOENT:
+    case ENXIO:
+    case ENODEV:
+    case EACCES:
+    case EPERM:
+    case EBUSY:
+        // the port does not exist, probably a USB serial device which was either
+        // unplugged or turned off, or the port is in use by some other application.
+        return (SHORT)(intptr_t)PIF_ERROR_COM_ACCESS_DENIED;
+    case EIO:
+        return (SHORT)(intptr_t)PIF_ERROR_COM_OFFLINE;
+    case EAGAIN:
+    case ETIMEDOUT:
+        return (SHORT)(intptr_t)PIF_ERROR_COM_TIMEOUT;
+    case EINTR:
+        return (SHORT)(intptr_t)PIF_ERROR_COM_ABORTED;
+    default:
+        return (SHORT)(intptr_t)PIF_ERROR_COM_ERRORS;
+    }
+}
+
+static speed_t PifSubBaudToSpeed(ULONG ulBaud)
+{
+    switch (ulBaud) {
+    case 300:    return B300;
+    case 1200:   return B1200;
+    case 2400:   return B2400;
+    case 4800:   return B4800;
+    case 9600:   return B9600;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+#if defined(B115200)
+    case 115200: return B115200;
+#endif
+#if defined(B230400)
+    case 230400: return B230400;
+#endif
+#if defined(B460800)
+    case 460800: return B460800;
+#endif
+#if defined(B500000)
+    case 500000: return B500000;
+#endif
+#if defined(B921600)
+    case 921600: return B921600;
+#endif
+#if defined(B1000000)
+    case 1000000: return B1000000;
+#endif
+    default:     return B0;
+    }
+}
+
+// set up the termios of a port as described by the PROTOCOL struct.
+// this is the equivalent of the DCB setup done by PifOpenCom() with Win32.
+static int PifSubSetTermios(int fd, CONST PROTOCOL* pProtocol)
+{
+    struct termios  tios;
+    speed_t         speed;
+
+    speed = PifSubBaudToSpeed(pProtocol->ulComBaud);
+    if (speed == B0) {
+        return -1;
+    }
+
+    if (tcgetattr(fd, &tios) < 0) {
+        return -1;
+    }
+
+    // raw mode, no line editing, no echo, and no translation of CR to LF
+    // since the scale protocol uses both as message characters.
+    tios.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON | IXOFF | IXANY);
+    tios.c_oflag &= ~OPOST;
+    tios.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+    tios.c_cflag &= ~(CSIZE | PARENB | PARODD | CSTOPB | CRTSCTS);
+    tios.c_cflag |= CREAD | CLOCAL;
+
+    if ((pProtocol->uchComByteFormat & (COM_BYTE_7_BITS_DATA | COM_BYTE_8_BITS_DATA)) == COM_BYTE_7_BITS_DATA) {
+        tios.c_cflag |= CS7;
+    }
+    else {
+        tios.c_cflag |= CS8;
+    }
+    if ((pProtocol->uchComByteFormat & COM_BYTE_2_STOP_BITS) == COM_BYTE_2_STOP_BITS) {
+        tios.c_cflag |= CSTOPB;
+    }
+    if ((pProtocol->uchComByteFormat & (COM_BYTE_ODD_PARITY | COM_BYTE_EVEN_PARITY)) == COM_BYTE_EVEN_PARITY) {
+        tios.c_cflag |= PARENB;
+        tios.c_iflag |= INPCK;
+    }
+    else if ((pProtocol->uchComByteFormat & (COM_BYTE_ODD_PARITY | COM_BYTE_EVEN_PARITY)) == COM_BYTE_ODD_PARITY) {
+        tios.c_cflag |= PARENB | PARODD;
+        tios.c_iflag |= INPCK;
+    }
+    else {
+        tios.c_iflag &= ~INPCK;
+    }
+
+    // the handshake is checked in the same order as with Win32 so that
+    // the same PROTOCOL results in the same flow control with both.
+    // termios has fewer choices than the DCB so the closest is used.
+    if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_XONOFF) {
+        tios.c_iflag |= IXON | IXOFF;       // XON/XOFF out and in flow control
+        tios.c_cc[VSTART] = 0x11;           // ASCII/ANSI value 17
+        tios.c_cc[VSTOP] = 0x13;            // ASCII/ANSI value 19
+    }
+    else if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_RTSCTS) {
+        tios.c_cflag |= CRTSCTS;            // RTS and CTS flow control
+    }
+    else if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_RTS) {
+#if defined(CRTS_IFLOW)
+        tios.c_cflag |= CRTS_IFLOW;         // RTS input flow control only
+#else
+        tios.c_cflag |= CRTSCTS;            // Linux has RTS only as part of RTS/CTS
+#endif
+    }
+    else if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_CTS) {
+#if defined(CCTS_OFLOW)
+        tios.c_cflag |= CCTS_OFLOW;         // CTS output flow control only
+#else
+        tios.c_cflag |= CRTSCTS;            // Linux has CTS only as part of RTS/CTS
+#endif
+    }
+    else if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_DTRDSR) {
+#if defined(CDTR_IFLOW) && defined(CDSR_OFLOW)
+        tios.c_cflag |= CDTR_IFLOW | CDSR_OFLOW;
+#else
+        // Linux does not provide DTR/DSR flow control. DTR is raised below
+        // which is what most devices wired for DTR/DSR need to send.
+#endif
+    }
+
+    tios.c_cc[VMIN] = 0;        // reads are paced with poll() so never block in read()
+    tios.c_cc[VTIME] = 0;
+
+    cfsetispeed(&tios, speed);
+    cfsetospeed(&tios, speed);
+
+    if (tcsetattr(fd, TCSANOW, &tios) < 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+HANDLE   PifOpenCom(USHORT usPortId, CONST PROTOCOL* pProtocol)
+{
+    char    szPortName[32] = { 0 };
+
+    // COMn with Windows is the equivalent of /dev/ttyS<n>. USB serial devices
+    // such as an Arduino are /dev/ttyACM<n> or /dev/ttyUSB<n> so use PifOpenComPath().
+    snprintf(szPortName, sizeof(szPortName), "/dev/ttyS%d", usPortId);
+
+    return PifOpenComPath(szPortName, pProtocol);
+}
+
+HANDLE  PifOpenComPath(const char *pszPath, CONST PROTOCOL* pProtocol)
+{
+    int     fd;
+    int     iModemBits;
+
+    if (pProtocol->ulComBaud == 0) {
+        return PIF_ERROR_COM_ERRORS;
+    }
+
+    fd = open(pszPath, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        return (HANDLE)(intptr_t)PifSubGetErrorCode(errno);
+    }
+
+    if (PifSubSetTermios(fd, pProtocol) < 0) {
+        close(fd);
+        return PIF_ERROR_COM_ERRORS;
+    }
+
+    /* purge the receive and transmit buffers */
+    tcflush(fd, TCIOFLUSH);
+
+    /* send the DTR (data-terminal-ready) and RTS (request-to-send) signals. */
+    /* a pseudo-terminal does not have modem lines so ignore any failure. */
+    iModemBits = TIOCM_DTR | TIOCM_RTS;
+    ioctl(fd, TIOCMBIS, &iModemBits);
+
+    return PIF_FD_TO_HANDLE(fd);
+}
+
+SHORT   PifOpenPtyPair(CONST PROTOCOL* pProtocol, HANDLE *phMaster, HANDLE *phSlave)
+{
+    int     fdMaster, fdSlave;
+    char   *pszSlave;
+
+    *phMaster = *phSlave = INVALID_HANDLE_VALUE;
+
+    fdMaster = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fdMaster < 0) {
+        return PifSubGetErrorCode(errno);
+    }
+
+    if (grantpt(fdMaster) < 0 || unlockpt(fdMaster) < 0 || (pszSlave = ptsname(fdMaster)) == NULL) {
+        SHORT  sErrorCode = PifSubGetErrorCode(errno);
+        close(fdMaster);
+        return sErrorCode;
+    }
+
+    fdSlave = open(pszSlave, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fdSlave < 0) {
+        SHORT  sErrorCode = PifSubGetErrorCode(errno);
+        close(fdMaster);
+        return sErrorCode;
+    }
+
+    // the line discipline is on the slave side of the pair so the slave has
+    // the termios settings. the master is then a plain byte stream.
+    if (PifSubSetTermios(fdSlave, pProtocol) < 0) {
+        close(fdSlave);
+        close(fdMaster);
+        return (SHORT)(intptr_t)PIF_ERROR_COM_ERRORS;
+    }
+
+    fcntl(fdMaster, F_SETFL, fcntl(fdMaster, F_GETFL) | O_NONBLOCK);
+
+    *phMaster = PIF_FD_TO_HANDLE(fdMaster);
+    *phSlave = PIF_FD_TO_HANDLE(fdSlave);
+    return PIF_OK;
+}
+
+/*fhfh
+**********************************************************************
+**                                                                  **
+**  Synopsis:   SHORT PIFENTRY PifReadCom(USHORT usPort           **
+**                                          VOID FAR *pBuffer       **
+**                                          USHORT usBytes)          **
+**              usFile:         com handle                         **
+**              pBuffer:        reading buffer                      **
+**              usBytes:        sizeof pBuffer                      **
+**                                                                  **
+**  return:     number of bytes to be read                          **
+**                                                                  **
+**  Description:reading from serial i/o port                        **
+**                                                                  **
+**********************************************************************
+fhfh*/
+SHORT  PifReadCom(HANDLE  hHandle, void * pBuffer, USHORT usBytes)
+{
+    int     fd = PIF_HANDLE_TO_FD(hHandle);
+    UCHAR  *puchBuffer = (UCHAR *)pBuffer;
+    USHORT  usBytesRead = 0;
+    long    lTotalEnd = PifSubGetTickMsec() + PIF_READ_CONSTANT_MSEC + PIF_READ_MULTIPLIER_MSEC * (long)usBytes;
+
+    // wait for the first byte for the total timeout and then for each byte after
+    // for the interval timeout, the same as ReadFile() with the COMMTIMEOUTS.
+    while (usBytesRead < usBytes) {
+        struct pollfd  pfd = { fd, POLLIN, 0 };
+        long    lNow = PifSubGetTickMsec();
+        long    lWait = lTotalEnd - lNow;
+        int     iRet;
+        ssize_t nRead;
+
+        if (usBytesRead > 0 && lWait > PIF_READ_INTERVAL_MSEC) lWait = PIF_READ_INTERVAL_MSEC;
+        if (lWait <= 0) break;
+
+        iRet = poll(&pfd, 1, (int)lWait);
+        if (iRet < 0) {
+            if (errno == EINTR) continue;
+            return PifSubGetErrorCode(errno);
+        }
+        if (iRet == 0) break;     // timeout
+
+        nRead = read(fd, puchBuffer + usBytesRead, usBytes - usBytesRead);
+        if (nRead < 0) {
+            if (errno == EAGAIN || errno == EINTR) continue;
+            return PifSubGetErrorCode(errno);
+        }
+        if (nRead == 0) {
+            PifTraceData(hHandle, PIF_TRACE_READ, pBuffer, usBytesRead);
+            return (usBytesRead) ? (SHORT)usBytesRead : (SHORT)(intptr_t)PIF_ERROR_COM_EOF;
+        }
+        usBytesRead += (USHORT)nRead;
+    }
+
+    if (!usBytesRead) return (SHORT)(intptr_t)PIF_ERROR_COM_TIMEOUT;
+    PifTraceData(hHandle, PIF_TRACE_READ, pBuffer, usBytesRead);
+    return (SHORT)usBytesRead;
+}
+
+/*fhfh
+**********************************************************************
+**                                                                  **
+**  Synopsis:   SHORT PIFENTRY PifWriteCom(USHORT usPort           **
+**                                          VOID FAR *pBuffer       **
+**                                          USHORT usBytes)          **
+**              usFile:         com handle                         **
+**              pBuffer:        reading buffer                      **
+**              usBytes:        sizeof pBuffer                      **
+**                                                                  **
+**  return:     number of bytes to be written                       **
+**                                                                  **
+**  Description:writing to serial i/o port                          **
+**                                                                  **
+**********************************************************************
+fhfh*/
+SHORT  PifWriteCom(HANDLE  hHandle, const void * pBuffer,
+    USHORT usBytes)
+{
+    int     fd = PIF_HANDLE_TO_FD(hHandle);
+    const UCHAR  *puchBuffer = (const UCHAR *)pBuffer;
+    USHORT  usBytesWritten = 0;
+    long    lTotalEnd = PifSubGetTickMsec() + PIF_WRITE_CONSTANT_MSEC;
+
+    // traced before the write, the response may be read and traced by another thread
+    // before the write returns.
+    PifTraceData(hHandle, PIF_TRACE_WRITE, pBuffer, usBytes);
+    while (usBytesWritten < usBytes) {
+        ssize_t nWritten = write(fd, puchBuffer + usBytesWritten, usBytes - usBytesWritten);
+
+        if (nWritten < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                struct pollfd  pfd = { fd, POLLOUT, 0 };
+                long    lWait = lTotalEnd - PifSubGetTickMsec();
+
+                if (lWait <= 0 || poll(&pfd, 1, (int)lWait) == 0) break;   // timeout
+                continue;
+            }
+            return PifSubGetErrorCode(errno);
+        }
+        usBytesWritten += (USHORT)nWritten;
+    }
+
+    if ((usBytes != usBytesWritten) && (usBytesWritten == 0)) {
+        tcflush(fd, TCOFLUSH);
+        return (SHORT)(intptr_t)PIF_ERROR_COM_TIMEOUT;
+    }
+    return (SHORT)usBytesWritten;
+}
+
+
+/*fhfh
+**********************************************************************
+**                                                                  **
+**  Synopsis:   SHORT PIFENTRY PifSetComBaud(HANDLE hHandle       **
+**                                            ULONG ulBaud)         **
+**              hHandle:        com handle                         **
+**              ulBaud:         new baud rate                       **
+**                                                                  **
+**  return:     PIF_OK or an error code                             **
+**                                                                  **
+**  Description:changing the baud rate of an open serial i/o port   **
+**                                                                  **
+**********************************************************************
+fhfh*/
+SHORT  PifSetComBaud(HANDLE  hHandle, ULONG ulBaud)
+{
+    int     fd = PIF_HANDLE_TO_FD(hHandle);
+    struct termios  tios;
+    speed_t         speed;
+
+    speed = PifSubBaudToSpeed(ulBaud);
+    if (speed == B0) {
+        return (SHORT)(intptr_t)PIF_ERROR_COM_ERRORS;
+    }
+    if (tcgetattr(fd, &tios) < 0) {
+        return PifSubGetErrorCode(errno);
+    }
+
+    cfsetispeed(&tios, speed);
+    cfsetospeed(&tios, speed);
+
+    // let anything written at the old rate go out first.
+    if (tcsetattr(fd, TCSADRAIN, &tios) < 0) {
+        return PifSubGetErrorCode(errno);
+    }
+    return PIF_OK;
+}
+
+/*fhfh
+**********************************************************************
+**                                                                  **
+**  Synopsis:   VOID PIFENTRY PifCloseCom(USHORT usPort)           **
+**              usPort:         com handle                         **
+**                                                                  **
+**  return:     none                                                **
+**                                                                  **
+**  Description:closing serial i/o                                  **
+**                                                                  **
+**********************************************************************
+fhfh*/
+VOID   PifCloseCom(HANDLE  hHandle)
+{
+    if (hHandle != INVALID_HANDLE_VALUE && PIF_HANDLE_TO_FD(hHandle) >= 0) {
+        PifTraceDetach(hHandle);
+        close(PIF_HANDLE_TO_FD(hHandle));
+    }
+
+    return;
+}
+
+#endif    // !defined(_WIN32)
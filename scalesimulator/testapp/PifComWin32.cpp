@@ -0,0 +1,440 @@
+// PifComWin32.cpp : Win32 implementation of the Pif serial communications interface.
+//
+// See PifCom.h for the interface description and PifComPosix.cpp for the
+// POSIX termios implementation.
+
+#include "PifCom.h"
+#include "PifTrace.h"
+
+#if defined(_WIN32)
+
+// translate the GetLastError() of a failed ReadFile() or WriteFile() into one of the
+// PIF_ERROR_COM_ error codes. a line error such as a framing error aborts the I/O with
+// ERROR_OPERATION_ABORTED when fAbortOnError is set so ClearCommError() is asked which one
+// it was, which also clears it so the next read or write can go ahead.
+static SHORT PifSubGetErrorCode(HANDLE hHandle, DWORD dwError)
+{
+    DWORD   dwCommErrors = 0;
+
+    switch (dwError) {
+    case ERROR_FILE_NOT_FOUND:
+    case ERROR_INVALID_NAME:
+    case ERROR_ACCESS_DENIED:
+    case ERROR_INVALID_HANDLE:
+        // the port does not exist, probably a Virtual Serial Communications Port from a USB
+        // device which was either unplugged or turned off, or it is in use by some other application.
+        return (SHORT)(intptr_t)PIF_ERROR_COM_ACCESS_DENIED;
+    case ERROR_BAD_COMMAND:
+    case ERROR_DEVICE_NOT_CONNECTED:
+    case ERROR_GEN_FAILURE:
+        // a USB serial device unplugged while the port is open.
+        return (SHORT)(intptr_t)PIF_ERROR_COM_OFFLINE;
+    case ERROR_SEM_TIMEOUT:
+    case WAIT_TIMEOUT:
+        return (SHORT)(intptr_t)PIF_ERROR_COM_TIMEOUT;
+    case ERROR_OPERATION_ABORTED:
+        if (ClearCommError(hHandle, &dwCommErrors, NULL)) {
+            if (dwCommErrors & (CE_OVERRUN | CE_RXOVER)) return (SHORT)(intptr_t)PIF_ERROR_COM_OVERRUN;
+            if (dwCommErrors & CE_FRAME) return (SHORT)(intptr_t)PIF_ERROR_COM_FRAMING;
+            if (dwCommErrors & CE_RXPARITY) return (SHORT)(intptr_t)PIF_ERROR_COM_PARITY;
+        }
+        return (SHORT)(intptr_t)PIF_ERROR_COM_ABORTED;
+    default:
+        return (SHORT)(intptr_t)PIF_ERROR_COM_ERRORS;
+    }
+}
+
+HANDLE   PifOpenCom(USHORT usPortId, CONST PROTOCOL* pProtocol)
+{
+    TCHAR   wszPortName[16] = { 0 };
+    HANDLE  hHandle;
+    DWORD dwError;
+    DCB dcb = { 0 };
+    COMMTIMEOUTS comTimer = { 0 };
+    DWORD   dwCommMasks;
+    DWORD   dwBaudRate;                 // baud rate
+    DWORD   nCharBits, nMultiple;
+    BYTE    bByteSize;                  // number of bits/byte, 4-8
+    BYTE    bParity;                    // 0-4 = no, odd, even, mark, space
+    BYTE    bStopBits;                  // 0,1,2 = 1, 1.5, 2
+    BOOL    fResult;
+
+    // see Microsoft document HOWTO: Specify Serial Ports Larger than COM9.
+    // https://support.microsoft.com/en-us/kb/115831
+    // CreateFile() can be used to get a handle to a serial port. The "Win32 Programmer's Reference" entry for "CreateFile()"
+    // mentions that the share mode must be 0, the create parameter must be OPEN_EXISTING, and the template must be NULL. 
+    //
+    // CreateFile() is successful when you use "COM1" through "COM9" for the name of the file;
+    // however, the value INVALID_HANDLE_VALUE is returned if you use "COM10" or greater. 
+    //
+    // If the name of the port is \\.\COM10, the correct way to specify the serial port in a call to
+    // CreateFile() is "\\\\.\\COM10".
+    //
+    // NOTES: This syntax also works for ports COM1 through COM9. Certain boards will let you choose
+    //        the port names yourself. This syntax works for those names as well.
+    wsprintf(wszPortName, TEXT("\\\\.\\COM%d"), usPortId);
+
+    /* Open the serial port. */
+    /* avoid to failuer of CreateFile */
+//    for (i = 0; i < 10; i++) {
+    do {
+        hHandle = CreateFile(wszPortName, /* Pointer to the name of the port, PifOpenCom() */
+            GENERIC_READ | GENERIC_WRITE,  /* Access (read-write) mode */
+            0,            /* Share mode */
+            NULL,         /* Pointer to the security attribute */
+            OPEN_EXISTING,/* How to open the serial port */
+            FILE_FLAG_OVERLAPPED,  /* Port attributes, overlapped for the SerialReader thread */
+            NULL);        /* Handle to port with attribute */
+                          /* to copy */
+
+/* If it fails to open the port, return FALSE. */
+        if (hHandle == INVALID_HANDLE_VALUE) {    /* Could not open the port. */
+            dwError = GetLastError();
+            if (dwError == ERROR_FILE_NOT_FOUND || dwError == ERROR_INVALID_NAME || dwError == ERROR_ACCESS_DENIED) {
+                // the COM port does not exist. probably a Virtual Serial Communications Port
+                // from a USB device which was either unplugged or turned off.
+                // or the COM port or Virtual Serial Communications port is in use by some other application.
+                return PIF_ERROR_COM_ACCESS_DENIED;
+            }
+        }
+        else {
+            break;
+        }
+        //   }
+    } while (0);
+    if (hHandle == INVALID_HANDLE_VALUE) {    /* Could not open the port. */
+        return PIF_ERROR_COM_ERRORS;
+    }
+
+    /* clear the error and purge the receive buffer */
+    dwError = (DWORD)(~0);                  // set all error code bits on
+    ClearCommError(hHandle, &dwError, NULL);
+    PurgeComm(hHandle, PURGE_TXABORT | PURGE_RXABORT | PURGE_TXCLEAR | PURGE_RXCLEAR);
+
+
+    /* make up comm. parameters */
+
+    dwBaudRate = pProtocol->ulComBaud;
+    if (dwBaudRate == 0) {
+        CloseHandle(hHandle);
+        return PIF_ERROR_COM_ERRORS;
+    }
+
+    if ((pProtocol->uchComByteFormat & (COM_BYTE_7_BITS_DATA | COM_BYTE_8_BITS_DATA)) == COM_BYTE_7_BITS_DATA) {
+        bByteSize = 7;
+    }
+    else {
+        bByteSize = 8;
+    }
+    if ((pProtocol->uchComByteFormat & COM_BYTE_2_STOP_BITS) == COM_BYTE_2_STOP_BITS) {
+        bStopBits = TWOSTOPBITS;
+    }
+    else {
+        bStopBits = ONESTOPBIT;
+    }
+    if ((pProtocol->uchComByteFormat & (COM_BYTE_ODD_PARITY | COM_BYTE_EVEN_PARITY)) == COM_BYTE_EVEN_PARITY) {
+        bParity = EVENPARITY;
+    }
+    else
+        if ((pProtocol->uchComByteFormat & (COM_BYTE_ODD_PARITY | COM_BYTE_EVEN_PARITY)) == COM_BYTE_ODD_PARITY) {
+            bParity = ODDPARITY;
+        }
+        else {
+            bParity = NOPARITY;
+        }
+
+    /* Get the default port setting information. */
+    GetCommState(hHandle, &dcb);
+
+
+    /* set up no flow control as default */
+
+    dcb.BaudRate = dwBaudRate;              // Current baud 
+    dcb.fBinary = TRUE;               // Binary mode; no EOF check 
+    dcb.fParity = (bParity != NOPARITY);               // Enable parity checking 
+    dcb.ByteSize = bByteSize;                 // Number of bits/byte, 4-8
+    dcb.Parity = bParity;            // 0-4=no,odd,even,mark,space 
+    dcb.StopBits = bStopBits;        // 0,1,2 = 1, 1.5, 2 
+    dcb.fDsrSensitivity = FALSE;      // DSR sensitivity 
+
+    //if ((usFlag & KITCHEN_PORT_FLAG)) {
+//  if (pProtocol->fPip == PIF_COM_PROTOCOL_XON) { //
+    if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_XONOFF)
+    {
+
+        dcb.fOutxCtsFlow = FALSE;         // No CTS output flow control 
+        dcb.fOutxDsrFlow = TRUE;          // No DSR output flow control for 7161
+        dcb.fTXContinueOnXoff = TRUE;                       /* XOFF continues Tx */
+        dcb.fOutX = TRUE;                       /* XON/XOFF out flow control */
+        dcb.fInX = TRUE;                       /* XON/XOFF in flow control */
+        dcb.XonChar = 0x11;	//The default value for this property is the ASCII/ANSI value 17
+        dcb.XoffChar = 0x13;	//The default value for this property is the ASCII/ANSI value 19
+
+    }
+    else
+        /* set up RTS/CTS flow control by option in device configulation*/
+        if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_RTSCTS) {
+
+            dcb.fOutxCtsFlow = TRUE;         // CTS output flow control 
+            dcb.fOutxDsrFlow = FALSE;         // No DSR output flow control 
+            dcb.fTXContinueOnXoff = FALSE;     // XOFF continues Tx heee
+            dcb.fOutX = FALSE;                // No XON/XOFF out flow control 
+            dcb.fInX = FALSE;                 // No XON/XOFF in flow control 
+            dcb.fRtsControl = RTS_CONTROL_HANDSHAKE;
+            dcb.fDsrSensitivity = FALSE;      // DSR sensitivity 
+        }
+        else
+            //Set up RTS flow control by option in device configulation
+            if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_RTS) {
+
+                dcb.fOutxCtsFlow = FALSE;         // no CTS output flow control 
+                dcb.fOutxDsrFlow = FALSE;         // No DSR output flow control 
+                dcb.fTXContinueOnXoff = FALSE;     // XOFF continues Tx 
+                dcb.fOutX = FALSE;                // No XON/XOFF out flow control 
+                dcb.fInX = FALSE;                 // No XON/XOFF in flow control 
+                dcb.fRtsControl = RTS_CONTROL_HANDSHAKE;
+                dcb.fDsrSensitivity = FALSE;      // DSR sensitivity
+            }
+            else
+                //Set up CTS flow control by option in device configulation
+                if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_CTS) {
+
+                    dcb.fOutxCtsFlow = TRUE;         // CTS output flow control 
+                    dcb.fOutxDsrFlow = FALSE;         // No DSR output flow control 
+                    dcb.fTXContinueOnXoff = FALSE;     // XOFF continues Tx 
+                    dcb.fOutX = FALSE;                // No XON/XOFF out flow control 
+                    dcb.fInX = FALSE;                 // No XON/XOFF in flow control 
+                    dcb.fRtsControl = FALSE;
+                    dcb.fDsrSensitivity = FALSE;      // DSR sensitivity
+                }
+                else
+                    //Set up DSR/DTR flow control by option in device configulation
+                    if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_DTRDSR) {
+
+
+                        dcb.fOutxCtsFlow = FALSE;         // CTS output flow control 
+                        dcb.fOutxDsrFlow = TRUE;         // DSR output flow control 
+                        dcb.fDtrControl = DTR_CONTROL_HANDSHAKE; //
+                        dcb.fTXContinueOnXoff = FALSE;     // XOFF continues Tx 
+                        dcb.fOutX = FALSE;                // No XON/XOFF out flow control 
+                        dcb.fInX = FALSE;                 // No XON/XOFF in flow control 
+                        dcb.fRtsControl = FALSE;
+                        dcb.fDsrSensitivity = FALSE;      // DSR sensitivity
+                    }
+
+
+    /* Configure the port according to the specifications of the DCB */
+    /* structure. */
+    fResult = SetCommState(hHandle, &dcb);
+    if (!fResult) {
+        /* Could not create the read thread. */
+        dwError = GetLastError();
+        CloseHandle(hHandle);
+        return PIF_ERROR_COM_ERRORS;
+    }
+
+    /* set up default time out value */
+
+    /* compute no. of bits / data */
+    nCharBits = 1 + bByteSize;
+    nCharBits += (bParity == NOPARITY) ? 0 : 1;
+    nCharBits += (bStopBits == ONESTOPBIT) ? 1 : 2;
+    nMultiple = (2 * CBR_9600 / dwBaudRate);
+
+    fResult = GetCommTimeouts(hHandle, &comTimer);
+    //Windows CE default values are listed next to the variables
+    //These were verified on Windows CE
+    //These default values were different on Windows XP
+    //so set the values to the CE defaults
+    comTimer.ReadIntervalTimeout = 250;         /* 250 default of CE Emulation driver */
+    comTimer.ReadTotalTimeoutMultiplier = 10;          /* 10 default of CE Emulation driver */
+    comTimer.ReadTotalTimeoutConstant = 2000;        /* read within 2000 msec (100 default of CE Emulation driver) */
+    comTimer.WriteTotalTimeoutMultiplier = 0;           /* 0 default of CE Emulation driver */
+    comTimer.WriteTotalTimeoutConstant = 1000;        /* allow 1000 msec to write (0 default of CE Emulation driver) */
+
+    fResult = SetCommTimeouts(hHandle, &comTimer);
+    if (!fResult)
+    {
+        dwError = GetLastError();
+        CloseHandle(hHandle);
+        return PIF_ERROR_COM_ERRORS;
+    }
+
+    /* Direct the port to perform extended functions SETDTR and SETRTS */
+    /* SETDTR: Sends the DTR (data-terminal-ready) signal. */
+    /* SETRTS: Sends the RTS (request-to-send) signal. */
+    EscapeCommFunction(hHandle, SETDTR);
+    EscapeCommFunction(hHandle, SETRTS);
+
+    /* make up comm. event mask */
+    dwCommMasks = EV_CTS | EV_DSR | EV_ERR | EV_RLSD | EV_RXCHAR;
+
+    /* set up comm. event mask */
+    fResult = SetCommMask(hHandle, dwCommMasks);
+    if (!fResult)
+    {
+        dwError = GetLastError();
+        CloseHandle(hHandle);
+        return PIF_ERROR_COM_ERRORS;
+    }
+
+    /* clear the error and purge the receive buffer */
+
+//  dwErrors = (DWORD)(~0);                 // set all error code bits on
+//  fResult  = ClearCommError(hComm, &dwErrors, NULL);
+//  fResult  = PurgeComm(hComm, PURGE_RXABORT | PURGE_RXCLEAR);
+
+
+    return hHandle;
+}
+
+/*fhfh
+**********************************************************************
+**                                                                  **
+**  Synopsis:   SHORT PIFENTRY PifReadCom(USHORT usPort           **
+**                                          VOID FAR *pBuffer       **
+**                                          USHORT usBytes)          **
+**              usFile:         com handle                         **
+**              pBuffer:        reading buffer                      **
+**              usBytes:        sizeof pBuffer                      **
+**                                                                  **
+**  return:     number of bytes to be read                          **
+**                                                                  **
+**  Description:reading from serial i/o port                        **
+**                                                                  **
+**********************************************************************
+fhfh*/
+SHORT  PifReadCom(HANDLE  hHandle, void * pBuffer, USHORT usBytes)
+{
+    DWORD   dwBytesRead;
+    BOOL    fResult;
+    DWORD   dwError;
+
+    OVERLAPPED  ov = { 0 };
+
+    // the port is opened for overlapped I/O so that SerialReader can use it. wait
+    // for the overlapped read to complete so that this function is still synchronous.
+    ov.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    //    fResult = ClearCommError(hHandle, &dwErrors, &stat);
+    fResult = ReadFile(hHandle, pBuffer, (DWORD)usBytes, &dwBytesRead, &ov);
+    if (!fResult && GetLastError() == ERROR_IO_PENDING) {
+        fResult = GetOverlappedResult(hHandle, &ov, &dwBytesRead, TRUE);
+    }
+    dwError = fResult ? 0 : GetLastError();     // before CloseHandle() which may change it
+    CloseHandle(ov.hEvent);
+
+    if (fResult) {
+        if (!dwBytesRead) return (SHORT)PIF_ERROR_COM_TIMEOUT;
+        PifTraceData(hHandle, PIF_TRACE_READ, pBuffer, (USHORT)dwBytesRead);
+        return (SHORT)dwBytesRead;
+    }
+    else {
+        return PifSubGetErrorCode(hHandle, dwError);
+    }
+}
+
+/*fhfh
+**********************************************************************
+**                                                                  **
+**  Synopsis:   SHORT PIFENTRY PifWriteCom(USHORT usPort           **
+**                                          VOID FAR *pBuffer       **
+**                                          USHORT usBytes)          **
+**              usFile:         com handle                         **
+**              pBuffer:        reading buffer                      **
+**              usBytes:        sizeof pBuffer                      **
+**                                                                  **
+**  return:     number of bytes to be written                       **
+**                                                                  **
+**  Description:writing to serial i/o port                          **
+**                                                                  **
+**********************************************************************
+fhfh*/
+SHORT  PifWriteCom(HANDLE  hHandle, const void * pBuffer,
+    USHORT usBytes)
+{
+    DWORD dwBytesWritten;
+    BOOL    fResult;
+    DWORD   dwError;
+
+    OVERLAPPED  ov = { 0 };
+
+    ov.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    // traced before the write, the response may be read and traced by another thread
+    // before the write returns.
+    PifTraceData(hHandle, PIF_TRACE_WRITE, pBuffer, usBytes);
+    fResult = WriteFile(hHandle, pBuffer, (DWORD)usBytes, &dwBytesWritten, &ov);
+    if (!fResult && GetLastError() == ERROR_IO_PENDING) {
+        fResult = GetOverlappedResult(hHandle, &ov, &dwBytesWritten, TRUE);
+    }
+    dwError = fResult ? 0 : GetLastError();     // before CloseHandle() which may change it
+    CloseHandle(ov.hEvent);
+
+    if (fResult) {
+        if ((usBytes != dwBytesWritten) && (dwBytesWritten == 0)) {
+            PurgeComm(hHandle, PURGE_TXCLEAR);
+            return (SHORT)PIF_ERROR_COM_TIMEOUT;
+        }
+        return (SHORT)dwBytesWritten;
+    }
+    else {
+        return PifSubGetErrorCode(hHandle, dwError);
+    }
+}
+
+
+/*fhfh
+**********************************************************************
+**                                                                  **
+**  Synopsis:   SHORT PIFENTRY PifSetComBaud(HANDLE hHandle       **
+**                                            ULONG ulBaud)         **
+**              hHandle:        com handle                         **
+**              ulBaud:         new baud rate                       **
+**                                                                  **
+**  return:     PIF_OK or an error code                             **
+**                                                                  **
+**  Description:changing the baud rate of an open serial i/o port   **
+**                                                                  **
+**********************************************************************
+fhfh*/
+SHORT  PifSetComBaud(HANDLE  hHandle, ULONG ulBaud)
+{
+    DCB     dcb = { 0 };
+
+    dcb.DCBlength = sizeof(dcb);
+    if (ulBaud == 0 || !GetCommState(hHandle, &dcb)) {
+        return (SHORT)PIF_ERROR_COM_ERRORS;
+    }
+
+    dcb.BaudRate = ulBaud;
+    if (!SetCommState(hHandle, &dcb)) {
+        return (SHORT)PIF_ERROR_COM_ERRORS;
+    }
+    return PIF_OK;
+}
+
+/*fhfh
+**********************************************************************
+**                                                                  **
+**  Synopsis:   VOID PIFENTRY PifCloseCom(USHORT usPort)           **
+**              usPort:         com handle                         **
+**                                                                  **
+**  return:     none                                                **
+**                                                                  **
+**  Description:closing serial i/o                                  **
+**                                                                  **
+**********************************************************************
+fhfh*/
+VOID   PifCloseCom(HANDLE  hHandle)
+{
+    BOOL    fReturn;
+    if (hHandle != INVALID_HANDLE_VALUE) {
+        PifTraceDetach(hHandle);
+        fReturn = CloseHandle(hHandle);
+    }
+
+    return;
+}
+
+#endif    // defined(_WIN32)
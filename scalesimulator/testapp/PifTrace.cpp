@@ -0,0 +1,256 @@
+// PifTrace.cpp : timestamped binary trace of the bytes written to and read from the serial ports.
+//
+// See PifTrace.h for a description and the file format.
+
+#include "PifTrace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define PIF_TRACE_MAP_MIN   (1024 * 1024)     // the mapping starts at this size and doubles when full
+
+static const char  achTraceMagic[8] = { 'P', 'I', 'F', 'T', 'R', 'C', '1', 0 };
+
+struct PifTracePort {
+    HANDLE  hHandle;
+    USHORT  usChannel;
+};
+
+static std::mutex         mutexTrace;
+static std::atomic<bool>  bTraceOpen(false);      // checked without the lock so an untraced port costs nothing
+static PifTracePort       aTracePorts[PIF_TRACE_PORTS_MAX];
+static int                nTracePorts = 0;
+static std::chrono::steady_clock::time_point  tTraceStart;
+
+static UCHAR  *puchTraceMap = 0;        // the mapping of the file
+static size_t  ulTraceMapSize = 0;      // size of the file and the mapping
+static size_t  ulTraceUsed = 0;         // bytes of the file used by the header and records
+#if defined(_WIN32)
+static HANDLE  hTraceFile = INVALID_HANDLE_VALUE;
+static HANDLE  hTraceMapping = NULL;
+#else
+static int     fdTrace = -1;
+#endif
+
+static void PifSubPutLe(UCHAR* puch, unsigned long long ullValue, int nBytes)
+{
+    for (int i = 0; i < nBytes; i++, ullValue >>= 8) puch[i] = (UCHAR)ullValue;
+}
+
+static unsigned long long PifSubGetLe(const UCHAR* puch, int nBytes)
+{
+    unsigned long long  ullValue = 0;
+
+    for (int i = nBytes - 1; i >= 0; i--) ullValue = (ullValue << 8) | puch[i];
+    return ullValue;
+}
+
+static void PifSubUnmapTrace(void)
+{
+    if (!puchTraceMap) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(puchTraceMap);
+    CloseHandle(hTraceMapping);
+    hTraceMapping = NULL;
+#else
+    munmap(puchTraceMap, ulTraceMapSize);
+#endif
+    puchTraceMap = 0;
+}
+
+// make the file ulSize bytes and map all of it. the file grows with zeros.
+static bool PifSubMapTrace(size_t ulSize)
+{
+    PifSubUnmapTrace();
+#if defined(_WIN32)
+    hTraceMapping = CreateFileMapping(hTraceFile, NULL, PAGE_READWRITE, (DWORD)((unsigned long long)ulSize >> 32), (DWORD)ulSize, NULL);
+    if (hTraceMapping == NULL) return false;
+    puchTraceMap = (UCHAR*)MapViewOfFile(hTraceMapping, FILE_MAP_WRITE, 0, 0, ulSize);
+    if (!puchTraceMap) {
+        CloseHandle(hTraceMapping);
+        hTraceMapping = NULL;
+        return false;
+    }
+#else
+    if (ftruncate(fdTrace, (off_t)ulSize) < 0) return false;
+    void  *pMap = mmap(0, ulSize, PROT_READ | PROT_WRITE, MAP_SHARED, fdTrace, 0);
+    if (pMap == MAP_FAILED) return false;
+    puchTraceMap = (UCHAR*)pMap;
+#endif
+    ulTraceMapSize = ulSize;
+    return true;
+}
+
+// close the file, cut to the bytes used.
+static void PifSubCloseTraceFile(void)
+{
+    PifSubUnmapTrace();
+#if defined(_WIN32)
+    if (hTraceFile != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER  liUsed;
+        liUsed.QuadPart = (LONGLONG)ulTraceUsed;
+        SetFilePointerEx(hTraceFile, liUsed, NULL, FILE_BEGIN);
+        SetEndOfFile(hTraceFile);
+        CloseHandle(hTraceFile);
+        hTraceFile = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (fdTrace >= 0) {
+        if (ftruncate(fdTrace, (off_t)ulTraceUsed) < 0) {
+            // the file keeps the zeros after the records, which a reader takes as the end.
+        }
+        close(fdTrace);
+        fdTrace = -1;
+    }
+#endif
+    ulTraceMapSize = ulTraceUsed = 0;
+}
+
+// append a record, the lock must be held.
+static void PifSubAppend(USHORT usChannel, UCHAR uchType, const void* pData, USHORT usBytes)
+{
+    size_t  ulNeed = PIF_TRACE_RECORD_SIZE + usBytes;
+
+    if (ulTraceUsed + ulNeed > ulTraceMapSize) {
+        size_t  ulSize = ulTraceMapSize * 2;
+
+        while (ulSize < ulTraceUsed + ulNeed) ulSize *= 2;
+        if (!PifSubMapTrace(ulSize)) {
+            // out of disk or address space, stop the trace rather than fail the port.
+            printf("ERROR: trace file can not grow to %lu bytes, trace stopped\n", (unsigned long)ulSize);
+            bTraceOpen = false;
+            PifSubCloseTraceFile();
+            return;
+        }
+    }
+
+    UCHAR  *puch = puchTraceMap + ulTraceUsed;
+    long long  llUsec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tTraceStart).count();
+
+    PifSubPutLe(puch, (unsigned long long)llUsec, 8);
+    PifSubPutLe(puch + 8, usChannel, 2);
+    puch[11] = 0;
+    PifSubPutLe(puch + 12, usBytes, 2);
+    memcpy(puch + PIF_TRACE_RECORD_SIZE, pData, usBytes);
+    // the type last, a record is not seen by a reader of a file left by a crash until it is whole.
+    puch[10] = uchType;
+    ulTraceUsed += ulNeed;
+}
+
+SHORT   PifTraceOpen(const char* pszPath)
+{
+    std::lock_guard<std::mutex>  lock(mutexTrace);
+
+    if (bTraceOpen) return (SHORT)(intptr_t)PIF_ERROR_COM_BUSY;
+
+#if defined(_WIN32)
+    hTraceFile = CreateFileA(pszPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hTraceFile == INVALID_HANDLE_VALUE) return (SHORT)(intptr_t)PIF_ERROR_COM_ACCESS_DENIED;
+#else
+    fdTrace = open(pszPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fdTrace < 0) return (SHORT)(intptr_t)PIF_ERROR_COM_ACCESS_DENIED;
+#endif
+    if (!PifSubMapTrace(PIF_TRACE_MAP_MIN)) {
+        PifSubCloseTraceFile();
+        return (SHORT)(intptr_t)PIF_ERROR_COM_ERRORS;
+    }
+
+    long long  llWallUsec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    memcpy(puchTraceMap, achTraceMagic, sizeof(achTraceMagic));
+    PifSubPutLe(puchTraceMap + 8, (unsigned long long)llWallUsec, 8);
+    ulTraceUsed = PIF_TRACE_HEADER_SIZE;
+    tTraceStart = std::chrono::steady_clock::now();
+    nTracePorts = 0;
+    bTraceOpen = true;
+    return PIF_OK;
+}
+
+VOID    PifTraceClose(VOID)
+{
+    std::lock_guard<std::mutex>  lock(mutexTrace);
+
+    if (!bTraceOpen) return;
+    bTraceOpen = false;
+    nTracePorts = 0;
+    PifSubCloseTraceFile();
+}
+
+VOID    PifTraceAttach(HANDLE hHandle, USHORT usChannel, const char* pszName)
+{
+    std::lock_guard<std::mutex>  lock(mutexTrace);
+
+    if (!bTraceOpen || nTracePorts >= PIF_TRACE_PORTS_MAX) return;
+    aTracePorts[nTracePorts].hHandle = hHandle;
+    aTracePorts[nTracePorts].usChannel = usChannel;
+    nTracePorts++;
+    PifSubAppend(usChannel, PIF_TRACE_ATTACH, pszName, (USHORT)strlen(pszName));
+}
+
+VOID    PifTraceDetach(HANDLE hHandle)
+{
+    if (!bTraceOpen) return;
+
+    std::lock_guard<std::mutex>  lock(mutexTrace);
+
+    for (int i = 0; i < nTracePorts; i++) {
+        if (aTracePorts[i].hHandle == hHandle) {
+            aTracePorts[i] = aTracePorts[--nTracePorts];
+            break;
+        }
+    }
+}
+
+VOID    PifTraceData(HANDLE hHandle, UCHAR uchType, const void* pData, USHORT usBytes)
+{
+    if (!bTraceOpen || usBytes == 0) return;
+
+    std::lock_guard<std::mutex>  lock(mutexTrace);
+
+    for (int i = 0; i < nTracePorts && bTraceOpen; i++) {
+        if (aTracePorts[i].hHandle == hHandle) {
+            PifSubAppend(aTracePorts[i].usChannel, uchType, pData, usBytes);
+            break;
+        }
+    }
+}
+
+bool    PifTraceLoad(const char* pszPath, std::vector<PifTraceRecord>& records)
+{
+    FILE   *pFile = fopen(pszPath, "rb");
+    UCHAR   auchHeader[PIF_TRACE_HEADER_SIZE];
+
+    records.clear();
+    if (!pFile) return false;
+    if (fread(auchHeader, 1, sizeof(auchHeader), pFile) != sizeof(auchHeader) || memcmp(auchHeader, achTraceMagic, sizeof(achTraceMagic)) != 0) {
+        fclose(pFile);
+        return false;
+    }
+
+    for (;;) {
+        UCHAR  auchRecord[PIF_TRACE_RECORD_SIZE];
+        PifTraceRecord  record;
+
+        if (fread(auchRecord, 1, sizeof(auchRecord), pFile) != sizeof(auchRecord) || auchRecord[10] == PIF_TRACE_END) break;
+
+        record.llTimeUsec = (long long)PifSubGetLe(auchRecord, 8);
+        record.usChannel = (USHORT)PifSubGetLe(auchRecord + 8, 2);
+        record.uchType = auchRecord[10];
+        record.data.resize((size_t)PifSubGetLe(auchRecord + 12, 2));
+        if (!record.data.empty() && fread(&record.data[0], 1, record.data.size(), pFile) != record.data.size()) break;
+        records.push_back(record);
+    }
+
+    fclose(pFile);
+    return true;
+}
@@ -0,0 +1,62 @@
+// PifTrace.h : timestamped binary trace of the bytes written to and read from the serial ports.
+//
+// When a lane misbehaves the bytes exchanged with the scale are the first thing needed and
+// the last thing anyone has. PifTraceOpen() starts a trace file and PifTraceAttach() names
+// the ports to trace, after which PifWriteCom(), PifReadCom(), and the reads of the
+// SerialReader and the multi-port load generator, which read the port directly, each append
+// a record with the time, the port, the direction, and the bytes. A write is recorded before
+// the bytes go out so it is always ahead of its response in the file. A port is traced from
+// PifTraceAttach() until PifCloseCom() so the slave side of a loopback, which uses the same
+// Pif functions for the simulator, is not traced.
+//
+// The file is memory-mapped and records are only ever appended, each with a single copy into
+// the mapping under a lock. The mapping is grown by remapping a larger file when it fills and
+// the file is cut to the length used by PifTraceClose(). If the program stops without closing
+// the trace the pages already written are still in the file, followed by zeros, and a record
+// type of 0 marks the end.
+//
+//   header  8 bytes "PIFTRC1\0", 8 bytes wall clock time of the start in usec since 1970
+//   record  8 bytes time in usec since the start, 2 bytes channel, 1 byte type, 1 byte 0,
+//           2 bytes length, the bytes
+//
+// The numbers are little endian. The channel is the number given to PifTraceAttach(), the
+// index of the port on the command line. PifTraceLoad() reads a trace back for the replay,
+// see TraceReplay.h.
+
+#pragma once
+
+#include "PifCom.h"
+
+#include <string>
+#include <vector>
+
+#define PIF_TRACE_END       0       // no more records, the rest of the file is zeros
+#define PIF_TRACE_ATTACH    1       // a port was attached, the bytes are its name
+#define PIF_TRACE_WRITE     2       // bytes written to the port
+#define PIF_TRACE_READ      3       // bytes read from the port
+
+#define PIF_TRACE_PORTS_MAX     256     // ports which can be attached at once
+#define PIF_TRACE_HEADER_SIZE   16
+#define PIF_TRACE_RECORD_SIZE   14      // size of a record before its bytes
+
+struct PifTraceRecord {
+    long long    llTimeUsec;        // time since the start of the trace
+    USHORT       usChannel;
+    UCHAR        uchType;           // PIF_TRACE_ATTACH, PIF_TRACE_WRITE, or PIF_TRACE_READ
+    std::string  data;
+};
+
+// create the trace file, replacing one which exists. returns PIF_OK or an error code.
+SHORT   PifTraceOpen(const char* pszPath);
+VOID    PifTraceClose(VOID);
+
+// trace the bytes of an open port as channel usChannel. pszName is recorded to show which port it was.
+VOID    PifTraceAttach(HANDLE hHandle, USHORT usChannel, const char* pszName);
+VOID    PifTraceDetach(HANDLE hHandle);
+
+// append a record if the port is attached. called by the Pif functions and by code which
+// reads or writes a port directly.
+VOID    PifTraceData(HANDLE hHandle, UCHAR uchType, const void* pData, USHORT usBytes);
+
+// read all of the records of a trace file. returns false if the file can't be read or is not a trace.
+bool    PifTraceLoad(const char* pszPath, std::vector<PifTraceRecord>& records);
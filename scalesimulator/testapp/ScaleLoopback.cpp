@@ -0,0 +1,188 @@
+// ScaleLoopback.cpp : in-process scale simulator connected through a pseudo-terminal pair.
+//
+// See ScaleLoopback.h for a description.
+
+#include "ScaleLoopback.h"
+
+#if !defined(_WIN32)
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+// the response logic and the command framing are the same as the Arduino scale simulator sketch uses.
+#include "../serialcommands/scalecore.h"
+#include "../serialcommands/scaletrajectory.h"
+#include "../../libraries/SimFramer/SimFramer.h"
+#include "../../libraries/SimFramer/SimControl.h"
+
+// the scale measurement data is shared by the simulator threads of the load generator, which
+// change it with the control frames and move it along a trajectory, so one thread at a time.
+static std::mutex  mutexScale;
+
+// the time for the trajectories, as millis() of the sketch.
+static unsigned long ScaleLoopbackMsec(void)
+{
+    static const std::chrono::steady_clock::time_point  tStart = std::chrono::steady_clock::now();
+
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - tStart).count();
+}
+
+static void ScaleLoopbackReply(int fd, uint8_t uchCommand, uint8_t uchStatus, const uint8_t *pData, uint8_t nData)
+{
+    uint8_t  auchReply[SIMCTL_PAYLOAD_MAX];
+    uint8_t  auchFrame[SIMCTL_FRAME_MAX];
+
+    auchReply[0] = uchCommand | SIMCTL_REPLY;
+    auchReply[1] = uchStatus;
+    memcpy(auchReply + 2, pData, nData);
+    PifWriteCom(PIF_FD_TO_HANDLE(fd), auchFrame, SimControl::encode(auchFrame, auchReply, nData + 2));
+}
+
+// the control frames of a test rig, the same as handleControl() of the sketch. a pseudo-terminal
+// has no baud rate so a change of baud rate is checked and answered but changes nothing.
+static void ScaleLoopbackControl(int fd, const uint8_t *pPayload, int nLength)
+{
+    uint8_t  auchData[SCALE_DATA_SIZE];
+
+    if (nLength == SIMCTL_BAD_FRAME) {
+        ScaleLoopbackReply(fd, 0, SimCtlBadFrame, 0, 0);
+        return;
+    }
+
+    switch (pPayload[0]) {
+    case SCALE_CTL_SET:
+        if (nLength != 1 + SCALE_DATA_SIZE) {
+            ScaleLoopbackReply(fd, pPayload[0], SimCtlBadLength, 0, 0);
+        }
+        else {
+            bool  bSet = scaleSetData(pPayload + 1);
+            if (bSet) scaleTrajectoryStart(0, ScaleLoopbackMsec());
+            ScaleLoopbackReply(fd, pPayload[0], bSet ? SimCtlOk : SimCtlBadValue, 0, 0);
+        }
+        break;
+    case SCALE_CTL_GET:
+        if (nLength != 1) {
+            ScaleLoopbackReply(fd, pPayload[0], SimCtlBadLength, 0, 0);
+        }
+        else {
+            scaleGetData(auchData);
+            ScaleLoopbackReply(fd, pPayload[0], SimCtlOk, auchData, sizeof(auchData));
+        }
+        break;
+    case SCALE_CTL_MOTION:
+        if (nLength != 2) {
+            ScaleLoopbackReply(fd, pPayload[0], SimCtlBadLength, 0, 0);
+        }
+        else {
+            ScaleLoopbackReply(fd, pPayload[0], scaleTrajectoryStart(pPayload[1], ScaleLoopbackMsec()) ? SimCtlOk : SimCtlBadValue, 0, 0);
+        }
+        break;
+    case SIMCTL_CMD_BAUD:
+        if (nLength != 5) {
+            ScaleLoopbackReply(fd, pPayload[0], SimCtlBadLength, 0, 0);
+        }
+        else {
+            uint32_t  ulBaud = pPayload[1] | ((uint32_t)pPayload[2] << 8) | ((uint32_t)pPayload[3] << 16) | ((uint32_t)pPayload[4] << 24);
+            ScaleLoopbackReply(fd, pPayload[0], simControlBaud(ulBaud) ? SimCtlOk : SimCtlBadValue, 0, 0);
+        }
+        break;
+    default:
+        ScaleLoopbackReply(fd, pPayload[0], SimCtlUnknown, 0, 0);
+        break;
+    }
+}
+
+static void ScaleLoopbackCommands(int fd, SimFramer<32>& cmdFramer, char* cmdBuffer, uint8_t nSize)
+{
+    while (cmdFramer.getFrame(cmdBuffer, nSize) >= 0) {
+        const char *pFrame;
+        int     nBytes;
+
+        pFrame = getResponseFrame(cmdBuffer, &nBytes);
+        PifWriteCom(PIF_FD_TO_HANDLE(fd), pFrame, (USHORT)nBytes);
+    }
+}
+
+static void ScaleLoopbackThread(int fd)
+{
+    SimFramer<32>  cmdFramer;
+    SimControl     simControl;
+    uint8_t        auchPayload[SIMCTL_PAYLOAD_MAX];
+
+    for (;;) {
+        struct pollfd  pfd = { fd, POLLIN, 0 };
+        char    bufin[64];
+        char    cmdBuffer[16];
+        ssize_t nRead;
+
+        // a control frame cut short is thrown away once the line has been idle for a while.
+        int  iRet = poll(&pfd, 1, simControl.busy() ? SIMCTL_IDLE_MSEC : -1);
+        if (iRet < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (iRet == 0) {
+            simControl.reset();
+            continue;
+        }
+        // the console closed the master side of the pair.
+        if (pfd.revents & (POLLHUP | POLLERR | POLLNVAL)) break;
+
+        nRead = read(fd, bufin, sizeof(bufin));
+        if (nRead < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+        if (nRead <= 0) break;
+
+        // the weight is moved along the trajectory when there is a request rather than by a
+        // timer, the requests are the only ones to see it.
+        std::lock_guard<std::mutex>  lock(mutexScale);
+        scaleTrajectoryUpdate(ScaleLoopbackMsec());
+        for (ssize_t i = 0; i < nRead; i++) {
+            if (!simControl.putByte((uint8_t)bufin[i])) {
+                // each command is answered as its terminator arrives, a read of pipelined
+                // commands can be longer than the ring buffer of cmdFramer.
+                cmdFramer.putByte((uint8_t)bufin[i]);
+                ScaleLoopbackCommands(fd, cmdFramer, cmdBuffer, sizeof(cmdBuffer));
+                continue;
+            }
+            int  nLength = simControl.getFrame(auchPayload);
+            if (nLength != SIMCTL_NO_FRAME) {
+                // answer the commands which came before the frame first so the replies are in order.
+                ScaleLoopbackCommands(fd, cmdFramer, cmdBuffer, sizeof(cmdBuffer));
+                ScaleLoopbackControl(fd, auchPayload, nLength);
+            }
+        }
+        ScaleLoopbackCommands(fd, cmdFramer, cmdBuffer, sizeof(cmdBuffer));
+    }
+
+    close(fd);
+}
+
+HANDLE  ScaleLoopbackOpen(CONST PROTOCOL* pProtocol)
+{
+    HANDLE  hMaster, hSlave;
+    SHORT   sRet;
+
+    sRet = PifOpenPtyPair(pProtocol, &hMaster, &hSlave);
+    if (sRet != PIF_OK) {
+        return (HANDLE)(intptr_t)sRet;
+    }
+
+    // build the response frames now rather than on the first request.
+    {
+        std::lock_guard<std::mutex>  lock(mutexScale);
+        updateResponseFrames();
+    }
+
+    std::thread(ScaleLoopbackThread, PIF_HANDLE_TO_FD(hSlave)).detach();
+
+    return hMaster;
+}
+
+#endif    // !defined(_WIN32)
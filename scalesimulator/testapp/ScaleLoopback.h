@@ -0,0 +1,16 @@
+// ScaleLoopback.h : in-process scale simulator connected through a pseudo-terminal pair.
+//
+// The loopback allows the console to be used without an Arduino. A pseudo-terminal
+// pair is opened with PifOpenPtyPair() and a thread serves scale requests on the
+// slave side while the console uses the master side like any other serial port.
+// Closing the master side with PifCloseCom() stops the simulator thread. The simulator also
+// answers the frames of the binary control channel, see ControlSweep.h, as the sketch does,
+// including starting a weight trajectory, see scaletrajectory.h.
+
+#pragma once
+
+#include "PifCom.h"
+
+#if !defined(_WIN32)
+HANDLE  ScaleLoopbackOpen(CONST PROTOCOL* pProtocol);
+#endif
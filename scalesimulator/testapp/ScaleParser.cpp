@@ -0,0 +1,209 @@
+// ScaleParser.cpp : streaming parser for SCP-01 and SCP-02 scale responses.
+//
+// See ScaleParser.h for a description.
+
+#include "ScaleParser.h"
+
+#include <string.h>
+
+ScaleStatus parseResponseStatus(const char* pBuff, int nBytes)
+{
+    // two forms of the status byte sequence in a response.
+    //  - SCP-01  ->  <LF>hh...<CR><ETX>
+    //  - SCP-02  ->  <LF>Shh...<CR><ETX>
+
+    ScaleStatus st = { 0 };
+    int   iNdex = 2;
+
+    if (nBytes > 0 && pBuff[0] == 'S') {
+        // SCP-02 protocol detected. skip the S character to get to status bytes.
+        pBuff++;
+        nBytes--;
+    }
+
+    if (nBytes < 4) {
+        // too short for two status bytes and the <CR><ETX>.
+        st.iError = 5;
+        return st;
+    }
+
+    st.s1 = pBuff[0];
+    st.s2 = pBuff[1];
+    if (st.s2 & 0x40) {
+        // byte follows bit is turned on so lets get the next byte.
+        st.s3 = pBuff[2];
+        iNdex++;
+    }
+
+    // check that first two bytes of status have the always on bit set.
+    if ((st.s1 & 0x30) != 0x30)
+        st.iError = 1;
+    if ((st.s2 & 0x30) != 0x30)
+        st.iError = 2;
+    if ((st.s2 & 0x40) && (st.s3 & 0x30) != 0x30)
+        st.iError = 3;
+
+    // check that message is terminated by a carriage return and an ETX character
+    // and that there is nothing more.
+    if (nBytes != iNdex + 2 || pBuff[iNdex] != '\r' || pBuff[iNdex + 1] != 0x03)
+        st.iError = 4;
+
+    return st;
+}
+
+// parse a weight response, <LF>xxxx.xxuu<CR><LF>hh...<CR><ETX>, of nBytes bytes.
+static bool parseResponseWeight(const char* pBuff, int nBytes, ScaleRecord& record)
+{
+    int   iNdex = 1;
+    int   nDigits = 0;
+    long  lWeight = 0;
+    bool  bNegative = false;
+
+    if (iNdex < nBytes && pBuff[iNdex] == '-') {
+        bNegative = true;
+        iNdex++;
+    }
+
+    // most significant part of the weight, at least one digit.
+    for ( ; iNdex < nBytes && pBuff[iNdex] >= '0' && pBuff[iNdex] <= '9'; iNdex++, nDigits++) {
+        lWeight = lWeight * 10 + (pBuff[iNdex] - '0');
+    }
+    if (nDigits < 1 || nDigits > 6 || iNdex >= nBytes || pBuff[iNdex] != '.') return false;
+    iNdex++;
+
+    // least significant part of the weight.
+    record.iDecimals = 0;
+    for ( ; iNdex < nBytes && pBuff[iNdex] >= '0' && pBuff[iNdex] <= '9'; iNdex++, record.iDecimals++) {
+        lWeight = lWeight * 10 + (pBuff[iNdex] - '0');
+    }
+    if (record.iDecimals > 3) return false;
+
+    // units of measurement, either upper or lower case.
+    if (iNdex + 1 >= nBytes) return false;
+    char  c1 = pBuff[iNdex] | 0x20, c2 = pBuff[iNdex + 1] | 0x20;
+    if (c1 == 'l' && c2 == 'b') {
+        record.iUnits = SCALE_UNITS_LB;
+        iNdex += 2;
+    }
+    else if (c1 == 'k' && c2 == 'g') {
+        record.iUnits = SCALE_UNITS_KG;
+        iNdex += 2;
+    }
+    else if (c1 == 'o' && c2 == 'z') {
+        record.iUnits = SCALE_UNITS_OZ;
+        iNdex += 2;
+    }
+    else if (c1 == 'g') {
+        record.iUnits = SCALE_UNITS_G;
+        iNdex += 1;
+    }
+    else {
+        return false;
+    }
+
+    if (iNdex + 1 >= nBytes || pBuff[iNdex] != '\r' || pBuff[iNdex + 1] != '\n') return false;
+    iNdex += 2;
+
+    record.st = parseResponseStatus(pBuff + iNdex, nBytes - iNdex);
+    if (record.st.iError) return false;
+
+    record.iType = SCALE_RECORD_WEIGHT;
+    record.bScp02 = (pBuff[iNdex] == 'S');
+    record.lWeight = bNegative ? -lWeight : lWeight;
+    return true;
+}
+
+void ScaleParser::Reset()
+{
+    nBuffer = 0;
+    ulRecords = 0;
+    ulErrors = 0;
+    ulResyncBytes = 0;
+}
+
+// parse the response in the buffer which starts with the LF at iStart and ends with the ETX
+// at the end of the buffer.
+bool ScaleParser::ParseBuffer(int iStart, ScaleRecord& record) const
+{
+    const char* pBuff = auchBuffer + iStart;
+    int   nBytes = nBuffer - iStart;
+
+    memset(&record, 0, sizeof(record));
+
+    if (nBytes == 4 && pBuff[1] == '?' && pBuff[2] == '\r') {
+        record.iType = SCALE_RECORD_UNRECOGNIZED;
+        return true;
+    }
+
+    // a status response can start with a digit, '0' is 0x30, so check for it first.
+    record.st = parseResponseStatus(pBuff + 1, nBytes - 1);
+    if (record.st.iError == 0) {
+        record.iType = SCALE_RECORD_STATUS;
+        record.bScp02 = (pBuff[1] == 'S');
+        return true;
+    }
+
+    return parseResponseWeight(pBuff, nBytes, record);
+}
+
+// throw away the bytes before iNext, which is the index of an LF in the buffer or nBuffer.
+void ScaleParser::DropTo(int iNext)
+{
+    ulResyncBytes += iNext;
+    nBuffer -= iNext;
+    memmove(auchBuffer, auchBuffer + iNext, nBuffer);
+}
+
+bool ScaleParser::PutByte(char c, ScaleRecord& record)
+{
+    if (nBuffer == 0 && c != '\n') {
+        // waiting for the LF that starts a response.
+        ulResyncBytes++;
+        return false;
+    }
+
+    if (nBuffer >= SCALEPARSER_BUFFER_SIZE) {
+        // no ETX yet and the buffer is full so this can't be a response. start
+        // again at the next LF, other than an LF following a CR which is the LF
+        // in the middle of a weight response.
+        int iNext = 1;
+        while (iNext < nBuffer && (auchBuffer[iNext] != '\n' || auchBuffer[iNext - 1] == '\r')) iNext++;
+        DropTo(iNext);
+        if (nBuffer == 0 && c != '\n') {
+            ulResyncBytes++;
+            return false;
+        }
+    }
+
+    auchBuffer[nBuffer++] = c;
+    if (c != 0x03) return false;
+
+    // an ETX so this should be the end of a response. if the response is malformed try
+    // again from any later LF that might be the start of a response following garbage.
+    for (int iStart = 0; iStart < nBuffer; iStart++) {
+        if (auchBuffer[iStart] != '\n' || (iStart > 0 && auchBuffer[iStart - 1] == '\r')) continue;
+        if (ParseBuffer(iStart, record)) {
+            ulResyncBytes += iStart;
+            ulRecords++;
+            nBuffer = 0;
+            return true;
+        }
+    }
+
+    ulErrors++;
+    nBuffer = 0;
+    return false;
+}
+
+int ScaleParser::Parse(const char* pData, int nBytes, ScaleRecord* pRecords, int nMaxRecords, int* pnUsed)
+{
+    int  nRecords = 0;
+    int  iNdex = 0;
+
+    while (iNdex < nBytes && nRecords < nMaxRecords) {
+        if (PutByte(pData[iNdex++], pRecords[nRecords])) nRecords++;
+    }
+
+    if (pnUsed) *pnUsed = iNdex;
+    return nRecords;
+}
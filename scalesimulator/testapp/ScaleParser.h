@@ -0,0 +1,79 @@
+// ScaleParser.h : streaming parser for SCP-01 and SCP-02 scale responses.
+//
+// The bytes from the scale are given to the parser as they arrive, in chunks of any size
+// including one byte at a time, and a ScaleRecord is produced each time an ETX completes a
+// response. Nothing is assumed about how the bytes were divided into reads.
+//
+// A response starts with an LF and ends with an ETX. The parser collects the bytes of a
+// response into a small fixed size buffer and only looks at bytes within that buffer so a
+// short or malformed response can not cause it to read past the data received. Bytes before
+// the first LF are discarded. If a response is malformed the parser tries again from each
+// later LF in the buffer so a good response following garbage that contained an LF is still
+// found. If no ETX arrives before the buffer is full the bytes up to the next LF are thrown
+// away. Discarded bytes are counted in ulResyncBytes.
+
+#pragma once
+
+#define SCALEPARSER_BUFFER_SIZE   32     // longest response, the SCP-02 weight response is 18 bytes
+
+struct ScaleStatus {
+    int  iError;
+    unsigned char  s1;
+    unsigned char  s2;
+    unsigned char  s3;
+};
+
+enum ScaleRecordType {
+    SCALE_RECORD_WEIGHT = 1,            // <LF>xxxx.xxuu<CR><LF>hh...<CR><ETX>
+    SCALE_RECORD_STATUS,                // <LF>hh...<CR><ETX>
+    SCALE_RECORD_UNRECOGNIZED           // <LF>?<CR><ETX>
+};
+
+enum ScaleUnits {
+    SCALE_UNITS_LB = 0,
+    SCALE_UNITS_KG,
+    SCALE_UNITS_OZ,
+    SCALE_UNITS_G
+};
+
+struct ScaleRecord {
+    ScaleRecordType  iType;
+    bool         bScp02;        // status bytes were preceded by an S
+    long         lWeight;       // weight with the decimal point removed, 0.250 is 250
+    int          iDecimals;     // number of digits after the decimal point, 3 for 0.250
+    ScaleUnits   iUnits;
+    ScaleStatus  st;
+};
+
+class ScaleParser {
+public:
+    ScaleParser() { Reset(); }
+
+    void Reset();
+
+    // give the parser the next byte. returns true if a response is complete in which
+    // case record contains the response.
+    bool PutByte(char c, ScaleRecord& record);
+
+    // give the parser a chunk of bytes. the records for the responses completed are put
+    // into pRecords, at most nMaxRecords. the number of records is returned and the number
+    // of bytes used in *pnUsed, which is less than nBytes only if pRecords became full.
+    int  Parse(const char* pData, int nBytes, ScaleRecord* pRecords, int nMaxRecords, int* pnUsed = 0);
+
+    unsigned long  ulRecords;       // number of good responses
+    unsigned long  ulErrors;        // number of responses which ended with an ETX but were malformed
+    unsigned long  ulResyncBytes;   // number of bytes thrown away looking for the start of a response
+
+private:
+    bool ParseBuffer(int iStart, ScaleRecord& record) const;
+    void DropTo(int iNext);
+
+    char  auchBuffer[SCALEPARSER_BUFFER_SIZE];
+    int   nBuffer;                  // number of bytes in auchBuffer, 0 if waiting for an LF
+};
+
+// parse the status bytes of a response. pBuff points to the first status byte, or the S
+// of an SCP-02 response, and nBytes is the number of bytes from there to the end of the
+// response. st.iError is not zero if the status bytes or the <CR><ETX> which should follow
+// them are not correct.
+ScaleStatus parseResponseStatus(const char* pBuff, int nBytes);
@@ -72,613 +72,475 @@
  *               <LF>?<CR><ETX>
  * 
 */
-#define _CRT_SECURE_NO_WARNINGS
+#include "PifCom.h"
+#include "PifTrace.h"
+#include "ScaleLoopback.h"
+#include "ScaleParser.h"
+#include "LoadGen.h"
+#include "ControlSweep.h"
+#include "TraceReplay.h"
+#include "SerialReader.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-#include <windows.h>
 #include <iostream>
 
-#define PIF_OK  1
-
-#define PIF_ERROR_SYSTEM                (HANDLE)(-1)
-
-#define PIF_ERROR_FILE_EXIST            (HANDLE)(-5)
-#define PIF_ERROR_FILE_EOF              (HANDLE)(-6)
-#define PIF_ERROR_FILE_DISK_FULL        (HANDLE)(-7)
-#define PIF_ERROR_FILE_NOT_FOUND        (HANDLE)(-8)
-
-#define PIF_ERROR_COM_POWER_FAILURE     (HANDLE)(-2)
-#define PIF_ERROR_COM_TIMEOUT           (HANDLE)(-3)
-#define PIF_ERROR_COM_NOT_PROVIDED      (HANDLE)(-4)
-#define PIF_ERROR_COM_BUSY              (HANDLE)(-5)
-#define PIF_ERROR_COM_EOF               (HANDLE)(-6)
-#define PIF_ERROR_COM_ABORTED           (HANDLE)(-9)
-#define PIF_ERROR_COM_ACCESS_DENIED     (HANDLE)(-10)      // same as PIF_ERROR_NET_ACCESS_DENIED
-#define PIF_ERROR_COM_ERRORS            (HANDLE)(-10)      // same as PIF_ERROR_NET_ERRORS
-#define PIF_ERROR_COM_OFFLINE           (HANDLE)(-13)
-#define PIF_ERROR_COM_LOOT_TEST         (HANDLE)(-55)
-#define PIF_ERROR_COM_NO_DSR_AND_CTS    (HANDLE)(-57)
-#define PIF_ERROR_COM_NO_CTS            (HANDLE)(-59)
-#define PIF_ERROR_COM_NO_DSR            (HANDLE)(-60)
-#define PIF_ERROR_COM_OVERRUN           (HANDLE)(-62)
-#define PIF_ERROR_COM_FRAMING           (HANDLE)(-63)
-#define PIF_ERROR_COM_PARITY            (HANDLE)(-64)
-#define PIF_ERROR_COM_MONITOR           (HANDLE)(-66)
-#define PIF_ERROR_COM_BUFFER_OVERFLOW   (HANDLE)(-150)
-#define PIF_ERROR_COM_NO_INTERRUPT      (HANDLE)(-151)
-#define PIF_ERROR_COM_TIMEOUT_M_L       (HANDLE)(-162)
-#define PIF_ERROR_COM_COMM_M_L          (HANDLE)(-163)
-
-#define COM_BYTE_ODD_PARITY     0x08
-#define COM_BYTE_EVEN_PARITY    0x18
-#define COM_BYTE_2_STOP_BITS    0x04
-#define COM_BYTE_7_BITS_DATA    0x02
-#define COM_BYTE_8_BITS_DATA    0x03
-
-// for device config option for handshake with serial connections JHHJ 9-13-05
-#define COM_BYTE_HANDSHAKE_NONE		0x01
-#define COM_BYTE_HANDSHAKE_RTSCTS	0x02
-#define COM_BYTE_HANDSHAKE_CTS		0x04
-#define COM_BYTE_HANDSHAKE_RTS		0x08
-#define COM_BYTE_HANDSHAKE_XONOFF	0x10
-#define COM_BYTE_HANDSHAKE_DTRDSR	0x20
-
-typedef struct {
-    SHORT   fPip;
-    USHORT  usPipAddr;
-    USHORT  usComBaud;
-    UCHAR   uchComByteFormat;
-    UCHAR   uchComTextFormat;
-    UCHAR   auchComNonEndChar[4];
-    UCHAR   auchComEndChar[3];
-    UCHAR   uchComDLEChar;
-    UCHAR   auchComHandShakePro;
-} PROTOCOL;
-
-
-HANDLE   PifOpenCom(USHORT usPortId, CONST PROTOCOL* pProtocol)
+// print a response record from the ScaleParser.
+void printRecord(const ScaleRecord& record)
 {
-    TCHAR   wszPortName[16] = { 0 };
-    HANDLE  hHandle;
-    DWORD dwError;
-    DCB dcb = { 0 };
-    COMMTIMEOUTS comTimer = { 0 };
-    DWORD   dwCommMasks;
-    DWORD   dwBaudRate;                 // baud rate
-    DWORD   nCharBits, nMultiple;
-    BYTE    bByteSize;                  // number of bits/byte, 4-8
-    BYTE    bParity;                    // 0-4 = no, odd, even, mark, space
-    BYTE    bStopBits;                  // 0,1,2 = 1, 1.5, 2
-    BOOL    fResult;
-
-    // see Microsoft document HOWTO: Specify Serial Ports Larger than COM9.
-    // https://support.microsoft.com/en-us/kb/115831
-    // CreateFile() can be used to get a handle to a serial port. The "Win32 Programmer's Reference" entry for "CreateFile()"
-    // mentions that the share mode must be 0, the create parameter must be OPEN_EXISTING, and the template must be NULL. 
-    //
-    // CreateFile() is successful when you use "COM1" through "COM9" for the name of the file;
-    // however, the value INVALID_HANDLE_VALUE is returned if you use "COM10" or greater. 
-    //
-    // If the name of the port is \\.\COM10, the correct way to specify the serial port in a call to
-    // CreateFile() is "\\\\.\\COM10".
-    //
-    // NOTES: This syntax also works for ports COM1 through COM9. Certain boards will let you choose
-    //        the port names yourself. This syntax works for those names as well.
-    wsprintf(wszPortName, TEXT("\\\\.\\COM%d"), usPortId);
-
-    /* Open the serial port. */
-    /* avoid to failuer of CreateFile */
-//    for (i = 0; i < 10; i++) {
-    do {
-        hHandle = CreateFile(wszPortName, /* Pointer to the name of the port, PifOpenCom() */
-            GENERIC_READ | GENERIC_WRITE,  /* Access (read-write) mode */
-            0,            /* Share mode */
-            NULL,         /* Pointer to the security attribute */
-            OPEN_EXISTING,/* How to open the serial port */
-            0,            /* Port attributes */
-            NULL);        /* Handle to port with attribute */
-                          /* to copy */
-
-/* If it fails to open the port, return FALSE. */
-        if (hHandle == INVALID_HANDLE_VALUE) {    /* Could not open the port. */
-            dwError = GetLastError();
-            if (dwError == ERROR_FILE_NOT_FOUND || dwError == ERROR_INVALID_NAME || dwError == ERROR_ACCESS_DENIED) {
-                // the COM port does not exist. probably a Virtual Serial Communications Port
-                // from a USB device which was either unplugged or turned off.
-                // or the COM port or Virtual Serial Communications port is in use by some other application.
-                return PIF_ERROR_COM_ACCESS_DENIED;
-            }
+    static const char* const  aszUnits[] = { "lb", "kg", "oz", "g" };
+
+    switch (record.iType) {
+    case SCALE_RECORD_WEIGHT:
+        {
+            long  lDivisor = 1;
+            for (int i = 0; i < record.iDecimals; i++) lDivisor *= 10;
+            long  lWeight = record.lWeight < 0 ? -record.lWeight : record.lWeight;
+            printf("  Response:  weight %s%ld.%0*ld %s  status 0x%1.1x 0x%1.1x\n", record.lWeight < 0 ? "-" : "",
+                lWeight / lDivisor, record.iDecimals, lWeight % lDivisor, aszUnits[record.iUnits], record.st.s1, record.st.s2);
         }
-        else {
-            break;
-        }
-        //   }
-    } while (0);
-    if (hHandle == INVALID_HANDLE_VALUE) {    /* Could not open the port. */
-        return PIF_ERROR_COM_ERRORS;
-    }
-
-    /* clear the error and purge the receive buffer */
-    dwError = (DWORD)(~0);                  // set all error code bits on
-    ClearCommError(hHandle, &dwError, NULL);
-    PurgeComm(hHandle, PURGE_TXABORT | PURGE_RXABORT | PURGE_TXCLEAR | PURGE_RXCLEAR);
-
-
-    /* make up comm. parameters */
-
-    dwBaudRate = pProtocol->usComBaud;
-    if (dwBaudRate == 0) {
-        CloseHandle(hHandle);
-        return PIF_ERROR_COM_ERRORS;
-    }
-
-    if ((pProtocol->uchComByteFormat & (COM_BYTE_7_BITS_DATA | COM_BYTE_8_BITS_DATA)) == COM_BYTE_7_BITS_DATA) {
-        bByteSize = 7;
-    }
-    else {
-        bByteSize = 8;
+        break;
+    case SCALE_RECORD_STATUS:
+        printf("  Response:  status 0x%1.1x 0x%1.1x\n", record.st.s1, record.st.s2);
+        break;
+    case SCALE_RECORD_UNRECOGNIZED:
+        printf("  Response: Unrecognized command.\n");
+        break;
     }
-    if ((pProtocol->uchComByteFormat & COM_BYTE_2_STOP_BITS) == COM_BYTE_2_STOP_BITS) {
-        bStopBits = TWOSTOPBITS;
-    }
-    else {
-        bStopBits = ONESTOPBIT;
-    }
-    if ((pProtocol->uchComByteFormat & (COM_BYTE_ODD_PARITY | COM_BYTE_EVEN_PARITY)) == COM_BYTE_EVEN_PARITY) {
-        bParity = EVENPARITY;
-    }
-    else
-        if ((pProtocol->uchComByteFormat & (COM_BYTE_ODD_PARITY | COM_BYTE_EVEN_PARITY)) == COM_BYTE_ODD_PARITY) {
-            bParity = ODDPARITY;
-        }
-        else {
-            bParity = NOPARITY;
-        }
-
-    /* Get the default port setting information. */
-    GetCommState(hHandle, &dcb);
-
-
-    /* set up no flow control as default */
-
-    dcb.BaudRate = dwBaudRate;              // Current baud 
-    dcb.fBinary = TRUE;               // Binary mode; no EOF check 
-    dcb.fParity = (bParity != NOPARITY);               // Enable parity checking 
-    dcb.ByteSize = bByteSize;                 // Number of bits/byte, 4-8
-    dcb.Parity = bParity;            // 0-4=no,odd,even,mark,space 
-    dcb.StopBits = bStopBits;        // 0,1,2 = 1, 1.5, 2 
-    dcb.fDsrSensitivity = FALSE;      // DSR sensitivity 
-
-    //if ((usFlag & KITCHEN_PORT_FLAG)) {
-//  if (pProtocol->fPip == PIF_COM_PROTOCOL_XON) { //
-    if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_XONOFF)
-    {
-
-        dcb.fOutxCtsFlow = FALSE;         // No CTS output flow control 
-        dcb.fOutxDsrFlow = TRUE;          // No DSR output flow control for 7161
-        dcb.fTXContinueOnXoff = TRUE;                       /* XOFF continues Tx */
-        dcb.fOutX = TRUE;                       /* XON/XOFF out flow control */
-        dcb.fInX = TRUE;                       /* XON/XOFF in flow control */
-        dcb.XonChar = 0x11;	//The default value for this property is the ASCII/ANSI value 17
-        dcb.XoffChar = 0x13;	//The default value for this property is the ASCII/ANSI value 19
+}
 
-    }
-    else
-        /* set up RTS/CTS flow control by option in device configulation*/
-        if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_RTSCTS) {
-
-            dcb.fOutxCtsFlow = TRUE;         // CTS output flow control 
-            dcb.fOutxDsrFlow = FALSE;         // No DSR output flow control 
-            dcb.fTXContinueOnXoff = FALSE;     // XOFF continues Tx heee
-            dcb.fOutX = FALSE;                // No XON/XOFF out flow control 
-            dcb.fInX = FALSE;                 // No XON/XOFF in flow control 
-            dcb.fRtsControl = RTS_CONTROL_HANDSHAKE;
-            dcb.fDsrSensitivity = FALSE;      // DSR sensitivity 
-        }
-        else
-            //Set up RTS flow control by option in device configulation
-            if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_RTS) {
-
-                dcb.fOutxCtsFlow = FALSE;         // no CTS output flow control 
-                dcb.fOutxDsrFlow = FALSE;         // No DSR output flow control 
-                dcb.fTXContinueOnXoff = FALSE;     // XOFF continues Tx 
-                dcb.fOutX = FALSE;                // No XON/XOFF out flow control 
-                dcb.fInX = FALSE;                 // No XON/XOFF in flow control 
-                dcb.fRtsControl = RTS_CONTROL_HANDSHAKE;
-                dcb.fDsrSensitivity = FALSE;      // DSR sensitivity
+// measure the ScaleParser throughput and check that it finds every response when the
+// responses are mixed with garbage and given to it in chunks of random sizes.
+void benchParser(int nPasses)
+{
+    static const char* const  aszFrames[] = {
+        "\n0000.25LB\r\n00\r\x03",      // SCP-01 weight
+        "\n0012.50KG\r\n01\r\x03",
+        "\n00.250LB\r\nS00\r\x03",      // SCP-02 weight
+        "\n00\r\x03",                   // SCP-01 status
+        "\nS10\r\x03",                  // SCP-02 status
+        "\n0p0\r\x03",                  // status with a third byte
+        "\n?\r\x03"                     // unrecognized command
+    };
+    static const ScaleRecordType  aiTypes[] = {
+        SCALE_RECORD_WEIGHT, SCALE_RECORD_WEIGHT, SCALE_RECORD_WEIGHT,
+        SCALE_RECORD_STATUS, SCALE_RECORD_STATUS, SCALE_RECORD_STATUS,
+        SCALE_RECORD_UNRECOGNIZED
+    };
+    const int  nFrameTypes = sizeof(aszFrames) / sizeof(aszFrames[0]);
+    const int  nCorpusMax = 256 * 1024;
+
+    static char  auchCorpus[256 * 1024];
+    static ScaleRecordType  aiExpected[256 * 1024 / 4];
+    static ScaleRecord  aRecords[64];
+    int   nCorpus = 0, nExpected = 0;
+
+    // build a corpus of responses with garbage between some of them. the garbage is never
+    // an LF or ETX, other than a response cut short before its ETX, so the garbage can't
+    // look like a response.
+    srand(1);
+    while (nCorpus < nCorpusMax - 128) {
+        int  iFrame = rand() % nFrameTypes;
+        int  nLength = (int)strlen(aszFrames[iFrame]);
+
+        switch (rand() % 8) {
+        case 0:     // noise bytes
+            for (int n = rand() % 48; n > 0; n--) {
+                char c = (char)(rand() % 256);
+                if (c != '\n' && c != 0x03) auchCorpus[nCorpus++] = c;
             }
-            else
-                //Set up CTS flow control by option in device configulation
-                if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_CTS) {
-
-                    dcb.fOutxCtsFlow = TRUE;         // CTS output flow control 
-                    dcb.fOutxDsrFlow = FALSE;         // No DSR output flow control 
-                    dcb.fTXContinueOnXoff = FALSE;     // XOFF continues Tx 
-                    dcb.fOutX = FALSE;                // No XON/XOFF out flow control 
-                    dcb.fInX = FALSE;                 // No XON/XOFF in flow control 
-                    dcb.fRtsControl = FALSE;
-                    dcb.fDsrSensitivity = FALSE;      // DSR sensitivity
+            break;
+        case 1:     // a response cut short, but not just after a CR as the remainder could be valid
+            {
+                int  nCut = 1 + rand() % (nLength - 1);
+                if (aszFrames[iFrame][nCut - 1] != '\r') {
+                    memcpy(auchCorpus + nCorpus, aszFrames[iFrame], nCut);
+                    nCorpus += nCut;
                 }
-                else
-                    //Set up DSR/DTR flow control by option in device configulation
-                    if (pProtocol->auchComHandShakePro & COM_BYTE_HANDSHAKE_DTRDSR) {
-
-
-                        dcb.fOutxCtsFlow = FALSE;         // CTS output flow control 
-                        dcb.fOutxDsrFlow = TRUE;         // DSR output flow control 
-                        dcb.fDtrControl = DTR_CONTROL_HANDSHAKE; //
-                        dcb.fTXContinueOnXoff = FALSE;     // XOFF continues Tx 
-                        dcb.fOutX = FALSE;                // No XON/XOFF out flow control 
-                        dcb.fInX = FALSE;                 // No XON/XOFF in flow control 
-                        dcb.fRtsControl = FALSE;
-                        dcb.fDsrSensitivity = FALSE;      // DSR sensitivity
-                    }
-
+            }
+            break;
+        }
 
-    /* Configure the port according to the specifications of the DCB */
-    /* structure. */
-    fResult = SetCommState(hHandle, &dcb);
-    if (!fResult) {
-        /* Could not create the read thread. */
-        dwError = GetLastError();
-        CloseHandle(hHandle);
-        return PIF_ERROR_COM_ERRORS;
+        memcpy(auchCorpus + nCorpus, aszFrames[iFrame], nLength);
+        nCorpus += nLength;
+        aiExpected[nExpected++] = aiTypes[iFrame];
     }
 
-    /* set up default time out value */
-
-    /* compute no. of bits / data */
-    nCharBits = 1 + bByteSize;
-    nCharBits += (bParity == NOPARITY) ? 0 : 1;
-    nCharBits += (bStopBits == ONESTOPBIT) ? 1 : 2;
-    nMultiple = (2 * CBR_9600 / dwBaudRate);
-
-    fResult = GetCommTimeouts(hHandle, &comTimer);
-    //Windows CE default values are listed next to the variables
-    //These were verified on Windows CE
-    //These default values were different on Windows XP
-    //so set the values to the CE defaults
-    comTimer.ReadIntervalTimeout = 250;         /* 250 default of CE Emulation driver */
-    comTimer.ReadTotalTimeoutMultiplier = 10;          /* 10 default of CE Emulation driver */
-    comTimer.ReadTotalTimeoutConstant = 2000;        /* read within 2000 msec (100 default of CE Emulation driver) */
-    comTimer.WriteTotalTimeoutMultiplier = 0;           /* 0 default of CE Emulation driver */
-    comTimer.WriteTotalTimeoutConstant = 1000;        /* allow 1000 msec to write (0 default of CE Emulation driver) */
-
-    fResult = SetCommTimeouts(hHandle, &comTimer);
-    if (!fResult)
-    {
-        dwError = GetLastError();
-        CloseHandle(hHandle);
-        return PIF_ERROR_COM_ERRORS;
+    // the check, the corpus given to the parser in chunks of 1 to 64 bytes.
+    ScaleParser  parser;
+    int   nFound = 0, nWrong = 0;
+    for (int iNdex = 0; iNdex < nCorpus; ) {
+        int  nChunk = 1 + rand() % 64;
+        if (nChunk > nCorpus - iNdex) nChunk = nCorpus - iNdex;
+
+        int  nUsed = 0;
+        int  nRecords = parser.Parse(auchCorpus + iNdex, nChunk, aRecords, 64, &nUsed);
+        for (int i = 0; i < nRecords; i++, nFound++) {
+            if (nFound >= nExpected || aRecords[i].iType != aiExpected[nFound]) nWrong++;
+        }
+        iNdex += nUsed;
     }
-
-    /* Direct the port to perform extended functions SETDTR and SETRTS */
-    /* SETDTR: Sends the DTR (data-terminal-ready) signal. */
-    /* SETRTS: Sends the RTS (request-to-send) signal. */
-    EscapeCommFunction(hHandle, SETDTR);
-    EscapeCommFunction(hHandle, SETRTS);
-
-    /* make up comm. event mask */
-    dwCommMasks = EV_CTS | EV_DSR | EV_ERR | EV_RLSD | EV_RXCHAR;
-
-    /* set up comm. event mask */
-    fResult = SetCommMask(hHandle, dwCommMasks);
-    if (!fResult)
-    {
-        dwError = GetLastError();
-        CloseHandle(hHandle);
-        return PIF_ERROR_COM_ERRORS;
+    printf("  Check: %d of %d responses found, %d wrong, %lu errors, %lu bytes skipped.\n",
+        nFound, nExpected, nWrong, parser.ulErrors, parser.ulResyncBytes);
+
+    // random bytes only, to check that nothing in the parser goes out of bounds.
+    parser.Reset();
+    for (int i = 0; i < nCorpusMax; i++) {
+        ScaleRecord  record;
+        parser.PutByte((char)(rand() % 256), record);
     }
-
-    /* clear the error and purge the receive buffer */
-
-//  dwErrors = (DWORD)(~0);                 // set all error code bits on
-//  fResult  = ClearCommError(hComm, &dwErrors, NULL);
-//  fResult  = PurgeComm(hComm, PURGE_RXABORT | PURGE_RXCLEAR);
-
-
-    return hHandle;
+    printf("  Random bytes: %lu responses, %lu errors, %lu bytes skipped.\n",
+        parser.ulRecords, parser.ulErrors, parser.ulResyncBytes);
+
+    // the throughput, the whole corpus given to the parser nPasses times.
+    long long  llStart = SerialReaderMicros();
+    unsigned long  ulRecords = 0;
+    parser.Reset();
+    for (int iPass = 0; iPass < nPasses; iPass++) {
+        for (int iNdex = 0; iNdex < nCorpus; ) {
+            int  nUsed = 0;
+            ulRecords += parser.Parse(auchCorpus + iNdex, nCorpus - iNdex, aRecords, 64, &nUsed);
+            iNdex += nUsed;
+        }
+    }
+    long long  llUsec = SerialReaderMicros() - llStart;
+    if (llUsec < 1) llUsec = 1;
+    printf("  Throughput: %d passes of %d bytes, %lu responses in %lld usec, %.1f MB/s.\n",
+        nPasses, nCorpus, ulRecords, llUsec, (double)nCorpus * nPasses / llUsec);
 }
 
-/*fhfh
-**********************************************************************
-**                                                                  **
-**  Synopsis:   SHORT PIFENTRY PifReadCom(USHORT usPort           **
-**                                          VOID FAR *pBuffer       **
-**                                          USHORT usBytes)          **
-**              usFile:         com handle                         **
-**              pBuffer:        reading buffer                      **
-**              usBytes:        sizeof pBuffer                      **
-**                                                                  **
-**  return:     number of bytes to be read                          **
-**                                                                  **
-**  Description:reading from serial i/o port                        **
-**                                                                  **
-**********************************************************************
-fhfh*/
-SHORT  PifReadCom(HANDLE  hHandle, void * pBuffer, USHORT usBytes)
+void printHelp()
 {
-    DWORD   dwBytesRead;
-    BOOL    fResult;
-    DWORD   dwError;
+    printf("Vers. 1.0.3  Nov - 23 - 2022\n");
+ 
+    printf("Commands\n");
+    printf("   w  - ask for weight from scale.\n");
+    printf("   s  - ask for status from scale.\n");
+    printf("   z  - zero scale.\n");
+    printf("   p  - set port number and open port.\n");
+#if !defined(_WIN32)
+    printf("        p /dev/ttyACM0 opens the port with the specified path.\n");
+    printf("   l  - open a loopback port to an in-process scale simulator.\n");
+#endif
+    printf("   t  - time n weight requests (syntax t n [d]), print round trip times.\n");
+    printf("        up to d requests are sent before waiting for a response, 1 by default.\n");
+    printf("   b  - benchmark and check the response parser (syntax b n for n passes).\n");
+    printf("   h  - print this help text.\n");
+    printf("   e  - exit.\n\n");
 
-    //    fResult = ClearCommError(hHandle, &dwErrors, &stat);
-    fResult = ReadFile(hHandle, pBuffer, (DWORD)usBytes, &dwBytesRead, NULL);
+    printf("Serial port errors\n");
+    printf("   PIF_ERROR_COM_POWER_FAILURE     (HANDLE)(-2).\n");
+    printf("   PIF_ERROR_COM_TIMEOUT           (HANDLE)(-3).\n");
+    printf("   PIF_ERROR_COM_NOT_PROVIDED      (HANDLE)(-4).\n");
+    printf("   PIF_ERROR_COM_BUSY              (HANDLE)(-5).\n");
+    printf("   PIF_ERROR_COM_EOF               (HANDLE)(-6).\n");
+    printf("   PIF_ERROR_COM_ABORTED           (HANDLE)(-9).\n");
+    printf("   PIF_ERROR_COM_ACCESS_DENIED     (HANDLE)(-10).\n");
 
-    if (fResult) {
-        if (!dwBytesRead) return (SHORT)PIF_ERROR_COM_TIMEOUT;
-        return (SHORT)dwBytesRead;
-    }
-    else {
-        SHORT  sErrorCode = 0;     // error code from PifSubGetErrorCode(). must call after GetLastError().
-        dwError = GetLastError();
-        return (sErrorCode);
-    }
+    fflush(stdout);
 }
 
-/*fhfh
-**********************************************************************
-**                                                                  **
-**  Synopsis:   SHORT PIFENTRY PifWriteCom(USHORT usPort           **
-**                                          VOID FAR *pBuffer       **
-**                                          USHORT usBytes)          **
-**              usFile:         com handle                         **
-**              pBuffer:        reading buffer                      **
-**              usBytes:        sizeof pBuffer                      **
-**                                                                  **
-**  return:     number of bytes to be written                       **
-**                                                                  **
-**  Description:writing to serial i/o port                          **
-**                                                                  **
-**********************************************************************
-fhfh*/
-SHORT  PifWriteCom(HANDLE  hHandle, const void * pBuffer,
-    USHORT usBytes)
+// print a frame with the control characters shown as <LF>, <CR>, and <ETX>.
+void printFrame(const char* pTitle, const ComFrame& frame)
 {
-    DWORD dwBytesWritten;
-    BOOL    fResult;
-    DWORD   dwError;
-
-    fResult = WriteFile(hHandle, pBuffer, (DWORD)usBytes, &dwBytesWritten, NULL);
-
-    if (fResult) {
-        if ((usBytes != dwBytesWritten) && (dwBytesWritten == 0)) {
-            PurgeComm(hHandle, PURGE_TXCLEAR);
-            return (SHORT)PIF_ERROR_COM_TIMEOUT;
+    printf("  %s (%d bytes%s): ", pTitle, frame.usLength, frame.bComplete ? "" : ", no ETX");
+    for (int i = 0; i < frame.usLength; i++) {
+        switch (frame.auchData[i]) {
+        case '\n':  printf("<LF>"); break;
+        case '\r':  printf("<CR>"); break;
+        case 0x03:  printf("<ETX>"); break;
+        default:
+            if (isprint((unsigned char)frame.auchData[i])) printf("%c", frame.auchData[i]);
+            else printf("<0x%2.2x>", (unsigned char)frame.auchData[i]);
+            break;
         }
-        return (SHORT)dwBytesWritten;
     }
-    else {
-        SHORT  sErrorCode = 0;     // error code from PifSubGetErrorCode(). must call after GetLastError().
+    printf("\n");
+}
 
-        dwError = GetLastError();
-        return (sErrorCode);
-    }
+void printUsage()
+{
+    printf("Usage: SerialConsole [-w trace]          interactive console\n");
+    printf("       SerialConsole -p port [options]   load generator, port is a number or a path\n");
+#if !defined(_WIN32)
+    printf("       SerialConsole -l [n] [options]    load generator on n loopback simulators, 1 by default\n");
+#endif
+    printf("Options\n");
+    printf("   -p port    may be given more than once to put the load on several ports at once\n");
+    printf("   -m mix     request mix, letters w, s, z each with a weight, default w. w8s1z1 is 80%% W\n");
+    printf("   -r rate    requests per second for each port, default 0 which sends each request when the last one is done\n");
+    printf("   -d secs    seconds to run, default 10\n");
+    printf("   -n count   stop after count requests to each port, with no time limit unless -d is also given\n");
+    printf("   -t msecs   response timeout, default 2000\n");
+    printf("   -b baud    baud rate, default 9600\n");
+    printf("   -s count   instead of the load, go through count settings of the scale with the binary control\n");
+    printf("              channel and check each with a weight request, one port only, 8 data bits no parity\n");
+    printf("   -f baud    with -s, change the simulator and the port to this baud rate first\n");
+    printf("   -w trace   write a trace of the bytes sent and received on the ports to the file trace\n");
+    printf("   -R trace   instead of the load, replay the requests of a trace to the port and compare the\n");
+    printf("              responses with those of the trace, with no port only parse the responses of the trace\n");
+    printf("   -g golden  with -R, compare the responses with those of the trace golden instead\n");
+    printf("   -x speed   with -R, 1 for the timing of the trace, 10 for ten times faster, default 0 for no timing.\n");
+    printf("              a request is never sent before the responses which came before it in the trace\n");
+    printf("   -c chan    with -R, the channel of the trace to replay, default the first one written to\n");
 }
 
+#define MAX_LOAD_PORTS  256
 
-/*fhfh
-**********************************************************************
-**                                                                  **
-**  Synopsis:   VOID PIFENTRY PifCloseCom(USHORT usPort)           **
-**              usPort:         com handle                         **
-**                                                                  **
-**  return:     none                                                **
-**                                                                  **
-**  Description:closing serial i/o                                  **
-**                                                                  **
-**********************************************************************
-fhfh*/
-VOID   PifCloseCom(HANDLE  hHandle)
+// run the load generator as specified on the command line and return the exit code,
+// 0 if every request got a good response, 1 if not, and 2 if there was an error.
+int runLoad(int argc, char* argv[], PROTOCOL& Protocol)
 {
-    BOOL    fReturn;
-    if (hHandle != INVALID_HANDLE_VALUE) {
-        fReturn = CloseHandle(hHandle);
+    LoadGenOptions  options;
+    const char*  apszPorts[MAX_LOAD_PORTS];
+    int   nPortNames = 0, nLoopbacks = 0;
+    bool  bDuration = false;
+    char  aszTable[100];
+    ControlSweepOptions  sweep = { 0, 0, 0 };
+    TraceReplayOptions   replayOptions = { 0, 0, -1, 0, 0 };
+    const char*  pszTrace = 0;
+
+    LoadGenDefaults(options);
+    for (int i = 1; i < argc; i++) {
+        const char* pszArg = argv[i];
+        const char* pszValue = (i + 1 < argc) ? argv[i + 1] : 0;
+
+        if (pszArg[0] != '-' || strlen(pszArg) != 2) {
+            printUsage();
+            return 2;
+        }
+        if (pszArg[1] == 'l') {
+            // an optional count of loopback simulators follows.
+            if (pszValue && isdigit((unsigned char)pszValue[0])) {
+                nLoopbacks += atoi(pszValue);
+                i++;
+            }
+            else {
+                nLoopbacks++;
+            }
+            continue;
+        }
+        if (pszValue == 0) {
+            printUsage();
+            return 2;
+        }
+        i++;
+        switch (pszArg[1]) {
+        case 'p':
+            if (nPortNames < MAX_LOAD_PORTS) apszPorts[nPortNames++] = pszValue;
+            break;
+        case 'm':  strncpy(options.aszMix, pszValue, sizeof(options.aszMix) - 1); break;
+        case 'r':  options.dRate = atof(pszValue); break;
+        case 'd':  options.dDuration = atof(pszValue); bDuration = true; break;
+        case 'n':  options.lCount = atol(pszValue); break;
+        case 't':  options.iTimeoutMsec = atoi(pszValue); break;
+        case 'b':  Protocol.ulComBaud = strtoul(pszValue, 0, 10); break;
+        case 's':  sweep.lCount = atol(pszValue); break;
+        case 'f':  sweep.ulBaud = strtoul(pszValue, 0, 10); break;
+        case 'w':  pszTrace = pszValue; break;
+        case 'R':  replayOptions.pszTrace = pszValue; break;
+        case 'g':  replayOptions.pszGolden = pszValue; break;
+        case 'x':  replayOptions.dSpeed = atof(pszValue); break;
+        case 'c':  replayOptions.iChannel = atoi(pszValue); break;
+        default:
+            printUsage();
+            return 2;
+        }
+    }
+    if (options.lCount > 0 && !bDuration) options.dDuration = 0;
+    if (!LoadGenMixTable(options.aszMix, aszTable)) {
+        printf("ERROR: request mix %s is not valid.\n", options.aszMix);
+        return 2;
+    }
+    // a replay is to one port, or to none to parse the responses of the trace.
+    static TraceReplay  replay;
+    if (replayOptions.pszTrace) {
+        if (nPortNames + nLoopbacks > 1 || sweep.lCount > 0 || replayOptions.dSpeed < 0) {
+            printUsage();
+            return 2;
+        }
+        if (!TraceReplayLoad(replayOptions, replay)) return 2;
+        // the control frames are 8 bit bytes.
+        if (replay.b8Bits) Protocol.uchComByteFormat = COM_BYTE_8_BITS_DATA;
+        replayOptions.iTimeoutMsec = options.iTimeoutMsec;
+    }
+    else if (nPortNames + nLoopbacks < 1 || nPortNames + nLoopbacks > MAX_LOAD_PORTS) {
+        printUsage();
+        return 2;
+    }
+    if (sweep.lCount > 0) {
+        if (nPortNames + nLoopbacks != 1) {
+            printUsage();
+            return 2;
+        }
+        // the control frames are 8 bit bytes.
+        Protocol.uchComByteFormat = COM_BYTE_8_BITS_DATA;
+        sweep.iTimeoutMsec = options.iTimeoutMsec;
     }
 
-    return;
-}
+    if (pszTrace) {
+        SHORT  sRet = PifTraceOpen(pszTrace);
+        if (sRet != PIF_OK) {
+            printf("ERROR: trace file %s can not be written, code %d\n", pszTrace, sRet);
+            return 2;
+        }
+    }
 
-struct ScaleStatus {
-    int  iError;
-    unsigned char  s1;
-    unsigned char  s2;
-    unsigned char  s3;
-};
+    // open the ports. a loopback is named lb0, lb1, and so on in the results.
+    static HANDLE  ahPorts[MAX_LOAD_PORTS];
+    static char    aszNames[MAX_LOAD_PORTS][64];
+    int   nPorts = 0;
+    bool  bError = false;
 
-ScaleStatus parseResponseStatus(char* pBuff)
-{
-	// two forms of the status byte sequence in a response.
-	//  - SCP-01  ->  <LF>hh...<CR><ETX>
-	//  - SCP-02  ->  <LF>Shh...<CR><ETX>
-
-    ScaleStatus st = { 0 };
-    int   iNdex = 2;
-
-	if (pBuff[0] == 'S') {
-		// SCP-02 protocol detected. skip the S character to get to status bytes.
-		pBuff++;
-	}
-
-	st.s1 = pBuff[0];
-	st.s2 = pBuff[1];
-    if (st.s2 & 0x40) {
-        // byte follows bit is turned on so lets get the next byte.
-        st.s3 = pBuff[2];
-		iNdex++;
-	}
-
-    // check that first two bytes of status have the always on bit set.
-    if ((pBuff[0] & 0x30) != 0x30)
-        st.iError = 1;
-    if ((pBuff[1] & 0x30) != 0x30)
-        st.iError = 2;
-    if ((st.s2 & 0x40) && (pBuff[2] & 0x30) != 0x30)
-        st.iError = 3;
-
-    // check that message is terminated by a carriage return and an ETX character.
-    if (pBuff[iNdex] != '\r' && pBuff[iNdex+1] != 0x03)
-        st.iError = 4;
-
-    return st;
-}
+    for (int i = 0; i < nPortNames + nLoopbacks && !bError; i++) {
+        HANDLE  hPort = INVALID_HANDLE_VALUE;
 
-void parseResponseWeight(char *pBuff)
-{
-    if (pBuff[0] == '\n') {
-        const int iStateEnd = 5;
-        int iState = 0, ndxBuff;
-        int iMsb = 0, iLsb = 0;
-        int iUnits = 0;
-
-        for (ndxBuff = 1; pBuff[ndxBuff] && iState < iStateEnd; ) {
-            switch (iState) {
-            case 0:    // parsing out Most Significant part of weight
-                if (!isdigit(pBuff[ndxBuff])) {
-                    iState++;
-                }
-                else {
-                    iMsb *= 10;
-                    iMsb += pBuff[ndxBuff] - '0';
-                    ndxBuff++;
-                }
-                break;
-            case 1:    // should be a decimal point. if not data error
-                if (pBuff[ndxBuff] == '.') {
-                    iState++;
-                    ndxBuff++;
-                }
-                else if (pBuff[ndxBuff] == '?') {
-					// unrecognized command response is "\n?\r\x03"
-                    iState = 200;
-                }
-                else {
-                    iState = 100;
-                }
-                break;
-            case 2:    // parsing out Least Significant part of weight
-                if (!isdigit(pBuff[ndxBuff])) {
-                    iState++;
-                }
-                else {
-                    iLsb *= 10;
-                    iLsb += pBuff[ndxBuff] - '0';
-                    ndxBuff++;
-                }
-                break;
-            case 3:    // parsing out units of measurement
-                switch (pBuff[ndxBuff]) {
-                case 'l':
-                case 'L':
-                    ndxBuff++;
-                    switch (pBuff[ndxBuff]) {
-                    case 'b':
-                    case 'B':
-                        iState++;
-                        ndxBuff++;
-                        iUnits = 0;
-                        break;
-                    default:
-                        iState = 101;
-                        break;
-                    }
-                    break;
-                case 'k':
-                case 'K':
-                    ndxBuff++;
-                    switch (pBuff[ndxBuff]) {
-                    case 'g':
-                    case 'G':
-                        iState++;
-                        ndxBuff++;
-                        iUnits = 1;
-                        break;
-                    default:
-                        iState = 101;
-                        break;
-                    }
-                    break;
-                default:
-                    iState = 101;
-                    break;
-                }
-                break;
-            case 4:
-                if (pBuff[ndxBuff] == '\r') {
-                    ndxBuff++;
-                    if (pBuff[ndxBuff] == '\n') {
-                        iState++;
-                        ndxBuff++;
-                    }
-                    else {
-                        iState = 102;
-                    }
-                } else {
-                    iState = 102;
-                }
-                break;
-            case iStateEnd:
-                break;
-            default:
-                break;
+        if (i < nPortNames) {
+            sprintf_s(aszNames[i], sizeof(aszNames[i]), "%s", apszPorts[i]);
+#if !defined(_WIN32)
+            if (apszPorts[i][0] == '/') {
+                hPort = PifOpenComPath(apszPorts[i], &Protocol);
+            }
+            else
+#endif
+            {
+                hPort = PifOpenCom((USHORT)atoi(apszPorts[i]), &Protocol);
             }
         }
-
-        if (iState == iStateEnd) {
-            ScaleStatus  st = parseResponseStatus(pBuff + ndxBuff);
-            printf("  Response:  weight %d.%d %s  status 0x%1.1x 0x%1.1x\n", iMsb, iLsb, ((iUnits == 0) ? "lb" : "kg"), st.s1, st.s2);
+        else {
+            sprintf_s(aszNames[i], sizeof(aszNames[i]), "lb%d", i - nPortNames);
+#if !defined(_WIN32)
+            hPort = ScaleLoopbackOpen(&Protocol);
+#else
+            hPort = PIF_ERROR_COM_NOT_PROVIDED;
+#endif
         }
-        else if (iState == 200) {
-            printf("  Unrecognized command.\n");
+        if ((long)hPort < 0) {
+            printf("ERROR: open port %s failed code %ld\n", aszNames[i], (long)hPort);
+            bError = true;
         }
         else {
-            printf("  Error in response %d at index %d.\n", iState, ndxBuff);
+            // the channel of a port in a trace is its index on the command line.
+            PifTraceAttach(hPort, (USHORT)nPorts, aszNames[i]);
+            ahPorts[nPorts++] = hPort;
         }
     }
-}
 
-void printHelp()
-{
-    printf("Vers. 1.0.3  Nov - 23 - 2022\n");
- 
-    printf("Commands\n");
-    printf("   w  - ask for weight from scale.\n");
-    printf("   s  - ask for status from scale.\n");
-    printf("   z  - zero scale.\n");
-    printf("   p  - set port number and open port.\n");
-    printf("   h  - print this help text.\n");
-    printf("   e  - exit.\n\n");
+    static LoadGenResults  aResults[MAX_LOAD_PORTS];
+    LoadGenResults  total;
+
+    if (!bError && replayOptions.pszTrace) {
+        static SerialReader  reader;
+        TraceReplayResults  results;
+        char  aszTitle[128];
+
+        sprintf_s(aszTitle, sizeof(aszTitle), "channel %d of %s (%s)", replay.iChannel, replayOptions.pszTrace, replay.name.c_str());
+        if (nPorts == 1) {
+            reader.Start(ahPorts[0]);
+            TraceReplayRun(ahPorts[0], reader, replay, replayOptions, results);
+            reader.Stop();
+            PifCloseCom(ahPorts[0]);
+            printf("replayed to %s, speed %g\n", aszNames[0], replayOptions.dSpeed);
+        }
+        else {
+            TraceReplayParse(replay, results);
+            printf("responses of the trace parsed\n");
+        }
+        TraceReplayReport(aszTitle, results);
+        return (results.ulDifferent == 0 && results.ulMissing == 0 && results.ulExtra == 0) ? 0 : 1;
+    }
 
-    printf("Serial port errors\n");
-    printf("   PIF_ERROR_COM_POWER_FAILURE     (HANDLE)(-2).\n");
-    printf("   PIF_ERROR_COM_TIMEOUT           (HANDLE)(-3).\n");
-    printf("   PIF_ERROR_COM_NOT_PROVIDED      (HANDLE)(-4).\n");
-    printf("   PIF_ERROR_COM_BUSY              (HANDLE)(-5).\n");
-    printf("   PIF_ERROR_COM_EOF               (HANDLE)(-6).\n");
-    printf("   PIF_ERROR_COM_ABORTED           (HANDLE)(-9).\n");
-    printf("   PIF_ERROR_COM_ACCESS_DENIED     (HANDLE)(-10).\n");
+    if (!bError && sweep.lCount > 0) {
+        static SerialReader  reader;
+        ControlSweepResults  results;
 
-    fflush(stdout);
+        reader.Start(ahPorts[0]);
+        bError = !ControlSweepRun(ahPorts[0], reader, sweep, results);
+        reader.Stop();
+        PifCloseCom(ahPorts[0]);
+        if (bError) return 2;
+
+        printf("1 port, %lu baud, %ld settings\n", sweep.ulBaud ? sweep.ulBaud : Protocol.ulComBaud, sweep.lCount);
+        ControlSweepReport(aszNames[0], results);
+        return (results.ulGood == results.ulSent) ? 0 : 1;
+    }
+    if (!bError) {
+        if (nPorts == 1) {
+            static SerialReader  reader;
+            reader.Start(ahPorts[0]);
+            LoadGenRun(ahPorts[0], reader, options, aResults[0]);
+            reader.Stop();
+        }
+        else {
+            LoadGenRunMulti(ahPorts, nPorts, options, aResults);
+        }
+    }
+    for (int i = 0; i < nPorts; i++) {
+        PifCloseCom(ahPorts[i]);
+    }
+    if (bError) return 2;
+
+    printf("%d port%s, %lu baud, mix %s, rate %.1f\n", nPorts, nPorts == 1 ? "" : "s", Protocol.ulComBaud, options.aszMix, options.dRate);
+    total = LoadGenResults();
+    for (int i = 0; i < nPorts; i++) {
+        LoadGenReport(aszNames[i], aResults[i]);
+        LoadGenAdd(total, aResults[i]);
+    }
+    if (nPorts > 1) {
+        LoadGenReport("all ports", total);
+    }
+
+    return (total.ulGood == total.ulSent) ? 0 : 1;
 }
 
-int main()
+int main(int argc, char* argv[])
 {
-    printHelp();
-
     SHORT     sPortId = -1;
     PROTOCOL  Protocol = { 0 };
 
     // set the standard scale protocol that is used.
-    Protocol.usComBaud = 9600;
+    Protocol.ulComBaud = 9600;
     Protocol.auchComHandShakePro |= COM_BYTE_HANDSHAKE_NONE;
     Protocol.uchComByteFormat |= COM_BYTE_7_BITS_DATA;
     Protocol.uchComByteFormat |= COM_BYTE_EVEN_PARITY;
 
+    // -w alone traces the interactive console, anything else is the load generator.
+    bool  bTrace = (argc == 3 && strcmp(argv[1], "-w") == 0);
+
+    if (argc > 1 && !bTrace) {
+        int  iExit = runLoad(argc, argv, Protocol);
+        PifTraceClose();
+        return iExit;
+    }
+    if (bTrace) {
+        SHORT  sRet = PifTraceOpen(argv[2]);
+        if (sRet != PIF_OK) {
+            printf("ERROR: trace file %s can not be written, code %d\n", argv[2], sRet);
+            return 2;
+        }
+    }
+
+    printHelp();
+
     HANDLE   hPort = INVALID_HANDLE_VALUE;
 
+    // responses are collected by a reader thread as they arrive.
+    static SerialReader  reader;
+    ScaleParser  parser;
+
     do {
         char buf[32] = { 0 };
         USHORT  usBytes = 0;
         int     iRead = 0;
+        ComFrame  frame;
+
+        // show anything which arrived since the last command such as a barcode from a scanner.
+        while (reader.TryFrame(frame)) {
+            printFrame("Unsolicited", frame);
+        }
 
         printf("> "); fflush(stdout);
 
@@ -686,7 +548,9 @@ int main()
         char* ptr;
         ptr = fgets(xBuff, 128, stdin);
 
-        if (xBuff[0] == 'e' || xBuff[0] == 'x') break;
+        if (ptr == NULL || xBuff[0] == 'e' || xBuff[0] == 'x') break;
+
+        long long llStart = SerialReaderMicros();
 
         switch (xBuff[0]) {
         case 'w':
@@ -727,13 +591,101 @@ int main()
             break;
         case 'p':
         case 'P':
+            reader.Stop();
+            PifCloseCom(hPort);
+            ptr = xBuff + 1;
+            while (isspace((unsigned char)*ptr)) ptr++;
+            ptr[strcspn(ptr, "\r\n")] = 0;
+#if !defined(_WIN32)
+            if (*ptr == '/') {
+                hPort = PifOpenComPath(ptr, &Protocol);
+            }
+            else
+#endif
+            {
+                sPortId = atoi(ptr);
+                hPort = PifOpenCom(sPortId, &Protocol);
+            }
+            if ((long)hPort < 0) {
+                printf("ERROR: open port failed code %ld\n", (long)hPort);
+                hPort = INVALID_HANDLE_VALUE;
+            }
+            else {
+                PifTraceAttach(hPort, 0, ptr);
+                reader.Start(hPort);
+            }
+            break;
+#if !defined(_WIN32)
+        case 'l':
+        case 'L':
+            reader.Stop();
             PifCloseCom(hPort);
-            sPortId = atoi(xBuff + 1);
-            hPort = PifOpenCom(sPortId, &Protocol);
+            hPort = ScaleLoopbackOpen(&Protocol);
             if ((long)hPort < 0) {
-                printf("ERROR: open port failed code %d\n", (long)hPort);
+                printf("ERROR: open loopback failed code %ld\n", (long)hPort);
                 hPort = INVALID_HANDLE_VALUE;
             }
+            else {
+                PifTraceAttach(hPort, 0, "lb0");
+                reader.Start(hPort);
+                printf("  Loopback to in-process scale simulator opened.\n");
+            }
+            break;
+#endif
+        case 't':
+        case 'T':
+            if ((long)hPort >= 0) {
+                int  nCount = 1, nDepth = 1;
+                long long  llMin = -1, llMax = 0, llTotal = 0;
+                long long  allSent[64];     // send times of the requests waiting for a response
+                int  nGood = 0, nSent = 0, nDone = 0;
+
+                sscanf(xBuff + 1, "%d %d", &nCount, &nDepth);
+                if (nCount < 1) nCount = 1;
+                if (nDepth < 1) nDepth = 1;
+                if (nDepth > 64) nDepth = 64;
+
+                // keep up to nDepth requests outstanding. the responses arrive in the
+                // order the requests were sent so each response is for the oldest request.
+                while (nDone < nCount) {
+                    while (nSent < nCount && nSent - nDone < nDepth) {
+                        allSent[nSent % 64] = SerialReaderMicros();
+                        PifWriteCom(hPort, "W\r", 2);
+                        nSent++;
+                    }
+                    if (!reader.WaitFrame(frame, 2000)) {
+                        printf("  Response timeout with %d requests outstanding.\n", nSent - nDone);
+                        break;
+                    }
+
+                    long long llUsec = frame.llTimeUsec - allSent[nDone % 64];
+                    ScaleRecord  record;
+                    int  nRecords = parser.Parse(frame.auchData, frame.usLength, &record, 1);
+                    nDone++;
+                    if (nRecords == 1 && record.iType == SCALE_RECORD_WEIGHT) {
+                        nGood++;
+                        llTotal += llUsec;
+                        if (llMin < 0 || llUsec < llMin) llMin = llUsec;
+                        if (llUsec > llMax) llMax = llUsec;
+                    }
+                }
+                if (nGood) {
+                    printf("  %d of %d requests good. round trip usec min %lld avg %lld max %lld\n", nGood, nCount, llMin, llTotal / nGood, llMax);
+                }
+                else {
+                    printf("  %d of %d requests good.\n", nGood, nCount);
+                }
+            }
+            else {
+                printf("ERROR: port not open. Use p command to open port.\n");
+            }
+            break;
+        case 'b':
+        case 'B':
+            {
+                int  nPasses = atoi(xBuff + 1);
+                benchParser(nPasses > 0 ? nPasses : 20);
+            }
             break;
         case 'h':
         case 'H':
@@ -743,44 +695,34 @@ int main()
         }
 
         if (iRead) {
-            char bufin[128] = { 0 };
+            ScaleRecord  record;
+            bool  bRecord = false;
 
             iRead = 0;
-            short sRet = PifReadCom(hPort, &bufin, sizeof(bufin));
-            if (bufin[0] != '\n') {
-                char bufPrint[256] = { 0 };
-                sprintf_s(bufPrint, 255, "0x%2.2x 0x%2.2x 0x%2.2x 0x%2.2x 0x%2.2x 0x%2.2x 0x%2.2x 0x%2.2x \n", bufin[0], bufin[1], bufin[2], bufin[3], bufin[4], bufin[5], bufin[6], bufin[7]);
-                printf("  Response has incorrect format. sRet = %d.\n    %s\n", sRet, bufPrint);
-            } else if (bufin[1] == '?') {
-                printf("  Response: Unrecognized command. sRet = %d.\n", sRet);
+            if (!reader.WaitFrame(frame, 2000)) {
+                printf("  Response timeout.\n");
+                continue;
+            }
+            printf("  Round trip %lld usec.\n", frame.llTimeUsec - llStart);
+
+            // the parser doesn't depend on the reader dividing the data into frames, the
+            // frame is simply the next chunk of bytes received.
+            for (int i = 0; i < frame.usLength && !bRecord; i++) {
+                bRecord = parser.PutByte(frame.auchData[i], record);
+            }
+            if (bRecord) {
+                printRecord(record);
             }
             else {
-                switch (buf[0]) {  // switch on the user command
-                case 'z':
-                case 'Z':
-                case 's':
-                case 'S':
-                    ScaleStatus  st = parseResponseStatus(bufin + 1);
-                    if (st.iError == 0) {
-                        printf("  Response:  status 0x%1.1x 0x%1.1x\n", st.s1, st.s2);
-                    } 
-                    else {
-                        char bufPrint[256] = { 0 };
-                        sprintf_s(bufPrint, 255, "0x%2.2x 0x%2.2x 0x%2.2x 0x%2.2x 0x%2.2x 0x%2.2x 0x%2.2x 0x%2.2x \n",
-                            bufin[0], bufin[1], bufin[2], bufin[3], bufin[4], bufin[5], bufin[6], bufin[7]);
-                        printf("  Error in response: iError = %d. sRet = %d.\n    %s\n", st.iError, sRet, bufPrint);
-                    }
-                    break;
-                case 'w':
-                case 'W':
-                    parseResponseWeight(bufin);
-                    break;
-                }
+                printFrame("Error in response", frame);
             }
         }
 
     } while (1);
 
+    reader.Stop();
     PifCloseCom(hPort);
+    PifTraceClose();
 
+    return 0;
 }
@@ -0,0 +1,233 @@
+// SerialReader.cpp : background reader thread for a serial port.
+//
+// See SerialReader.h for a description.
+
+#include "SerialReader.h"
+#include "PifTrace.h"
+
+#include <string.h>
+
+#include <chrono>
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+long long SerialReaderMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+SerialReader::SerialReader() :
+    ulFrames(0), ulDropped(0), hPort(INVALID_HANDLE_VALUE), bStop(false), bRunning(false)
+{
+#if defined(_WIN32)
+    hStopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+#else
+    fdStop = eventfd(0, EFD_NONBLOCK);
+#endif
+    memset(&frame, 0, sizeof(frame));
+}
+
+SerialReader::~SerialReader()
+{
+    Stop();
+#if defined(_WIN32)
+    CloseHandle(hStopEvent);
+#else
+    close(fdStop);
+#endif
+}
+
+bool SerialReader::Start(HANDLE hHandle)
+{
+    ComFrame  discard;
+
+    Stop();
+    if ((long)hHandle < 0) return false;
+
+    while (queue.pop(discard)) ;    // throw away anything left from a previous port
+    memset(&frame, 0, sizeof(frame));
+
+    hPort = hHandle;
+    bStop = false;
+#if defined(_WIN32)
+    ResetEvent(hStopEvent);
+#endif
+    thread = std::thread(&SerialReader::ReaderThread, this);
+    bRunning = true;
+    return true;
+}
+
+void SerialReader::Stop()
+{
+    if (!bRunning) return;
+
+    bStop = true;
+#if defined(_WIN32)
+    SetEvent(hStopEvent);
+#else
+    uint64_t  ullOne = 1;
+    if (write(fdStop, &ullOne, sizeof(ullOne)) < 0) {
+        // the eventfd counter can not overflow with one write so nothing to do.
+    }
+#endif
+    thread.join();
+
+#if !defined(_WIN32)
+    uint64_t  ullCount;
+    if (read(fdStop, &ullCount, sizeof(ullCount)) < 0) {
+        // nothing to clear.
+    }
+#endif
+    bRunning = false;
+    hPort = INVALID_HANDLE_VALUE;
+}
+
+bool SerialReader::WaitFrame(ComFrame& frameOut, int iTimeoutMsec)
+{
+    if (queue.pop(frameOut)) return true;
+
+    std::unique_lock<std::mutex>  lock(mutexWait);
+    cvWait.wait_for(lock, std::chrono::milliseconds(iTimeoutMsec), [this] { return !queue.empty(); });
+    return queue.pop(frameOut);
+}
+
+void SerialReader::EndFrame(bool bComplete)
+{
+    frame.bComplete = bComplete;
+    frame.llTimeUsec = SerialReaderMicros();
+    frame.auchData[frame.usLength] = 0;
+
+    if (queue.push(frame)) {
+        ulFrames++;
+        // take the lock so the notify can not happen between the consumer's
+        // check of the queue and its wait.
+        std::lock_guard<std::mutex>  lock(mutexWait);
+        cvWait.notify_one();
+    }
+    else {
+        ulDropped++;
+    }
+    frame.usLength = 0;
+}
+
+void SerialReader::AddBytes(const char* pData, long nBytes)
+{
+    // the port is read directly rather than with PifReadCom() so trace the bytes here.
+    PifTraceData(hPort, PIF_TRACE_READ, pData, (USHORT)nBytes);
+    for (long i = 0; i < nBytes; i++) {
+        frame.auchData[frame.usLength++] = pData[i];
+        if (pData[i] == 0x03) {
+            EndFrame(true);
+        }
+        else if (frame.usLength >= SERIALREADER_FRAME_SIZE) {
+            EndFrame(false);
+        }
+    }
+}
+
+#if defined(_WIN32)
+void SerialReader::ReaderThread()
+{
+    OVERLAPPED    ov = { 0 };
+    COMMTIMEOUTS  comTimerSave = { 0 }, comTimer = { 0 };
+    HANDLE        ahWait[2];
+
+    // return from a read as soon as any data arrives or after the gap time with no data.
+    GetCommTimeouts(hPort, &comTimerSave);
+    comTimer = comTimerSave;
+    comTimer.ReadIntervalTimeout = MAXDWORD;
+    comTimer.ReadTotalTimeoutMultiplier = MAXDWORD;
+    comTimer.ReadTotalTimeoutConstant = SERIALREADER_GAP_MSEC;
+    SetCommTimeouts(hPort, &comTimer);
+
+    ov.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    ahWait[0] = ov.hEvent;
+    ahWait[1] = hStopEvent;
+
+    while (!bStop) {
+        char    bufin[256];
+        DWORD   dwBytesRead = 0;
+        BOOL    fResult;
+
+        ResetEvent(ov.hEvent);
+        fResult = ReadFile(hPort, bufin, sizeof(bufin), &dwBytesRead, &ov);
+        if (!fResult) {
+            if (GetLastError() != ERROR_IO_PENDING) break;
+
+            DWORD dwWait = WaitForMultipleObjects(2, ahWait, FALSE, INFINITE);
+            if (dwWait != WAIT_OBJECT_0) {
+                // asked to stop. cancel the read and wait for it to finish since
+                // the read refers to bufin and ov which are on this stack.
+                CancelIo(hPort);
+                GetOverlappedResult(hPort, &ov, &dwBytesRead, TRUE);
+                break;
+            }
+            if (!GetOverlappedResult(hPort, &ov, &dwBytesRead, FALSE)) break;
+        }
+
+        if (dwBytesRead > 0) {
+            AddBytes(bufin, (long)dwBytesRead);
+        }
+        else if (frame.usLength > 0) {
+            EndFrame(false);        // data stopped before an ETX
+        }
+    }
+
+    CloseHandle(ov.hEvent);
+    SetCommTimeouts(hPort, &comTimerSave);
+}
+#else
+void SerialReader::ReaderThread()
+{
+    int     fd = PIF_HANDLE_TO_FD(hPort);
+    int     fdEpoll = epoll_create1(0);
+    struct epoll_event  ev = { 0 };
+
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fd, &ev);
+    ev.events = EPOLLIN;
+    ev.data.fd = fdStop;
+    epoll_ctl(fdEpoll, EPOLL_CTL_ADD, fdStop, &ev);
+
+    while (!bStop) {
+        struct epoll_event  aEvents[2];
+        // wait forever unless part of a frame has arrived, then only for the gap time.
+        int     iTimeout = (frame.usLength > 0) ? SERIALREADER_GAP_MSEC : -1;
+        int     nEvents = epoll_wait(fdEpoll, aEvents, 2, iTimeout);
+
+        if (nEvents < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (nEvents == 0) {
+            EndFrame(false);        // data stopped before an ETX
+            continue;
+        }
+
+        for (int i = 0; i < nEvents; i++) {
+            if (aEvents[i].data.fd != fd) continue;     // the stop event, checked by the while
+
+            char     bufin[256];
+            ssize_t  nRead = read(fd, bufin, sizeof(bufin));
+
+            if (nRead > 0) {
+                AddBytes(bufin, (long)nRead);
+            }
+            else if (nRead == 0 || (errno != EAGAIN && errno != EINTR)) {
+                // the port went away, for instance a USB serial device was unplugged.
+                // stop watching it so the thread waits only for the stop event.
+                epoll_ctl(fdEpoll, EPOLL_CTL_DEL, fd, NULL);
+                if (frame.usLength > 0) EndFrame(false);
+            }
+        }
+    }
+
+    close(fdEpoll);
+}
+#endif
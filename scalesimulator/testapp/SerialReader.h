@@ -0,0 +1,79 @@
+// SerialReader.h : background reader thread for a serial port.
+//
+// PifReadCom() blocks until its buffer is full or the read timeout expires, which is
+// 2 seconds when no ETX arrives, and data arriving when no read is outstanding such as
+// a scanner sending a barcode sits in the driver until the next command is entered.
+//
+// The SerialReader instead starts a thread which waits for data using overlapped I/O with
+// Win32 or epoll with POSIX and divides the data into frames at each ETX character. Each
+// frame is put into a lock-free single producer, single consumer queue from which the
+// console takes frames with WaitFrame() or TryFrame(). Requests can be pipelined since
+// responses are collected as they arrive and nothing that arrives is lost.
+//
+// If the data stops before an ETX arrives, the partial frame is put into the queue after
+// a short gap, SERIALREADER_GAP_MSEC, with bComplete false rather than waiting for the
+// full read timeout.
+
+#pragma once
+
+#include "PifCom.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define SERIALREADER_GAP_MSEC     50        // idle time after which a partial frame is given up on
+#define SERIALREADER_FRAME_SIZE   128       // largest frame, longer data is divided into more frames
+#define SERIALREADER_QUEUE_SIZE   256       // number of frames the queue can hold
+
+struct ComFrame {
+    long long       llTimeUsec;     // time the last byte of the frame arrived, see SerialReaderMicros()
+    unsigned short  usLength;       // number of bytes in auchData
+    bool            bComplete;      // true if the frame ends with an ETX
+    char            auchData[SERIALREADER_FRAME_SIZE + 1];   // frame data, zero terminated
+};
+
+// microseconds from a steady clock, the same clock used for ComFrame.llTimeUsec.
+long long SerialReaderMicros();
+
+class SerialReader {
+public:
+    SerialReader();
+    ~SerialReader();
+
+    bool Start(HANDLE hHandle);     // start the reader thread for an open port
+    void Stop();                    // stop the reader thread, the port is not closed
+    bool Running() const { return bRunning; }
+
+    // take the next frame from the queue, waiting up to iTimeoutMsec for one to arrive.
+    bool WaitFrame(ComFrame& frame, int iTimeoutMsec);
+    bool TryFrame(ComFrame& frame) { return queue.pop(frame); }
+
+    unsigned long   ulFrames;       // number of frames put into the queue
+    unsigned long   ulDropped;      // number of frames lost because the queue was full
+
+private:
+    void ReaderThread();
+    void AddBytes(const char* pData, long nBytes);
+    void EndFrame(bool bComplete);
+
+    HANDLE          hPort;
+    std::thread     thread;
+    std::atomic<bool>  bStop;
+    bool            bRunning;
+#if defined(_WIN32)
+    HANDLE          hStopEvent;
+#else
+    int             fdStop;         // eventfd used to wake the thread to stop
+#endif
+
+    ComFrame        frame;          // frame being assembled by the reader thread
+    SpscQueue<ComFrame, SERIALREADER_QUEUE_SIZE>  queue;
+
+    // the queue is lock-free. the mutex and condition variable are only used so that
+    // the consumer can sleep in WaitFrame() rather than spin while the queue is empty.
+    std::mutex      mutexWait;
+    std::condition_variable  cvWait;
+};
@@ -0,0 +1,49 @@
+// SpscQueue.h : lock-free single producer, single consumer queue.
+//
+// One thread, the producer, adds items with push() and one other thread, the
+// consumer, takes items with pop(). Neither thread ever waits on a lock. The
+// queue holds at most N - 1 items. push() returns false if the queue is full.
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+
+template <typename T, size_t N>
+class SpscQueue {
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    bool push(const T& item)
+    {
+        size_t  h = head.load(std::memory_order_relaxed);
+        size_t  hNext = (h + 1) % N;
+
+        if (hNext == tail.load(std::memory_order_acquire)) return false;    // full
+
+        aItems[h] = item;
+        head.store(hNext, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item)
+    {
+        size_t  t = tail.load(std::memory_order_relaxed);
+
+        if (t == head.load(std::memory_order_acquire)) return false;        // empty
+
+        item = aItems[t];
+        tail.store((t + 1) % N, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+
+private:
+    T                    aItems[N];
+    std::atomic<size_t>  head;      // next item to be written by the producer
+    std::atomic<size_t>  tail;      // next item to be read by the consumer
+};
@@ -0,0 +1,253 @@
+// TraceReplay.cpp : replay of a recorded session and comparison with a golden copy.
+//
+// See TraceReplay.h for a description.
+
+#include "TraceReplay.h"
+#include "PifTrace.h"
+#include "ScaleParser.h"
+
+#include <ctype.h>
+#include <stdio.h>
+
+static unsigned long TraceReplayCountEtx(const std::string& data)
+{
+    unsigned long  ulEtx = 0;
+
+    for (size_t i = 0; i < data.size(); i++) {
+        if (data[i] == 0x03) ulEtx++;
+    }
+    return ulEtx;
+}
+
+// the bytes read on a channel of a trace. the name of the port is put into *pName.
+static std::string TraceReplayReceived(const std::vector<PifTraceRecord>& records, int iChannel, std::string* pName)
+{
+    std::string  received;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        if (records[i].usChannel != iChannel) continue;
+        if (records[i].uchType == PIF_TRACE_READ) received += records[i].data;
+        if (records[i].uchType == PIF_TRACE_ATTACH && pName) *pName = records[i].data;
+    }
+    return received;
+}
+
+bool TraceReplayLoad(const TraceReplayOptions& options, TraceReplay& replay)
+{
+    std::vector<PifTraceRecord>  records;
+
+    if (!PifTraceLoad(options.pszTrace, records)) {
+        printf("ERROR: %s is not a trace file or can't be read.\n", options.pszTrace);
+        return false;
+    }
+
+    replay.iChannel = options.iChannel;
+    for (size_t i = 0; i < records.size() && replay.iChannel < 0; i++) {
+        if (records[i].uchType == PIF_TRACE_WRITE) replay.iChannel = records[i].usChannel;
+    }
+    if (replay.iChannel < 0) replay.iChannel = 0;
+
+    replay.name = "?";
+    replay.writes.clear();
+    replay.received = TraceReplayReceived(records, replay.iChannel, &replay.name);
+    replay.b8Bits = false;
+
+    // the writes, each with the number of responses which had arrived before it.
+    unsigned long  ulResponses = 0;
+    for (size_t i = 0; i < records.size(); i++) {
+        const PifTraceRecord&  record = records[i];
+
+        if (record.usChannel != replay.iChannel) continue;
+        if (record.uchType == PIF_TRACE_READ) {
+            ulResponses += TraceReplayCountEtx(record.data);
+        }
+        else if (record.uchType == PIF_TRACE_WRITE) {
+            TraceReplayWrite  write = { record.llTimeUsec, ulResponses, record.data };
+
+            for (size_t j = 0; j < record.data.size(); j++) {
+                if (record.data[j] & 0x80) replay.b8Bits = true;
+            }
+            replay.writes.push_back(write);
+        }
+    }
+    replay.ulResponses = ulResponses;
+
+    if (options.pszGolden) {
+        if (!PifTraceLoad(options.pszGolden, records)) {
+            printf("ERROR: %s is not a trace file or can't be read.\n", options.pszGolden);
+            return false;
+        }
+        replay.golden = TraceReplayReceived(records, replay.iChannel, 0);
+    }
+    else {
+        replay.golden = replay.received;
+    }
+
+    if (replay.writes.empty()) {
+        printf("ERROR: nothing was written on channel %d of %s.\n", replay.iChannel, options.pszTrace);
+        return false;
+    }
+    return true;
+}
+
+// the bytes of a response with the control characters shown as <LF>, <CR>, and <ETX>.
+static std::string TraceReplayShow(const std::string& data)
+{
+    std::string  text;
+    char    aszHex[8];
+
+    for (size_t i = 0; i < data.size(); i++) {
+        switch (data[i]) {
+        case '\n':  text += "<LF>"; break;
+        case '\r':  text += "<CR>"; break;
+        case 0x03:  text += "<ETX>"; break;
+        default:
+            if (isprint((unsigned char)data[i])) {
+                text += data[i];
+            }
+            else {
+                snprintf(aszHex, sizeof(aszHex), "<0x%2.2x>", (unsigned char)data[i]);
+                text += aszHex;
+            }
+            break;
+        }
+    }
+    return text;
+}
+
+// divide the bytes at each ETX. bytes after the last ETX are a response cut short.
+static void TraceReplaySplit(const std::string& data, std::vector<std::string>& responses)
+{
+    size_t  iStart = 0;
+
+    responses.clear();
+    for (size_t i = 0; i < data.size(); i++) {
+        if (data[i] == 0x03) {
+            responses.push_back(data.substr(iStart, i + 1 - iStart));
+            iStart = i + 1;
+        }
+    }
+    if (iStart < data.size()) responses.push_back(data.substr(iStart));
+}
+
+// parse the responses received and compare them with the golden copy, showing the first
+// few which are not the same.
+static void TraceReplayCompare(const std::string& received, const std::string& golden, TraceReplayResults& results)
+{
+    std::vector<std::string>  responses, expected;
+    ScaleParser  parser;
+    size_t  i;
+
+    for (i = 0; i < received.size(); i++) {
+        ScaleRecord  record;
+
+        if (parser.PutByte(received[i], record) && record.iType >= SCALE_RECORD_WEIGHT && record.iType <= SCALE_RECORD_UNRECOGNIZED) {
+            results.aulRecords[record.iType - SCALE_RECORD_WEIGHT]++;
+        }
+    }
+    results.ulParseErrors = parser.ulErrors;
+
+    TraceReplaySplit(received, responses);
+    TraceReplaySplit(golden, expected);
+    results.ulResponses = (unsigned long)responses.size();
+    results.ulGolden = (unsigned long)expected.size();
+
+    for (i = 0; i < responses.size() && i < expected.size(); i++) {
+        if (responses[i] == expected[i]) {
+            results.ulMatched++;
+            continue;
+        }
+        if (results.ulDifferent++ < TRACE_REPLAY_DIFFS_SHOWN) {
+            printf("  response %lu\n    expected %s\n    received %s\n", (unsigned long)i + 1,
+                TraceReplayShow(expected[i]).c_str(), TraceReplayShow(responses[i]).c_str());
+        }
+    }
+    if (expected.size() > responses.size()) results.ulMissing = (unsigned long)(expected.size() - responses.size());
+    if (responses.size() > expected.size()) results.ulExtra = (unsigned long)(responses.size() - expected.size());
+}
+
+// take the responses which arrive until ulWant responses have been received and llUntil has
+// passed. returns false if llDeadline passes first.
+static bool TraceReplayCollect(SerialReader& reader, std::string& received, unsigned long& ulResponses,
+    unsigned long ulWant, long long llUntil, long long llDeadline)
+{
+    for (;;) {
+        long long  llNow = SerialReaderMicros();
+        ComFrame   frame;
+
+        if (ulResponses >= ulWant && llNow >= llUntil) return true;
+        if (llNow >= llDeadline) return false;
+
+        long long  llWake = (ulResponses >= ulWant && llUntil < llDeadline) ? llUntil : llDeadline;
+        if (reader.WaitFrame(frame, (int)((llWake - llNow + 999) / 1000))) {
+            received.append(frame.auchData, frame.usLength);
+            if (frame.bComplete) ulResponses++;
+        }
+    }
+}
+
+void TraceReplayRun(HANDLE hPort, SerialReader& reader, const TraceReplay& replay, const TraceReplayOptions& options, TraceReplayResults& results)
+{
+    std::string    received;
+    unsigned long  ulResponses = 0;
+    unsigned long  ulLost = 0;          // responses given up on, so one lost response costs one timeout
+    long long      llTimeout = options.iTimeoutMsec * 1000LL;
+    long long      llFirst = replay.writes.front().llTimeUsec;
+    ComFrame       frame;
+
+    results = TraceReplayResults();
+    results.llTraceUsec = replay.writes.back().llTimeUsec - llFirst;
+
+    // throw away anything which arrived before the replay started.
+    while (reader.TryFrame(frame)) ;
+
+    long long  llStart = SerialReaderMicros();
+
+    for (size_t i = 0; i < replay.writes.size(); i++) {
+        const TraceReplayWrite&  write = replay.writes[i];
+        long long  llSend = 0, llNow = SerialReaderMicros();
+
+        // with a speed the write also waits for its time, but never goes out before the
+        // responses which came before it in the trace, or the simulator would be sent more
+        // requests at once than the terminal ever sent it.
+        if (options.dSpeed > 0) llSend = llStart + (long long)((write.llTimeUsec - llFirst) / options.dSpeed);
+        if (!TraceReplayCollect(reader, received, ulResponses, write.ulResponsesBefore - ulLost, llSend,
+                (llSend > llNow ? llSend : llNow) + llTimeout)) {
+            results.ulTimeouts++;
+            ulLost = write.ulResponsesBefore - ulResponses;
+        }
+        PifWriteCom(hPort, write.data.data(), (USHORT)write.data.size());
+        results.ulWrites++;
+    }
+
+    // the responses to the last requests.
+    if (!TraceReplayCollect(reader, received, ulResponses, replay.ulResponses - ulLost, 0, SerialReaderMicros() + llTimeout)) {
+        results.ulTimeouts++;
+    }
+    results.llElapsedUsec = SerialReaderMicros() - llStart;
+
+    TraceReplayCompare(received, replay.golden, results);
+}
+
+void TraceReplayParse(const TraceReplay& replay, TraceReplayResults& results)
+{
+    results = TraceReplayResults();
+    results.llTraceUsec = replay.writes.back().llTimeUsec - replay.writes.front().llTimeUsec;
+    results.ulWrites = (unsigned long)replay.writes.size();
+
+    long long  llStart = SerialReaderMicros();
+    TraceReplayCompare(replay.received, replay.golden, results);
+    results.llElapsedUsec = SerialReaderMicros() - llStart;
+}
+
+void TraceReplayReport(const char* pszTitle, const TraceReplayResults& results)
+{
+    printf("%s: %lu writes, %.2f sec in the trace, %.2f sec to replay\n", pszTitle, results.ulWrites,
+        results.llTraceUsec / 1000000.0, results.llElapsedUsec / 1000000.0);
+    printf("  responses %lu  golden %lu  matched %lu  different %lu  missing %lu  extra %lu  timeouts %lu\n",
+        results.ulResponses, results.ulGolden, results.ulMatched, results.ulDifferent, results.ulMissing,
+        results.ulExtra, results.ulTimeouts);
+    printf("  parsed weight %lu  status %lu  unrecognized %lu  errors %lu\n", results.aulRecords[0],
+        results.aulRecords[1], results.aulRecords[2], results.ulParseErrors);
+    fflush(stdout);
+}
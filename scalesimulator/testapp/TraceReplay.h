@@ -0,0 +1,82 @@
+// TraceReplay.h : replay of a recorded session and comparison with a golden copy.
+//
+// A trace written with PifTrace.h holds the bytes sent to a port and the bytes received from
+// it. The replay sends the bytes written to one channel of a trace, the requests of the point
+// of sale terminal or of the console, to a port or a loopback simulator and collects what comes
+// back. The responses are divided at each ETX and compared one by one with the golden copy,
+// the bytes read in the same trace or in another trace given as the golden one, so a capture
+// from the field becomes a regression test which runs offline.
+//
+// Each request is sent once as many responses have been received as had been received before
+// it in the trace, so the requests are pipelined as they were and no more are outstanding than
+// the terminal had. With a speed of 0 that is all, nothing waits for the gaps of the original
+// session. With a speed the requests also wait for the timing of the trace, or that timing made
+// faster by the factor.
+//
+// Without a port the responses in the trace are given to the ScaleParser and compared with
+// the golden copy, which checks the parser against a capture or compares two captures.
+//
+// The weight of the simulator must not change by itself during a replay, a weight trajectory
+// of the simulator gives different responses at different speeds.
+
+#pragma once
+
+#include "PifCom.h"
+#include "SerialReader.h"
+
+#include <string>
+#include <vector>
+
+#define TRACE_REPLAY_DIFFS_SHOWN    10      // responses which differ shown in the report
+
+struct TraceReplayOptions {
+    const char  *pszTrace;          // trace to replay
+    const char  *pszGolden;         // trace with the responses expected, 0 for those of pszTrace
+    int          iChannel;          // channel of the trace to replay, -1 for the first one written to
+    double       dSpeed;            // 1 for the timing of the trace, 10 for ten times faster, 0 for only as the responses allow
+    int          iTimeoutMsec;      // time to wait for a response
+};
+
+struct TraceReplayWrite {
+    long long      llTimeUsec;          // time of the write in the trace
+    unsigned long  ulResponsesBefore;   // responses received before the write in the trace
+    std::string    data;
+};
+
+// a trace loaded for the replay.
+struct TraceReplay {
+    std::string    name;            // the port the trace was made on
+    int            iChannel;
+    std::vector<TraceReplayWrite>  writes;
+    std::string    received;        // the bytes read in the trace
+    std::string    golden;          // the bytes expected
+    unsigned long  ulResponses;     // responses, ETX characters, in received
+    bool           b8Bits;          // a byte written has the high bit set, such as in a control frame
+};
+
+struct TraceReplayResults {
+    unsigned long  ulWrites;        // writes sent
+    unsigned long  ulResponses;     // responses received
+    unsigned long  ulGolden;        // responses in the golden copy
+    unsigned long  ulMatched;       // responses the same as the golden copy
+    unsigned long  ulDifferent;     // responses not the same as the golden copy
+    unsigned long  ulMissing;       // responses of the golden copy with none to compare
+    unsigned long  ulExtra;         // responses after the last of the golden copy
+    unsigned long  ulTimeouts;      // waits for a response which timed out
+    unsigned long  aulRecords[3];   // weight, status, and unrecognized responses parsed
+    unsigned long  ulParseErrors;   // responses which ended with an ETX but were malformed
+    long long      llTraceUsec;     // time from the first write to the last in the trace
+    long long      llElapsedUsec;
+};
+
+// load a channel of the trace and the golden copy. returns false and says why if they can't be read.
+bool TraceReplayLoad(const TraceReplayOptions& options, TraceReplay& replay);
+
+// send the writes of the trace to an open port whose reader thread has been started and
+// compare the responses with the golden copy.
+void TraceReplayRun(HANDLE hPort, SerialReader& reader, const TraceReplay& replay, const TraceReplayOptions& options, TraceReplayResults& results);
+
+// compare the responses in the trace with the golden copy, with no port.
+void TraceReplayParse(const TraceReplay& replay, TraceReplayResults& results);
+
+void TraceReplayReport(const char* pszTitle, const TraceReplayResults& results);
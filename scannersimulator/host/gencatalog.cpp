@@ -0,0 +1,171 @@
+/*
+ * Generator of the PLU catalog of the scanner simulator.
+ *
+ * Reads the list of items in plucatalog.txt and writes plucatalog.h, the packed
+ * PROGMEM records and the hash index described in pluformat.h.
+ *
+ *     gencatalog plucatalog.txt [count] > plucatalog.h
+ *
+ * If count is larger than the number of items in the list then the catalog is filled
+ * out to count items with UPC-A barcodes of number system 4, which is for a store's
+ * own use so the barcodes can not be mistaken for a real product, each with a proper
+ * check digit. This gives a load test a realistic variety of baskets.
+ *
+ * See README.md for how to build this program.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "pluformat.h"
+
+struct PluItem {
+  int          iSymbology;
+  std::string  barcode;
+  std::string  description;
+};
+
+static const char *symbologyList[PLU_SYMBOLOGY_COUNT] = PLU_SYMBOLOGY_LIST;
+
+static bool readCatalog (const char *pszFile, std::vector<PluItem> &items)
+{
+  FILE  *fp = fopen (pszFile, "r");
+  char  aszLine[256];
+  int   iLine = 0;
+
+  if (fp == NULL) {
+    fprintf (stderr, "gencatalog: can not open %s\n", pszFile);
+    return false;
+  }
+
+  while (fgets (aszLine, sizeof(aszLine), fp)) {
+    char  aszSym[8], aszCode[64];
+    int   nUsed = 0;
+
+    iLine++;
+    aszLine[strcspn (aszLine, "\r\n")] = 0;
+    if (aszLine[0] == '#' || aszLine[strspn (aszLine, " \t")] == 0) continue;
+    if (sscanf (aszLine, "%7s %63s %n", aszSym, aszCode, &nUsed) < 2) {
+      fprintf (stderr, "gencatalog: %s line %d: expected symbology and barcode\n", pszFile, iLine);
+      return false;
+    }
+
+    PluItem  item;
+    item.iSymbology = -1;
+    for (int i = 0; i < PLU_SYMBOLOGY_COUNT; i++) {
+      if (strcmp (aszSym, symbologyList[i]) == 0) item.iSymbology = i;
+    }
+    if (item.iSymbology < 0) {
+      fprintf (stderr, "gencatalog: %s line %d: unknown symbology %s\n", pszFile, iLine, aszSym);
+      return false;
+    }
+    item.barcode = aszCode;
+    if (item.barcode.length () > PLU_MAX_DIGITS || item.barcode.find_first_not_of ("0123456789") != std::string::npos) {
+      fprintf (stderr, "gencatalog: %s line %d: barcode must be 1 to %d digits\n", pszFile, iLine, PLU_MAX_DIGITS);
+      return false;
+    }
+    item.description = aszLine + nUsed;
+    items.push_back (item);
+  }
+
+  fclose (fp);
+  return true;
+}
+
+// fill the catalog out to nCount items with in-store UPC-A barcodes, 4 nnnnn nnnnn c.
+static void addSynthetic (std::vector<PluItem> &items, size_t nCount)
+{
+  for (int n = 1; items.size () < nCount; n++) {
+    char  aszCode[16];
+    int   iSum = 0;
+
+    snprintf (aszCode, sizeof(aszCode), "4%05d%05d", 10000 + n / 100000, n % 100000);
+    // the UPC check digit, 3 times the digits in odd positions plus the even ones.
+    for (int i = 0; i < 11; i++) iSum += (aszCode[i] - '0') * ((i % 2) ? 1 : 3);
+    aszCode[11] = '0' + (10 - iSum % 10) % 10;
+    aszCode[12] = 0;
+
+    PluItem  item;
+    item.iSymbology = 0;        // UPC-A
+    item.barcode = aszCode;
+    item.description = "in-store item " + std::to_string (n);
+    items.push_back (item);
+  }
+}
+
+int main (int argc, char *argv[])
+{
+  std::vector<PluItem>  items;
+
+  if (argc < 2) {
+    fprintf (stderr, "usage: gencatalog plucatalog.txt [count] > plucatalog.h\n");
+    return 2;
+  }
+  if (!readCatalog (argv[1], items)) return 1;
+  if (argc > 2) addSynthetic (items, (size_t)atol (argv[2]));
+  if (items.empty () || items.size () > 65534) {
+    fprintf (stderr, "gencatalog: the catalog must have 1 to 65534 items\n");
+    return 1;
+  }
+
+  // the hash table is a power of 2 at least twice the number of items.
+  size_t  nHashSize = 2;
+  while (nHashSize < items.size () * 2) nHashSize *= 2;
+  std::vector<unsigned>  hashIndex (nHashSize, 0);
+  size_t  nMaxProbe = 0;
+
+  for (size_t i = 0; i < items.size (); i++) {
+    const std::string  &code = items[i].barcode;
+    size_t  iSlot = pluHash (code.c_str (), (uint8_t)code.length ()) & (nHashSize - 1);
+    size_t  nProbe = 1;
+
+    for ( ; hashIndex[iSlot]; iSlot = (iSlot + 1) & (nHashSize - 1), nProbe++) {
+      if (items[hashIndex[iSlot] - 1].barcode == code) {
+        fprintf (stderr, "gencatalog: barcode %s is in the catalog twice\n", code.c_str ());
+        return 1;
+      }
+    }
+    hashIndex[iSlot] = (unsigned)(i + 1);
+    if (nProbe > nMaxProbe) nMaxProbe = nProbe;
+  }
+
+  printf ("/*\n");
+  printf (" * PLU catalog of the scanner simulator, %zu items.\n", items.size ());
+  printf (" *\n");
+  printf (" * Generated by host/gencatalog from plucatalog.txt, do not edit. See pluformat.h\n");
+  printf (" * for the format. Records %zu bytes, hash index %zu bytes, longest probe %zu.\n",
+      items.size () * PLU_RECORD_SIZE, nHashSize * 2, nMaxProbe);
+  printf (" */\n\n");
+  printf ("#if !defined(PLUCATALOG_H_INCLUDED)\n#define PLUCATALOG_H_INCLUDED\n\n");
+  printf ("#include \"pluformat.h\"\n\n");
+  printf ("#define PLU_COUNT       %zu\n", items.size ());
+  printf ("#define PLU_HASH_SIZE   %zu\n\n", nHashSize);
+
+  printf ("const uint8_t  pluRecords[PLU_COUNT * PLU_RECORD_SIZE] PROGMEM = {\n");
+  for (size_t i = 0; i < items.size (); i++) {
+    const PluItem  &item = items[i];
+    uint8_t  auchRecord[PLU_RECORD_SIZE] = { 0 };
+
+    auchRecord[0] = (uint8_t)((item.iSymbology << 5) | item.barcode.length ());
+    for (size_t d = 0; d < item.barcode.length (); d++) {
+      auchRecord[1 + d / 2] |= (uint8_t)((item.barcode[d] - '0') << ((d % 2) ? 0 : 4));
+    }
+    printf ("  ");
+    for (int b = 0; b < PLU_RECORD_SIZE; b++) printf ("0x%2.2x, ", auchRecord[b]);
+    printf ("   // %4zu %-3s %-14s %s\n", i, symbologyList[item.iSymbology], item.barcode.c_str (), item.description.c_str ());
+  }
+  printf ("};\n\n");
+
+  printf ("const uint16_t  pluHashIndex[PLU_HASH_SIZE] PROGMEM = {");
+  for (size_t i = 0; i < nHashSize; i++) {
+    printf ("%s%u,", (i % 16) ? " " : "\n  ", hashIndex[i]);
+  }
+  printf ("\n};\n\n");
+  printf ("#endif    // !defined(PLUCATALOG_H_INCLUDED)\n");
+
+  return 0;
+}
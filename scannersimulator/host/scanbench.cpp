@@ -0,0 +1,160 @@
+/*
+ * Host benchmark of the scanner message frame builder.
+ *
+ * Compares the cost of a scan message built two ways for every item of the catalog:
+ *   - sprintf  unpacks the item into a ScannerData, formats the message into a buffer
+ *              with sprintf(), computes the BCC over the buffer, appends the BCC with
+ *              another sprintf(), and writes the buffer to the output, the way the
+ *              sketch originally did
+ *   - frame    writes the message straight to the output with a ScanFrame, see
+ *              scanframe.h, computing the BCC as it goes, the way the sketch does now
+ *
+ * Before the benchmark the messages of the two are compared for every item with and
+ * without the BCC and the program exits with 1 if any differ.
+ *
+ *     scanbench [frames]
+ *
+ * See README.md for how to build this program.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "Arduino.h"
+#include "plucatalog.h"
+#include "scanframe.h"
+
+// the output of a message. keeps the last message written so the two ways can be
+// compared and so the compiler can not throw the writes away.
+struct ScanSink {
+  uint8_t  auchData[64];
+  uint8_t  nLength;
+
+  ScanSink () : nLength(0) {}
+  size_t write (uint8_t c) { auchData[nLength++ & 63] = c; return 1; }
+  size_t write (const char *pBuff, size_t n) { for (size_t i = 0; i < n; i++) write ((uint8_t)pBuff[i]); return n; }
+};
+
+static const char symbologyList[PLU_SYMBOLOGY_COUNT][4] PROGMEM = PLU_SYMBOLOGY_LIST;
+
+// the formats, item unpacking, and BCC as they were before scanframe.h.
+struct ScannerData {
+  char symChar[4];
+  char barcode[PLU_MAX_DIGITS + 1];
+};
+
+static const struct {
+  const char *specScan;
+  bool  bSendBcc;
+} specInUseFmt [] = {
+      { "18%s%s\x03", false},
+      { "08%s%s\x03%2.2x", true}
+};
+
+static void pluGetItem (uint16_t iItem, ScannerData &item)
+{
+  const uint8_t *pRecord = pluRecords + iItem * PLU_RECORD_SIZE;
+  uint8_t  uchHead = pgm_read_byte(pRecord);
+  uint8_t  nDigits = uchHead & 0x1f;
+
+  memcpy_P (item.symChar, symbologyList[uchHead >> 5], sizeof(item.symChar));
+  for (uint8_t d = 0; d < nDigits; d++) {
+    uint8_t  uchBcd = pgm_read_byte(pRecord + 1 + d / 2);
+    item.barcode[d] = '0' + ((d & 1) ? (uchBcd & 0x0f) : (uchBcd >> 4));
+  }
+  item.barcode[nDigits] = 0;
+}
+
+static unsigned char ScannerScaleCalcBCC (unsigned char *puchData, short sLength)
+{
+    unsigned char   uchBCC = 0;
+    short   sIndex;
+
+    for (sIndex = 0; sIndex < sLength; sIndex++) {
+        uchBCC ^= *(puchData + sIndex);
+    }
+
+    return (uchBCC);
+}
+
+static int sendScanSprintf (ScanSink &sink, uint16_t iItem, int iSpec)
+{
+  char  cBuff[64];
+  ScannerData  item;
+
+  pluGetItem (iItem, item);
+  int  nLength = sprintf (cBuff, specInUseFmt[iSpec].specScan, item.symChar, item.barcode, 0);
+  if (specInUseFmt[iSpec].bSendBcc) {
+    nLength -= 2;
+    nLength += sprintf (cBuff + nLength, "%2.2x", ScannerScaleCalcBCC ((unsigned char *)cBuff, nLength));
+  }
+  sink.write (cBuff, nLength);
+  return nLength;
+}
+
+static int sendScanFrame (ScanSink &sink, uint16_t iItem, int iSpec)
+{
+  ScanFrame<ScanSink>  frame (sink);
+
+  frame.put_P (iSpec ? PSTR("08") : PSTR("18"));
+  frame.putRecord (pluRecords + iItem * PLU_RECORD_SIZE, symbologyList);
+  return frame.end (iSpec != 0);
+}
+
+static double elapsedSeconds (std::chrono::steady_clock::time_point tStart)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+}
+
+static void bench (const char *pszName, int (*pSend)(ScanSink &, uint16_t, int), long lFrames, int iSpec)
+{
+  ScanSink  sink;
+  unsigned long  ulBytes = 0;
+  std::chrono::steady_clock::time_point  tStart = std::chrono::steady_clock::now();
+
+  for (long l = 0; l < lFrames; l++) {
+    sink.nLength = 0;
+    ulBytes += pSend (sink, (uint16_t)(l % PLU_COUNT), iSpec);
+  }
+
+  double  dSeconds = elapsedSeconds (tStart);
+  printf ("%-8s %-10s %ld frames, %lu bytes in %.3f sec, %.1f ns per frame\n", pszName, iSpec ? "with BCC" : "no BCC",
+      lFrames, ulBytes, dSeconds, dSeconds * 1e9 / lFrames);
+}
+
+int main (int argc, char *argv[])
+{
+  long  lFrames = (argc > 1) ? atol (argv[1]) : 1000000;
+  int   nDiffs = 0;
+
+  if (lFrames < 1) {
+    fprintf (stderr, "usage: scanbench [frames]\n");
+    return 2;
+  }
+
+  for (int iSpec = 0; iSpec < 2; iSpec++) {
+    for (uint16_t i = 0; i < PLU_COUNT; i++) {
+      ScanSink  sinkOld, sinkNew;
+
+      sendScanSprintf (sinkOld, i, iSpec);
+      sendScanFrame (sinkNew, i, iSpec);
+      if (sinkOld.nLength != sinkNew.nLength || memcmp (sinkOld.auchData, sinkNew.auchData, sinkOld.nLength) != 0) {
+        if (nDiffs++ < 10) {
+          printf ("item %u %s: sprintf %.*s frame %.*s\n", i, iSpec ? "with BCC" : "no BCC",
+              sinkOld.nLength, (char *)sinkOld.auchData, sinkNew.nLength, (char *)sinkNew.auchData);
+        }
+      }
+    }
+  }
+  printf ("checked %d messages of %d items, %d differ\n", 2 * PLU_COUNT, PLU_COUNT, nDiffs);
+  if (nDiffs) return 1;
+
+  for (int iSpec = 0; iSpec < 2; iSpec++) {
+    bench ("sprintf", sendScanSprintf, lFrames, iSpec);
+    bench ("frame", sendScanFrame, lFrames, iSpec);
+  }
+  return 0;
+}
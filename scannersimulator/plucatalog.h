@@ -0,0 +1,486 @@
+/*
+ * PLU catalog of the scanner simulator, 400 items.
+ *
+ * Generated by host/gencatalog from plucatalog.txt, do not edit. See pluformat.h
+ * for the format. Records 3200 bytes, hash index 2048 bytes, longest probe 8.
+ */
+
+#if !defined(PLUCATALOG_H_INCLUDED)
+#define PLUCATALOG_H_INCLUDED
+
+#include "pluformat.h"
+
+#define PLU_COUNT       400
+#define PLU_HASH_SIZE   1024
+
+const uint8_t  pluRecords[PLU_COUNT * PLU_RECORD_SIZE] PROGMEM = {
+  0x0c, 0x07, 0x01, 0x77, 0x15, 0x57, 0x66, 0x00,    //    0 A   070177155766   Twinings English Afternoon tea 20 bags
+  0x0c, 0x07, 0x01, 0x77, 0x15, 0x42, 0x40, 0x00,    //    1 A   070177154240   Twinings Irish Breakfast tea 20 bags
+  0x0c, 0x07, 0x01, 0x77, 0x15, 0x41, 0x27, 0x00,    //    2 A   070177154127   Twinings Darjeeling tea 20 bags
+  0x0c, 0x07, 0x23, 0x10, 0x00, 0x18, 0x93, 0x00,    //    3 A   072310001893   Bigelow Plantation Mint tea 20 bags
+  0x0c, 0x07, 0x23, 0x10, 0x00, 0x19, 0x78, 0x00,    //    4 A   072310001978   Bigelow Lemon Lift tea 20 bags
+  0x0c, 0x07, 0x23, 0x10, 0x00, 0x10, 0x53, 0x00,    //    5 A   072310001053   Bigelow Constant Comment tea 20 bags
+  0x0c, 0x74, 0x75, 0x99, 0x30, 0x31, 0x42, 0x00,    //    6 A   747599303142   Ghirardelli Squares Dark Chocolate Sea Caramel
+  0x0c, 0x04, 0x66, 0x77, 0x42, 0x60, 0x02, 0x00,    //    7 A   046677426002   4 pack Philips EcoVantage Soft White 40w A19 bulbs
+  0x0c, 0x04, 0x66, 0x77, 0x42, 0x60, 0x40, 0x00,    //    8 A   046677426040   4 pack Philips Soft White 100w A19 bulbs
+  0x0c, 0x08, 0x68, 0x54, 0x00, 0x56, 0x82, 0x00,    //    9 A   086854005682   5.75 oz bottle Laura Lynn Manzanilla Olives with minced pimiento
+  0x0c, 0x08, 0x68, 0x54, 0x04, 0x36, 0x22, 0x00,    //   10 A   086854043622   8.5 oz bottle Laura Lynn extra virgin olive oil
+  0x0c, 0x08, 0x68, 0x54, 0x04, 0x23, 0x11, 0x00,    //   11 A   086854042311   14.5 oz can Laura Lynn diced tomatoes no salt added
+  0x0c, 0x04, 0x14, 0x43, 0x11, 0x34, 0x21, 0x00,    //   12 A   041443113421   14.5 oz can Margaret Holmes Italian Green Beans
+  0x0c, 0x03, 0x94, 0x00, 0x01, 0x70, 0x66, 0x00,    //   13 A   039400017066   16 oz can Bush's Reduced Sodium Garbanzos chick peas
+  0x0c, 0x05, 0x20, 0x00, 0x01, 0x12, 0x27, 0x00,    //   14 A   052000011227   15 oz can Van Camp's Pork and Beans in tomato sauce
+  0x0c, 0x02, 0x90, 0x00, 0x07, 0x65, 0x01, 0x00,    //   15 A   029000076501   16 oz Planters Dry Roasted Peanuts Lightly salted
+  0x0c, 0x03, 0x70, 0x00, 0x38, 0x85, 0x17, 0x00,    //   16 A   037000388517   Charmin Ultra Soft toilet tissue 6 roll Super Mega
+  0x0c, 0x03, 0x70, 0x00, 0x52, 0x77, 0x87, 0x00,    //   17 A   037000527787   Charmin Ultra Soft toilet tissue 6 roll Mega
+  0x0c, 0x20, 0x14, 0x04, 0x30, 0x95, 0x26, 0x00,    //   18 A   201404309526   container of beef loin 1.59lbs @ $5.99 (PLU, 01404 with price $9.52)
+  0x0c, 0x20, 0x00, 0x65, 0x10, 0x90, 0x01, 0x00,    //   19 A   200065109001   container London Broil 2.44lbs @ $3.69 (PLU, 00065 with price $9.00)
+  0x0c, 0x20, 0x61, 0x41, 0x30, 0x60, 0x05, 0x00,    //   20 A   206141306005   container deli lunch $6.00
+  0x27, 0x12, 0x15, 0x70, 0x40, 0x00, 0x00, 0x00,    //   21 E   1215704        Aquafina bottled water 1L
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x00, 0x14, 0x00,    //   22 A   410000000014   in-store item 1
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00,    //   23 A   410000000021   in-store item 2
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00,    //   24 A   410000000038   in-store item 3
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x00, 0x45, 0x00,    //   25 A   410000000045   in-store item 4
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x00, 0x52, 0x00,    //   26 A   410000000052   in-store item 5
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x00, 0x69, 0x00,    //   27 A   410000000069   in-store item 6
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x00, 0x76, 0x00,    //   28 A   410000000076   in-store item 7
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x00, 0x83, 0x00,    //   29 A   410000000083   in-store item 8
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x00, 0x90, 0x00,    //   30 A   410000000090   in-store item 9
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x01, 0x06, 0x00,    //   31 A   410000000106   in-store item 10
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x01, 0x13, 0x00,    //   32 A   410000000113   in-store item 11
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x01, 0x20, 0x00,    //   33 A   410000000120   in-store item 12
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x01, 0x37, 0x00,    //   34 A   410000000137   in-store item 13
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x01, 0x44, 0x00,    //   35 A   410000000144   in-store item 14
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x01, 0x51, 0x00,    //   36 A   410000000151   in-store item 15
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x01, 0x68, 0x00,    //   37 A   410000000168   in-store item 16
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x01, 0x75, 0x00,    //   38 A   410000000175   in-store item 17
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x01, 0x82, 0x00,    //   39 A   410000000182   in-store item 18
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x01, 0x99, 0x00,    //   40 A   410000000199   in-store item 19
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x02, 0x05, 0x00,    //   41 A   410000000205   in-store item 20
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x02, 0x12, 0x00,    //   42 A   410000000212   in-store item 21
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x02, 0x29, 0x00,    //   43 A   410000000229   in-store item 22
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x02, 0x36, 0x00,    //   44 A   410000000236   in-store item 23
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x02, 0x43, 0x00,    //   45 A   410000000243   in-store item 24
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x02, 0x50, 0x00,    //   46 A   410000000250   in-store item 25
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x02, 0x67, 0x00,    //   47 A   410000000267   in-store item 26
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x02, 0x74, 0x00,    //   48 A   410000000274   in-store item 27
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x02, 0x81, 0x00,    //   49 A   410000000281   in-store item 28
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x02, 0x98, 0x00,    //   50 A   410000000298   in-store item 29
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x03, 0x04, 0x00,    //   51 A   410000000304   in-store item 30
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x03, 0x11, 0x00,    //   52 A   410000000311   in-store item 31
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x03, 0x28, 0x00,    //   53 A   410000000328   in-store item 32
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x03, 0x35, 0x00,    //   54 A   410000000335   in-store item 33
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x03, 0x42, 0x00,    //   55 A   410000000342   in-store item 34
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x03, 0x59, 0x00,    //   56 A   410000000359   in-store item 35
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x03, 0x66, 0x00,    //   57 A   410000000366   in-store item 36
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x03, 0x73, 0x00,    //   58 A   410000000373   in-store item 37
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x03, 0x80, 0x00,    //   59 A   410000000380   in-store item 38
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x03, 0x97, 0x00,    //   60 A   410000000397   in-store item 39
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x04, 0x03, 0x00,    //   61 A   410000000403   in-store item 40
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x04, 0x10, 0x00,    //   62 A   410000000410   in-store item 41
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x04, 0x27, 0x00,    //   63 A   410000000427   in-store item 42
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x04, 0x34, 0x00,    //   64 A   410000000434   in-store item 43
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x04, 0x41, 0x00,    //   65 A   410000000441   in-store item 44
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x04, 0x58, 0x00,    //   66 A   410000000458   in-store item 45
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x04, 0x65, 0x00,    //   67 A   410000000465   in-store item 46
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x04, 0x72, 0x00,    //   68 A   410000000472   in-store item 47
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x04, 0x89, 0x00,    //   69 A   410000000489   in-store item 48
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x04, 0x96, 0x00,    //   70 A   410000000496   in-store item 49
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x05, 0x02, 0x00,    //   71 A   410000000502   in-store item 50
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x05, 0x19, 0x00,    //   72 A   410000000519   in-store item 51
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x05, 0x26, 0x00,    //   73 A   410000000526   in-store item 52
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x05, 0x33, 0x00,    //   74 A   410000000533   in-store item 53
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x05, 0x40, 0x00,    //   75 A   410000000540   in-store item 54
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x05, 0x57, 0x00,    //   76 A   410000000557   in-store item 55
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x05, 0x64, 0x00,    //   77 A   410000000564   in-store item 56
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x05, 0x71, 0x00,    //   78 A   410000000571   in-store item 57
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x05, 0x88, 0x00,    //   79 A   410000000588   in-store item 58
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x05, 0x95, 0x00,    //   80 A   410000000595   in-store item 59
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x06, 0x01, 0x00,    //   81 A   410000000601   in-store item 60
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x06, 0x18, 0x00,    //   82 A   410000000618   in-store item 61
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x06, 0x25, 0x00,    //   83 A   410000000625   in-store item 62
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x06, 0x32, 0x00,    //   84 A   410000000632   in-store item 63
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x06, 0x49, 0x00,    //   85 A   410000000649   in-store item 64
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x06, 0x56, 0x00,    //   86 A   410000000656   in-store item 65
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x06, 0x63, 0x00,    //   87 A   410000000663   in-store item 66
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x06, 0x70, 0x00,    //   88 A   410000000670   in-store item 67
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x06, 0x87, 0x00,    //   89 A   410000000687   in-store item 68
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x06, 0x94, 0x00,    //   90 A   410000000694   in-store item 69
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00,    //   91 A   410000000700   in-store item 70
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x07, 0x17, 0x00,    //   92 A   410000000717   in-store item 71
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x07, 0x24, 0x00,    //   93 A   410000000724   in-store item 72
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x07, 0x31, 0x00,    //   94 A   410000000731   in-store item 73
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x07, 0x48, 0x00,    //   95 A   410000000748   in-store item 74
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x07, 0x55, 0x00,    //   96 A   410000000755   in-store item 75
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x07, 0x62, 0x00,    //   97 A   410000000762   in-store item 76
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x07, 0x79, 0x00,    //   98 A   410000000779   in-store item 77
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x07, 0x86, 0x00,    //   99 A   410000000786   in-store item 78
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x07, 0x93, 0x00,    //  100 A   410000000793   in-store item 79
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x08, 0x09, 0x00,    //  101 A   410000000809   in-store item 80
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x08, 0x16, 0x00,    //  102 A   410000000816   in-store item 81
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x08, 0x23, 0x00,    //  103 A   410000000823   in-store item 82
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x08, 0x30, 0x00,    //  104 A   410000000830   in-store item 83
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x08, 0x47, 0x00,    //  105 A   410000000847   in-store item 84
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x08, 0x54, 0x00,    //  106 A   410000000854   in-store item 85
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x08, 0x61, 0x00,    //  107 A   410000000861   in-store item 86
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x08, 0x78, 0x00,    //  108 A   410000000878   in-store item 87
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x08, 0x85, 0x00,    //  109 A   410000000885   in-store item 88
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x08, 0x92, 0x00,    //  110 A   410000000892   in-store item 89
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x09, 0x08, 0x00,    //  111 A   410000000908   in-store item 90
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x09, 0x15, 0x00,    //  112 A   410000000915   in-store item 91
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x09, 0x22, 0x00,    //  113 A   410000000922   in-store item 92
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x09, 0x39, 0x00,    //  114 A   410000000939   in-store item 93
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x09, 0x46, 0x00,    //  115 A   410000000946   in-store item 94
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x09, 0x53, 0x00,    //  116 A   410000000953   in-store item 95
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x09, 0x60, 0x00,    //  117 A   410000000960   in-store item 96
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x09, 0x77, 0x00,    //  118 A   410000000977   in-store item 97
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x09, 0x84, 0x00,    //  119 A   410000000984   in-store item 98
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x09, 0x91, 0x00,    //  120 A   410000000991   in-store item 99
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x10, 0x04, 0x00,    //  121 A   410000001004   in-store item 100
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x10, 0x11, 0x00,    //  122 A   410000001011   in-store item 101
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x10, 0x28, 0x00,    //  123 A   410000001028   in-store item 102
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x10, 0x35, 0x00,    //  124 A   410000001035   in-store item 103
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x10, 0x42, 0x00,    //  125 A   410000001042   in-store item 104
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x10, 0x59, 0x00,    //  126 A   410000001059   in-store item 105
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x10, 0x66, 0x00,    //  127 A   410000001066   in-store item 106
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x10, 0x73, 0x00,    //  128 A   410000001073   in-store item 107
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x10, 0x80, 0x00,    //  129 A   410000001080   in-store item 108
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x10, 0x97, 0x00,    //  130 A   410000001097   in-store item 109
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x11, 0x03, 0x00,    //  131 A   410000001103   in-store item 110
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x11, 0x10, 0x00,    //  132 A   410000001110   in-store item 111
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x11, 0x27, 0x00,    //  133 A   410000001127   in-store item 112
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x11, 0x34, 0x00,    //  134 A   410000001134   in-store item 113
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x11, 0x41, 0x00,    //  135 A   410000001141   in-store item 114
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x11, 0x58, 0x00,    //  136 A   410000001158   in-store item 115
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x11, 0x65, 0x00,    //  137 A   410000001165   in-store item 116
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x11, 0x72, 0x00,    //  138 A   410000001172   in-store item 117
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x11, 0x89, 0x00,    //  139 A   410000001189   in-store item 118
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x11, 0x96, 0x00,    //  140 A   410000001196   in-store item 119
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x12, 0x02, 0x00,    //  141 A   410000001202   in-store item 120
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x12, 0x19, 0x00,    //  142 A   410000001219   in-store item 121
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x12, 0x26, 0x00,    //  143 A   410000001226   in-store item 122
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x12, 0x33, 0x00,    //  144 A   410000001233   in-store item 123
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x12, 0x40, 0x00,    //  145 A   410000001240   in-store item 124
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x12, 0x57, 0x00,    //  146 A   410000001257   in-store item 125
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x12, 0x64, 0x00,    //  147 A   410000001264   in-store item 126
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x12, 0x71, 0x00,    //  148 A   410000001271   in-store item 127
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x12, 0x88, 0x00,    //  149 A   410000001288   in-store item 128
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x12, 0x95, 0x00,    //  150 A   410000001295   in-store item 129
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x13, 0x01, 0x00,    //  151 A   410000001301   in-store item 130
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x13, 0x18, 0x00,    //  152 A   410000001318   in-store item 131
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x13, 0x25, 0x00,    //  153 A   410000001325   in-store item 132
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x13, 0x32, 0x00,    //  154 A   410000001332   in-store item 133
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x13, 0x49, 0x00,    //  155 A   410000001349   in-store item 134
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x13, 0x56, 0x00,    //  156 A   410000001356   in-store item 135
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x13, 0x63, 0x00,    //  157 A   410000001363   in-store item 136
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x13, 0x70, 0x00,    //  158 A   410000001370   in-store item 137
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x13, 0x87, 0x00,    //  159 A   410000001387   in-store item 138
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x13, 0x94, 0x00,    //  160 A   410000001394   in-store item 139
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00,    //  161 A   410000001400   in-store item 140
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x14, 0x17, 0x00,    //  162 A   410000001417   in-store item 141
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x14, 0x24, 0x00,    //  163 A   410000001424   in-store item 142
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x14, 0x31, 0x00,    //  164 A   410000001431   in-store item 143
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x14, 0x48, 0x00,    //  165 A   410000001448   in-store item 144
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x14, 0x55, 0x00,    //  166 A   410000001455   in-store item 145
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x14, 0x62, 0x00,    //  167 A   410000001462   in-store item 146
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x14, 0x79, 0x00,    //  168 A   410000001479   in-store item 147
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x14, 0x86, 0x00,    //  169 A   410000001486   in-store item 148
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x14, 0x93, 0x00,    //  170 A   410000001493   in-store item 149
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x15, 0x09, 0x00,    //  171 A   410000001509   in-store item 150
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x15, 0x16, 0x00,    //  172 A   410000001516   in-store item 151
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x15, 0x23, 0x00,    //  173 A   410000001523   in-store item 152
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x15, 0x30, 0x00,    //  174 A   410000001530   in-store item 153
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x15, 0x47, 0x00,    //  175 A   410000001547   in-store item 154
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x15, 0x54, 0x00,    //  176 A   410000001554   in-store item 155
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x15, 0x61, 0x00,    //  177 A   410000001561   in-store item 156
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x15, 0x78, 0x00,    //  178 A   410000001578   in-store item 157
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x15, 0x85, 0x00,    //  179 A   410000001585   in-store item 158
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x15, 0x92, 0x00,    //  180 A   410000001592   in-store item 159
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x16, 0x08, 0x00,    //  181 A   410000001608   in-store item 160
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x16, 0x15, 0x00,    //  182 A   410000001615   in-store item 161
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x16, 0x22, 0x00,    //  183 A   410000001622   in-store item 162
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x16, 0x39, 0x00,    //  184 A   410000001639   in-store item 163
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x16, 0x46, 0x00,    //  185 A   410000001646   in-store item 164
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x16, 0x53, 0x00,    //  186 A   410000001653   in-store item 165
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x16, 0x60, 0x00,    //  187 A   410000001660   in-store item 166
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x16, 0x77, 0x00,    //  188 A   410000001677   in-store item 167
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x16, 0x84, 0x00,    //  189 A   410000001684   in-store item 168
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x16, 0x91, 0x00,    //  190 A   410000001691   in-store item 169
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x17, 0x07, 0x00,    //  191 A   410000001707   in-store item 170
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x17, 0x14, 0x00,    //  192 A   410000001714   in-store item 171
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x17, 0x21, 0x00,    //  193 A   410000001721   in-store item 172
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x17, 0x38, 0x00,    //  194 A   410000001738   in-store item 173
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x17, 0x45, 0x00,    //  195 A   410000001745   in-store item 174
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x17, 0x52, 0x00,    //  196 A   410000001752   in-store item 175
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x17, 0x69, 0x00,    //  197 A   410000001769   in-store item 176
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x17, 0x76, 0x00,    //  198 A   410000001776   in-store item 177
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x17, 0x83, 0x00,    //  199 A   410000001783   in-store item 178
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x17, 0x90, 0x00,    //  200 A   410000001790   in-store item 179
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x18, 0x06, 0x00,    //  201 A   410000001806   in-store item 180
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x18, 0x13, 0x00,    //  202 A   410000001813   in-store item 181
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x18, 0x20, 0x00,    //  203 A   410000001820   in-store item 182
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x18, 0x37, 0x00,    //  204 A   410000001837   in-store item 183
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x18, 0x44, 0x00,    //  205 A   410000001844   in-store item 184
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x18, 0x51, 0x00,    //  206 A   410000001851   in-store item 185
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x18, 0x68, 0x00,    //  207 A   410000001868   in-store item 186
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x18, 0x75, 0x00,    //  208 A   410000001875   in-store item 187
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x18, 0x82, 0x00,    //  209 A   410000001882   in-store item 188
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x18, 0x99, 0x00,    //  210 A   410000001899   in-store item 189
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x19, 0x05, 0x00,    //  211 A   410000001905   in-store item 190
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x19, 0x12, 0x00,    //  212 A   410000001912   in-store item 191
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x19, 0x29, 0x00,    //  213 A   410000001929   in-store item 192
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x19, 0x36, 0x00,    //  214 A   410000001936   in-store item 193
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x19, 0x43, 0x00,    //  215 A   410000001943   in-store item 194
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x19, 0x50, 0x00,    //  216 A   410000001950   in-store item 195
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x19, 0x67, 0x00,    //  217 A   410000001967   in-store item 196
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x19, 0x74, 0x00,    //  218 A   410000001974   in-store item 197
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x19, 0x81, 0x00,    //  219 A   410000001981   in-store item 198
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x19, 0x98, 0x00,    //  220 A   410000001998   in-store item 199
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x20, 0x01, 0x00,    //  221 A   410000002001   in-store item 200
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x20, 0x18, 0x00,    //  222 A   410000002018   in-store item 201
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x20, 0x25, 0x00,    //  223 A   410000002025   in-store item 202
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x20, 0x32, 0x00,    //  224 A   410000002032   in-store item 203
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x20, 0x49, 0x00,    //  225 A   410000002049   in-store item 204
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x20, 0x56, 0x00,    //  226 A   410000002056   in-store item 205
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x20, 0x63, 0x00,    //  227 A   410000002063   in-store item 206
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x20, 0x70, 0x00,    //  228 A   410000002070   in-store item 207
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x20, 0x87, 0x00,    //  229 A   410000002087   in-store item 208
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x20, 0x94, 0x00,    //  230 A   410000002094   in-store item 209
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x21, 0x00, 0x00,    //  231 A   410000002100   in-store item 210
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x21, 0x17, 0x00,    //  232 A   410000002117   in-store item 211
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x21, 0x24, 0x00,    //  233 A   410000002124   in-store item 212
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x21, 0x31, 0x00,    //  234 A   410000002131   in-store item 213
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x21, 0x48, 0x00,    //  235 A   410000002148   in-store item 214
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x21, 0x55, 0x00,    //  236 A   410000002155   in-store item 215
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x21, 0x62, 0x00,    //  237 A   410000002162   in-store item 216
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x21, 0x79, 0x00,    //  238 A   410000002179   in-store item 217
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x21, 0x86, 0x00,    //  239 A   410000002186   in-store item 218
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x21, 0x93, 0x00,    //  240 A   410000002193   in-store item 219
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x22, 0x09, 0x00,    //  241 A   410000002209   in-store item 220
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x22, 0x16, 0x00,    //  242 A   410000002216   in-store item 221
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x22, 0x23, 0x00,    //  243 A   410000002223   in-store item 222
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x22, 0x30, 0x00,    //  244 A   410000002230   in-store item 223
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x22, 0x47, 0x00,    //  245 A   410000002247   in-store item 224
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x22, 0x54, 0x00,    //  246 A   410000002254   in-store item 225
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x22, 0x61, 0x00,    //  247 A   410000002261   in-store item 226
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x22, 0x78, 0x00,    //  248 A   410000002278   in-store item 227
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x22, 0x85, 0x00,    //  249 A   410000002285   in-store item 228
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x22, 0x92, 0x00,    //  250 A   410000002292   in-store item 229
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x23, 0x08, 0x00,    //  251 A   410000002308   in-store item 230
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x23, 0x15, 0x00,    //  252 A   410000002315   in-store item 231
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x23, 0x22, 0x00,    //  253 A   410000002322   in-store item 232
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x23, 0x39, 0x00,    //  254 A   410000002339   in-store item 233
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x23, 0x46, 0x00,    //  255 A   410000002346   in-store item 234
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x23, 0x53, 0x00,    //  256 A   410000002353   in-store item 235
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x23, 0x60, 0x00,    //  257 A   410000002360   in-store item 236
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x23, 0x77, 0x00,    //  258 A   410000002377   in-store item 237
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x23, 0x84, 0x00,    //  259 A   410000002384   in-store item 238
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x23, 0x91, 0x00,    //  260 A   410000002391   in-store item 239
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x24, 0x07, 0x00,    //  261 A   410000002407   in-store item 240
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x24, 0x14, 0x00,    //  262 A   410000002414   in-store item 241
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x24, 0x21, 0x00,    //  263 A   410000002421   in-store item 242
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x24, 0x38, 0x00,    //  264 A   410000002438   in-store item 243
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x24, 0x45, 0x00,    //  265 A   410000002445   in-store item 244
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x24, 0x52, 0x00,    //  266 A   410000002452   in-store item 245
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x24, 0x69, 0x00,    //  267 A   410000002469   in-store item 246
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x24, 0x76, 0x00,    //  268 A   410000002476   in-store item 247
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x24, 0x83, 0x00,    //  269 A   410000002483   in-store item 248
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x24, 0x90, 0x00,    //  270 A   410000002490   in-store item 249
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x25, 0x06, 0x00,    //  271 A   410000002506   in-store item 250
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x25, 0x13, 0x00,    //  272 A   410000002513   in-store item 251
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x25, 0x20, 0x00,    //  273 A   410000002520   in-store item 252
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x25, 0x37, 0x00,    //  274 A   410000002537   in-store item 253
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x25, 0x44, 0x00,    //  275 A   410000002544   in-store item 254
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x25, 0x51, 0x00,    //  276 A   410000002551   in-store item 255
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x25, 0x68, 0x00,    //  277 A   410000002568   in-store item 256
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x25, 0x75, 0x00,    //  278 A   410000002575   in-store item 257
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x25, 0x82, 0x00,    //  279 A   410000002582   in-store item 258
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x25, 0x99, 0x00,    //  280 A   410000002599   in-store item 259
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x26, 0x05, 0x00,    //  281 A   410000002605   in-store item 260
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x26, 0x12, 0x00,    //  282 A   410000002612   in-store item 261
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x26, 0x29, 0x00,    //  283 A   410000002629   in-store item 262
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x26, 0x36, 0x00,    //  284 A   410000002636   in-store item 263
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x26, 0x43, 0x00,    //  285 A   410000002643   in-store item 264
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x26, 0x50, 0x00,    //  286 A   410000002650   in-store item 265
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x26, 0x67, 0x00,    //  287 A   410000002667   in-store item 266
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x26, 0x74, 0x00,    //  288 A   410000002674   in-store item 267
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x26, 0x81, 0x00,    //  289 A   410000002681   in-store item 268
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x26, 0x98, 0x00,    //  290 A   410000002698   in-store item 269
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x27, 0x04, 0x00,    //  291 A   410000002704   in-store item 270
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x27, 0x11, 0x00,    //  292 A   410000002711   in-store item 271
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x27, 0x28, 0x00,    //  293 A   410000002728   in-store item 272
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x27, 0x35, 0x00,    //  294 A   410000002735   in-store item 273
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x27, 0x42, 0x00,    //  295 A   410000002742   in-store item 274
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x27, 0x59, 0x00,    //  296 A   410000002759   in-store item 275
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x27, 0x66, 0x00,    //  297 A   410000002766   in-store item 276
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x27, 0x73, 0x00,    //  298 A   410000002773   in-store item 277
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x27, 0x80, 0x00,    //  299 A   410000002780   in-store item 278
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x27, 0x97, 0x00,    //  300 A   410000002797   in-store item 279
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x28, 0x03, 0x00,    //  301 A   410000002803   in-store item 280
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x28, 0x10, 0x00,    //  302 A   410000002810   in-store item 281
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x28, 0x27, 0x00,    //  303 A   410000002827   in-store item 282
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x28, 0x34, 0x00,    //  304 A   410000002834   in-store item 283
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x28, 0x41, 0x00,    //  305 A   410000002841   in-store item 284
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x28, 0x58, 0x00,    //  306 A   410000002858   in-store item 285
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x28, 0x65, 0x00,    //  307 A   410000002865   in-store item 286
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x28, 0x72, 0x00,    //  308 A   410000002872   in-store item 287
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x28, 0x89, 0x00,    //  309 A   410000002889   in-store item 288
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x28, 0x96, 0x00,    //  310 A   410000002896   in-store item 289
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x29, 0x02, 0x00,    //  311 A   410000002902   in-store item 290
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x29, 0x19, 0x00,    //  312 A   410000002919   in-store item 291
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x29, 0x26, 0x00,    //  313 A   410000002926   in-store item 292
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x29, 0x33, 0x00,    //  314 A   410000002933   in-store item 293
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x29, 0x40, 0x00,    //  315 A   410000002940   in-store item 294
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x29, 0x57, 0x00,    //  316 A   410000002957   in-store item 295
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x29, 0x64, 0x00,    //  317 A   410000002964   in-store item 296
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x29, 0x71, 0x00,    //  318 A   410000002971   in-store item 297
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x29, 0x88, 0x00,    //  319 A   410000002988   in-store item 298
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x29, 0x95, 0x00,    //  320 A   410000002995   in-store item 299
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x30, 0x08, 0x00,    //  321 A   410000003008   in-store item 300
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x30, 0x15, 0x00,    //  322 A   410000003015   in-store item 301
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x30, 0x22, 0x00,    //  323 A   410000003022   in-store item 302
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x30, 0x39, 0x00,    //  324 A   410000003039   in-store item 303
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x30, 0x46, 0x00,    //  325 A   410000003046   in-store item 304
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x30, 0x53, 0x00,    //  326 A   410000003053   in-store item 305
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x30, 0x60, 0x00,    //  327 A   410000003060   in-store item 306
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x30, 0x77, 0x00,    //  328 A   410000003077   in-store item 307
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x30, 0x84, 0x00,    //  329 A   410000003084   in-store item 308
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x30, 0x91, 0x00,    //  330 A   410000003091   in-store item 309
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x31, 0x07, 0x00,    //  331 A   410000003107   in-store item 310
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x31, 0x14, 0x00,    //  332 A   410000003114   in-store item 311
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x31, 0x21, 0x00,    //  333 A   410000003121   in-store item 312
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x31, 0x38, 0x00,    //  334 A   410000003138   in-store item 313
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x31, 0x45, 0x00,    //  335 A   410000003145   in-store item 314
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x31, 0x52, 0x00,    //  336 A   410000003152   in-store item 315
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x31, 0x69, 0x00,    //  337 A   410000003169   in-store item 316
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x31, 0x76, 0x00,    //  338 A   410000003176   in-store item 317
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x31, 0x83, 0x00,    //  339 A   410000003183   in-store item 318
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x31, 0x90, 0x00,    //  340 A   410000003190   in-store item 319
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x32, 0x06, 0x00,    //  341 A   410000003206   in-store item 320
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x32, 0x13, 0x00,    //  342 A   410000003213   in-store item 321
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x32, 0x20, 0x00,    //  343 A   410000003220   in-store item 322
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x32, 0x37, 0x00,    //  344 A   410000003237   in-store item 323
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x32, 0x44, 0x00,    //  345 A   410000003244   in-store item 324
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x32, 0x51, 0x00,    //  346 A   410000003251   in-store item 325
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x32, 0x68, 0x00,    //  347 A   410000003268   in-store item 326
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x32, 0x75, 0x00,    //  348 A   410000003275   in-store item 327
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x32, 0x82, 0x00,    //  349 A   410000003282   in-store item 328
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x32, 0x99, 0x00,    //  350 A   410000003299   in-store item 329
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x33, 0x05, 0x00,    //  351 A   410000003305   in-store item 330
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x33, 0x12, 0x00,    //  352 A   410000003312   in-store item 331
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x33, 0x29, 0x00,    //  353 A   410000003329   in-store item 332
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x33, 0x36, 0x00,    //  354 A   410000003336   in-store item 333
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x33, 0x43, 0x00,    //  355 A   410000003343   in-store item 334
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x33, 0x50, 0x00,    //  356 A   410000003350   in-store item 335
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x33, 0x67, 0x00,    //  357 A   410000003367   in-store item 336
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x33, 0x74, 0x00,    //  358 A   410000003374   in-store item 337
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x33, 0x81, 0x00,    //  359 A   410000003381   in-store item 338
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x33, 0x98, 0x00,    //  360 A   410000003398   in-store item 339
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x34, 0x04, 0x00,    //  361 A   410000003404   in-store item 340
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x34, 0x11, 0x00,    //  362 A   410000003411   in-store item 341
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x34, 0x28, 0x00,    //  363 A   410000003428   in-store item 342
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x34, 0x35, 0x00,    //  364 A   410000003435   in-store item 343
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x34, 0x42, 0x00,    //  365 A   410000003442   in-store item 344
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x34, 0x59, 0x00,    //  366 A   410000003459   in-store item 345
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x34, 0x66, 0x00,    //  367 A   410000003466   in-store item 346
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x34, 0x73, 0x00,    //  368 A   410000003473   in-store item 347
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x34, 0x80, 0x00,    //  369 A   410000003480   in-store item 348
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x34, 0x97, 0x00,    //  370 A   410000003497   in-store item 349
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x35, 0x03, 0x00,    //  371 A   410000003503   in-store item 350
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x35, 0x10, 0x00,    //  372 A   410000003510   in-store item 351
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x35, 0x27, 0x00,    //  373 A   410000003527   in-store item 352
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x35, 0x34, 0x00,    //  374 A   410000003534   in-store item 353
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x35, 0x41, 0x00,    //  375 A   410000003541   in-store item 354
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x35, 0x58, 0x00,    //  376 A   410000003558   in-store item 355
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x35, 0x65, 0x00,    //  377 A   410000003565   in-store item 356
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x35, 0x72, 0x00,    //  378 A   410000003572   in-store item 357
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x35, 0x89, 0x00,    //  379 A   410000003589   in-store item 358
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x35, 0x96, 0x00,    //  380 A   410000003596   in-store item 359
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x36, 0x02, 0x00,    //  381 A   410000003602   in-store item 360
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x36, 0x19, 0x00,    //  382 A   410000003619   in-store item 361
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x36, 0x26, 0x00,    //  383 A   410000003626   in-store item 362
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x36, 0x33, 0x00,    //  384 A   410000003633   in-store item 363
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x36, 0x40, 0x00,    //  385 A   410000003640   in-store item 364
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x36, 0x57, 0x00,    //  386 A   410000003657   in-store item 365
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x36, 0x64, 0x00,    //  387 A   410000003664   in-store item 366
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x36, 0x71, 0x00,    //  388 A   410000003671   in-store item 367
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x36, 0x88, 0x00,    //  389 A   410000003688   in-store item 368
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x36, 0x95, 0x00,    //  390 A   410000003695   in-store item 369
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x37, 0x01, 0x00,    //  391 A   410000003701   in-store item 370
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x37, 0x18, 0x00,    //  392 A   410000003718   in-store item 371
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x37, 0x25, 0x00,    //  393 A   410000003725   in-store item 372
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x37, 0x32, 0x00,    //  394 A   410000003732   in-store item 373
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x37, 0x49, 0x00,    //  395 A   410000003749   in-store item 374
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x37, 0x56, 0x00,    //  396 A   410000003756   in-store item 375
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x37, 0x63, 0x00,    //  397 A   410000003763   in-store item 376
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x37, 0x70, 0x00,    //  398 A   410000003770   in-store item 377
+  0x0c, 0x41, 0x00, 0x00, 0x00, 0x37, 0x87, 0x00,    //  399 A   410000003787   in-store item 378
+};
+
+const uint16_t  pluHashIndex[PLU_HASH_SIZE] PROGMEM = {
+  30, 109, 16, 86, 0, 0, 0, 0, 370, 75, 0, 0, 0, 0, 338, 0,
+  0, 93, 159, 0, 339, 0, 0, 0, 0, 0, 0, 0, 0, 228, 277, 0,
+  324, 0, 0, 0, 388, 142, 0, 0, 0, 292, 342, 0, 144, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 45, 98, 137, 329, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 196, 135, 343, 0, 0, 0, 254, 0, 0, 281, 0,
+  154, 0, 0, 0, 0, 253, 0, 37, 0, 0, 241, 34, 0, 0, 0, 0,
+  0, 211, 0, 0, 0, 0, 0, 0, 168, 0, 0, 0, 0, 239, 71, 0,
+  0, 0, 160, 0, 385, 0, 386, 0, 0, 0, 347, 13, 0, 172, 0, 0,
+  0, 83, 0, 237, 0, 0, 162, 0, 0, 0, 128, 165, 2, 147, 209, 232,
+  263, 352, 0, 0, 198, 0, 0, 0, 94, 0, 0, 0, 0, 0, 379, 0,
+  0, 0, 11, 194, 0, 0, 0, 293, 0, 0, 1, 199, 79, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 119, 127, 349, 0, 0, 0, 280, 155,
+  0, 0, 170, 0, 0, 0, 340, 269, 73, 285, 294, 0, 208, 0, 81, 27,
+  89, 214, 0, 0, 0, 0, 57, 0, 0, 0, 54, 251, 0, 0, 143, 0,
+  14, 0, 0, 0, 0, 0, 138, 0, 233, 0, 184, 106, 0, 157, 394, 3,
+  0, 0, 96, 0, 0, 0, 64, 0, 353, 0, 0, 180, 279, 182, 0, 0,
+  238, 40, 173, 175, 371, 0, 0, 0, 0, 0, 0, 0, 0, 72, 141, 224,
+  261, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 70, 121, 190,
+  171, 151, 126, 355, 29, 0, 0, 0, 0, 0, 0, 0, 0, 304, 0, 0,
+  0, 322, 358, 383, 0, 0, 0, 259, 341, 0, 0, 0, 0, 0, 0, 0,
+  114, 0, 262, 0, 0, 0, 0, 201, 0, 0, 0, 0, 0, 0, 212, 0,
+  0, 226, 52, 380, 220, 47, 0, 32, 36, 139, 258, 0, 0, 207, 0, 0,
+  0, 176, 0, 0, 0, 0, 0, 0, 0, 19, 244, 271, 332, 15, 390, 0,
+  188, 102, 111, 313, 0, 0, 133, 0, 0, 0, 0, 0, 0, 87, 286, 21,
+  0, 0, 0, 95, 0, 0, 0, 0, 0, 122, 0, 0, 53, 346, 76, 308,
+  206, 0, 0, 288, 0, 0, 0, 0, 0, 0, 255, 191, 213, 0, 0, 0,
+  82, 183, 0, 0, 0, 0, 0, 249, 0, 0, 230, 0, 0, 0, 131, 105,
+  0, 257, 318, 192, 50, 256, 295, 0, 302, 361, 204, 252, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 123, 0, 396, 23, 0, 348, 287, 0, 0, 345,
+  0, 161, 186, 0, 0, 0, 42, 0, 268, 0, 389, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 264, 0, 0, 0, 267, 35, 0, 0, 0, 116, 0,
+  0, 0, 0, 0, 0, 356, 0, 0, 367, 193, 0, 0, 0, 97, 84, 152,
+  354, 0, 0, 189, 0, 0, 0, 391, 103, 0, 38, 393, 290, 398, 0, 0,
+  0, 0, 0, 0, 0, 291, 0, 0, 78, 234, 265, 384, 315, 229, 0, 0,
+  17, 74, 41, 333, 0, 163, 250, 43, 275, 328, 215, 0, 0, 0, 0, 307,
+  0, 148, 20, 0, 49, 167, 0, 0, 323, 0, 0, 61, 145, 236, 0, 0,
+  0, 66, 0, 0, 298, 365, 274, 397, 0, 0, 0, 0, 0, 0, 0, 231,
+  310, 0, 0, 0, 46, 108, 0, 0, 0, 0, 0, 221, 0, 0, 225, 140,
+  381, 0, 0, 0, 266, 0, 0, 0, 0, 134, 0, 60, 260, 5, 223, 10,
+  115, 359, 0, 132, 0, 0, 0, 317, 110, 0, 0, 0, 0, 99, 0, 374,
+  25, 0, 0, 0, 31, 248, 0, 0, 6, 392, 48, 366, 0, 0, 0, 0,
+  312, 351, 375, 0, 0, 0, 240, 299, 88, 334, 0, 0, 0, 0, 0, 92,
+  24, 276, 362, 309, 177, 185, 195, 202, 296, 368, 0, 0, 0, 0, 0, 0,
+  0, 350, 0, 44, 0, 0, 0, 0, 0, 0, 136, 51, 246, 273, 289, 203,
+  0, 0, 65, 0, 0, 300, 200, 303, 0, 0, 314, 395, 0, 301, 0, 18,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 364, 0, 216, 0, 0, 150,
+  0, 0, 0, 0, 0, 0, 0, 0, 113, 69, 372, 0, 0, 158, 33, 0,
+  7, 305, 382, 218, 283, 0, 169, 0, 0, 0, 0, 0, 0, 0, 0, 179,
+  278, 0, 117, 164, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 245, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 39, 0, 0, 59, 120, 9, 174,
+  219, 130, 68, 326, 0, 320, 0, 0, 0, 0, 0, 62, 77, 91, 0, 0,
+  0, 0, 0, 0, 0, 0, 319, 344, 0, 0, 0, 243, 0, 377, 0, 0,
+  0, 0, 100, 181, 0, 369, 125, 270, 0, 0, 0, 311, 0, 0, 0, 118,
+  0, 0, 325, 0, 0, 0, 327, 282, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 335, 0, 156, 8, 0, 0, 0, 0, 0, 146,
+  272, 0, 373, 235, 331, 0, 0, 0, 28, 0, 0, 0, 0, 0, 0, 0,
+  0, 242, 0, 0, 0, 12, 63, 0, 0, 0, 0, 104, 101, 153, 306, 129,
+  217, 399, 149, 321, 0, 0, 0, 0, 205, 0, 0, 0, 124, 284, 26, 360,
+  247, 363, 0, 0, 336, 0, 0, 0, 0, 0, 0, 0, 67, 187, 0, 297,
+  0, 56, 0, 112, 222, 0, 0, 0, 0, 0, 0, 178, 357, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 197, 0, 0, 0, 0, 337, 0, 378,
+  0, 387, 58, 0, 0, 0, 316, 0, 0, 0, 376, 0, 0, 0, 0, 22,
+  55, 0, 0, 0, 4, 0, 0, 0, 166, 0, 0, 80, 0, 330, 0, 0,
+  0, 0, 90, 210, 0, 0, 107, 400, 0, 0, 85, 0, 0, 227, 0, 0,
+};
+
+#endif    // !defined(PLUCATALOG_H_INCLUDED)
@@ -0,0 +1,63 @@
+/*
+ * Packed format of the PLU catalog of the scanner simulator.
+ *
+ * The catalog, plucatalog.h, is generated from plucatalog.txt by the gencatalog
+ * program in the host folder and is kept in flash with PROGMEM. Each item is a
+ * fixed size record of PLU_RECORD_SIZE bytes so item n is found by multiplying
+ * rather than by searching:
+ *
+ *     byte 0      symbology index in the high 3 bits, number of digits in the low 5 bits
+ *     bytes 1-7   the barcode digits as BCD, two digits a byte with the first digit in
+ *                 the high nibble, up to PLU_MAX_DIGITS digits
+ *
+ * A UPC-A item takes 8 bytes of flash rather than the 36 bytes of SRAM it took as a
+ * ScannerData struct so the catalog can hold hundreds of items.
+ *
+ * To find an item by its barcode the generator also builds an open addressing hash
+ * table, pluHashIndex[], of PLU_HASH_SIZE entries each of which is 0 for an empty slot
+ * or the item index plus 1. pluHash() of the barcode digits gives the first slot to look
+ * at and the slots following are looked at in turn until the item or an empty slot is
+ * found. The table is at most half full so this is usually a slot or two.
+ *
+ * This header is used by both the sketch and the generator so it does not use any of
+ * the Arduino libraries.
+ */
+
+#if !defined(PLUFORMAT_H_INCLUDED)
+#define PLUFORMAT_H_INCLUDED
+
+#include <stdint.h>
+
+#define PLU_RECORD_SIZE     8
+#define PLU_MAX_DIGITS      14      // (PLU_RECORD_SIZE - 1) * 2, enough for a GTIN-14
+
+// the symbol characters, indexed by the high 3 bits of byte 0 of a record.
+//   - A   UPC-A, length 12
+//   - E   UPC-E, length 7
+//   - FF  JAN-8, EAN-8, length 9
+//   - F   Jan-13, EAN-13, length 13
+//   - B1  Code 39
+//   - B2  Interleaved 2 of 5
+//   - B3  Code 128
+//   - ]e0 RSS-14
+#define PLU_SYMBOLOGY_COUNT 8
+#define PLU_SYMBOLOGY_LIST  { "A", "E", "FF", "F", "B1", "B2", "B3", "]e0" }
+
+// hash of a string of barcode digits, the slot in pluHashIndex[] is the hash
+// masked by PLU_HASH_SIZE - 1.
+inline uint16_t pluHash (const char *pDigits, uint8_t nDigits)
+{
+  uint16_t  usHash = 5381;
+
+  for (uint8_t i = 0; i < nDigits; i++) {
+    usHash = (usHash << 5) + usHash + (uint8_t)pDigits[i];     // usHash * 33 + c
+  }
+  // mix the high bits into the low bits which select the slot. without this barcodes
+  // which differ only in the last digits, such as those of one manufacturer, cluster.
+  usHash ^= usHash >> 7;
+  usHash = (uint16_t)(usHash * 0x9e37u);
+  usHash ^= usHash >> 8;
+  return usHash;
+}
+
+#endif    // !defined(PLUFORMAT_H_INCLUDED)
@@ -0,0 +1,95 @@
+/*
+ * Frame builder for the NCR scanner messages of the scanner simulator.
+ *
+ * A scanner message is a two character message type, the message data such as the
+ * symbology characters and barcode digits of a scan, and an ETX. With the NCR 78xx
+ * format with BCC the ETX is followed by the BCC, the XOR of every byte of the message
+ * up to and including the ETX, as two lower case hex characters.
+ *
+ * The messages used to be formatted into a buffer with sprintf(), the BCC computed by
+ * going over the buffer again, and the BCC appended with another sprintf(). A ScanFrame
+ * instead writes each byte to its output, in the sketch the TxQueue of txqueue.h for the
+ * kind of message, and XORs the byte into the BCC as it goes so a message takes a single
+ * pass with no intermediate string and no printf. The barcode digits are unpacked from the
+ * PROGMEM catalog record as they are written rather than into a ScannerData first. The
+ * queue holds the message until loop() can move all of it to Serial.
+ *
+ * The output can be anything with a write(uint8_t) method so the host benchmark in the
+ * host folder can use a ScanFrame without the Arduino Serial.
+ *
+ * Usage:
+ *     ScanFrame< TxQueue<64> >  frame (txScans);
+ *
+ *     txScans.begin ();
+ *     frame.put_P (PSTR("08"));
+ *     frame.putRecord (pluRecords + iItem * PLU_RECORD_SIZE, symbologyList);
+ *     frame.end (true);
+ *     txScans.commit ();
+ */
+
+#if !defined(SCANFRAME_H_INCLUDED)
+#define SCANFRAME_H_INCLUDED
+
+#include "pluformat.h"
+
+// the longest message, a 2 character message type, a 3 character symbology, PLU_MAX_DIGITS
+// digits, the ETX, and a 2 character BCC.
+#define SCAN_FRAME_MAX  (2 + 3 + PLU_MAX_DIGITS + 1 + 2)
+
+const char scanHexDigits[16] PROGMEM = {
+  '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+template <class Out>     // the output, such as Serial, with a write(uint8_t) method
+class ScanFrame {
+  public:
+    explicit ScanFrame (Out &o) : out(o), uchBcc(0), nLength(0) {}
+
+    // write a byte of the message and add it to the BCC.
+    void put (uint8_t c) {
+      uchBcc ^= c;
+      out.write (c);
+      nLength++;
+    }
+
+    // write a zero terminated string in flash, made with PSTR() or PROGMEM.
+    void put_P (const char *pszFlash) {
+      uint8_t  c;
+      while ((c = pgm_read_byte (pszFlash++)) != 0) put (c);
+    }
+
+    // write the symbology characters and barcode digits of a catalog record in flash,
+    // see pluformat.h. symbolList is the PROGMEM table of symbology characters.
+    void putRecord (const uint8_t *pRecord, const char (*symbolList)[4]) {
+      uint8_t  uchHead = pgm_read_byte (pRecord);
+      uint8_t  nDigits = uchHead & 0x1f;
+
+      put_P (symbolList[uchHead >> 5]);
+      for (uint8_t d = 0; d < nDigits; d += 2) {
+        uint8_t  uchBcd = pgm_read_byte (++pRecord);
+        put ('0' + (uchBcd >> 4));
+        if (d + 1 < nDigits) put ('0' + (uchBcd & 0x0f));
+      }
+    }
+
+    // end the message with the ETX and, if bSendBcc, the BCC. the BCC characters are
+    // not part of the BCC. returns the length of the message.
+    uint8_t end (bool bSendBcc) {
+      put (0x03);
+      if (bSendBcc) {
+        out.write ((uint8_t)pgm_read_byte (scanHexDigits + (uchBcc >> 4)));
+        out.write ((uint8_t)pgm_read_byte (scanHexDigits + (uchBcc & 0x0f)));
+        nLength += 2;
+      }
+      return nLength;
+    }
+
+    uint8_t bcc (void) const { return uchBcc; }
+
+  private:
+    Out     &out;
+    uint8_t  uchBcc;       // XOR of the bytes written so far
+    uint8_t  nLength;      // number of bytes written so far
+};
+
+#endif    // !defined(SCANFRAME_H_INCLUDED)
@@ -1,121 +1,191 @@
 /*
- * Scanner simulator built on the previous scale simulator.
+ * Scanner scale simulator built on the previous scale simulator.
  * 
- * This application turns an Arduino into a simulator for a barcode scanner scale
- * by sending a barcode in the proper message format.
- * 
- * The user interface needs the following changes:
- *  - need to handle button event to send a scan to the terminal
- *  - need to show the current PLU that will be sent
- *  - need a way to choose the current PLU
+ * This application turns an Arduino into a simulator for a barcode scanner scale,
+ * such as an NCR 78xx, which sends barcode scans and answers weight and status
+ * requests on the one serial port. A scan is sent when the button is pressed or by a
+ * burst and the point of sale requests the weight with the NCR 78xx scale commands.
+ *
+ * The scans and the replies are built into separate transmit queues and loop() sends
+ * whole messages from them as the Serial transmit buffer has room, the replies first,
+ * so neither kind of message waits for the other. See txqueue.h.
+ *
+ * The current PLU that will be sent is shown on the LCD and is chosen from the
+ * PLU catalog, plucatalog.h, with the keypad or with the P, F, and M commands.
  */
  
-byte incoming;
-String inBuffer;
-
-// table of scanner data. this determines values returned in a scan response.
-// the symChar indicates the symbology used for the barcode
-//   - A   UPC-A, length 12
-//   - E   UPC-E, length 7
-//   - FF  JAN-8, EAN-8, length 9
-//   - F   Jan-13, EAN-13, length 13
-//   - B1  Code 39
-//   - B2  Interleaved 2 of 5
-//   - B3  Code 128
-//   - ]e0 RSS-14
-
+// commands from the point of sale terminal are collected in a fixed size ring buffer
+// rather than a String so that no memory is allocated as characters are received.
+// a command longer than will fit is thrown away and counted as an overflow.
+#include <SimFramer.h>
+
+SimFramer<32>  cmdFramer;
+char  cmdBuffer[16];        // the command being handled
+
+// the PLU catalog of items which can be scanned. the catalog is kept in flash as packed
+// fixed size records along with a hash index for finding an item by its barcode, see
+// pluformat.h. plucatalog.h is generated from plucatalog.txt by host/gencatalog so add
+// items to plucatalog.txt and generate plucatalog.h again rather than editing it.
+#include "plucatalog.h"
+
+// an item of the catalog unpacked by pluGetItem() ready to send in a scan response.
+// the symChar indicates the symbology used for the barcode, see pluformat.h.
 struct ScannerData {
   char symChar[4];      // string representing symbology such as 'A' for UPC-A
-  char barcode[32];     // string of digits from the barcode
+  char barcode[PLU_MAX_DIGITS + 1];     // string of digits from the barcode
 };
 
-ScannerData pluList[] = {
-  {"A", "070177155766"},          //    Twinings English Afternoon tea 20 bags
-  {"A", "070177154240"},          //    Twinings Irish Breakfast tea 20 bags
-  {"A", "070177154127"},          //    Twinings Darjeeling tea 20 bags
-  {"A", "072310001893"},          //    Bigelow Plantation Mint tea 20 bags
-  {"A", "072310001978"},          //    Bigelow Lemon Lift tea 20 bags
-  {"A", "072310001053"},          //    Bigelow Constant Comment tea 20 bags
-  {"A", "747599303142"},          //    Ghirardelli Squares Dark Chocolate Sea Caramel
-  {"A", "046677426002"},          //    4 pack Philips EcoVantage Soft White 40w A19 bulbs
-  {"A", "046677426040"},          //    4 pack Philips Soft White 100w A19 bulbs
-  {"A", "086854005682"},          //    5.75 oz bottle Laura Lynn Manzanilla Olives with minced pimiento
-  {"A", "086854043622"},          //    8.5 oz bottle Laura Lynn extra virgin olive oil
-  {"A", "086854042311"},          //    14.5 oz can Laura Lynn diced tomatoes no salt added
-  {"A", "041443113421"},          //    14.5 oz can Margaret Holmes Italian Green Beans
-  {"A", "039400017066"},          //    16 oz can Bush's Reduced Sodium Garbanzos chick peas
-  {"A", "052000011227"},          //    15 oz can Van Camp's Pork and Beans in tomato sauce
-  {"A", "029000076501"},          //    16 oz Planters Dry Roasted Peanuts Lightly salted
-  {"A", "037000388517"},          //    Charmin Ultra Soft toilet tissue 6 roll Super Mega
-  {"A", "037000527787"},          //    Charmin Ultra Soft toilet tissue 6 roll Mega
-  {"A", "201404309526"},          //    container of beef loin 1.59lbs @ $5.99 (PLU, 01404 with price $9.52)
-  {"A", "200065109001"},          //    container London Broil 2.44lbs @ $3.69 (PLU, 00065 with price $9.00)
-  {"A", "206141306005"},          //    container deli lunch $6.00
-  {"E", "1215704"}                //    Aquafina bottled water 1L
-};
+const char symbologyList[PLU_SYMBOLOGY_COUNT][4] PROGMEM = PLU_SYMBOLOGY_LIST;
 
-unsigned char s1 = 0x30, s2 = 0x30;   // status byte 1 and status byte 2
+uint16_t  pluSelected = 0;    // index of the item sent by the next scan
+uint8_t   pluScanMode = 0;    // after a scan, 0 keep the same item, 1 select the next item, 2 select a random item
 
-struct {
-  char *specScan;
-  char *specStatus;
-  bool  bSendBcc;
-} specInUseFmt [] = {
-      //weight then units then status
-      { "18%s%s\x03", "14%c%c\x03", false},     // NCR 78xx without BCC appended to message
-      { "08%s%s\x03%2.2x", "14%c%c\x03", true}  // NCR 78xx with BCC appended to message
-};
+// unpack item iItem of the catalog. returns false if there is no such item.
+bool pluGetItem (uint16_t iItem, ScannerData &item)
+{
+  if (iItem >= PLU_COUNT) return false;
 
-char *lcdInfoFmt[] = {
-      // max of 16 characters for 16x2 LCD module
-      "%4.4d.%2.2d%-2.2s %2.2x %2.2x",    // SCP-01 specification for response
-      "%2.2d.%3.3d%-2.2s %2.2x %2.2x "    // SCP-02 specification for response
-};
+  const uint8_t *pRecord = pluRecords + iItem * PLU_RECORD_SIZE;
+  uint8_t  uchHead = pgm_read_byte(pRecord);
+  uint8_t  nDigits = uchHead & 0x1f;
+
+  memcpy_P (item.symChar, symbologyList[uchHead >> 5], sizeof(item.symChar));
+  for (uint8_t d = 0; d < nDigits; d++) {
+    uint8_t  uchBcd = pgm_read_byte(pRecord + 1 + d / 2);
+    item.barcode[d] = '0' + ((d & 1) ? (uchBcd & 0x0f) : (uchBcd >> 4));
+  }
+  item.barcode[nDigits] = 0;
+  return true;
+}
+
+// find the item whose barcode is the digits in pDigits using the hash index.
+// returns the index of the item or -1 if the barcode is not in the catalog.
+int pluFind (const char *pDigits)
+{
+  size_t  nDigits = strlen(pDigits);
 
-enum SpecInUse { Scp_01 = 0, Scp_02 = 1};
-SpecInUse  specInUse = Scp_02;
+  if (nDigits == 0 || nDigits > PLU_MAX_DIGITS) return -1;
+
+  // the index is at most half full so there is always an empty slot to end the search.
+  uint16_t  iSlot = pluHash(pDigits, (uint8_t)nDigits) & (PLU_HASH_SIZE - 1);
+  for ( ; ; iSlot = (iSlot + 1) & (PLU_HASH_SIZE - 1)) {
+    uint16_t  usEntry = pgm_read_word(&pluHashIndex[iSlot]);
+    ScannerData  item;
+
+    if (usEntry == 0) return -1;
+    pluGetItem(usEntry - 1, item);
+    if (strcmp(item.barcode, pDigits) == 0) return usEntry - 1;
+  }
+}
 
-// calculate the BCC or Block Check Character which is a
-// checksum on the message to send. It is added to the
-// message after the ETX character in the message.
-// See https://en.wikipedia.org/wiki/Binary_Synchronous_Communications
+// A burst replays scans as fast as the Serial port can send them, or at a set interval,
+// so that the item entry of the point of sale can be stressed with one simulator. The
+// scans are sent from loop() one at a time and only when the Serial transmit buffer
+// has room for the whole message so that the rest of loop() is never held up.
 //
-unsigned char ScannerScaleCalcBCC(unsigned char *puchData, short sLength)
+// The items scanned come from the basket, a list of catalog indexes set up with the K
+// command, in turn. If the basket is empty the selected item is scanned and the scan
+// mode set with the M command chooses the next item as it does for any other scan.
+#define BASKET_SIZE   32
+
+uint16_t  basketItems[BASKET_SIZE];   // catalog indexes of the items in the basket
+uint8_t   basketCount = 0;            // number of items in the basket
+uint8_t   basketNext = 0;             // index into basketItems[] of the next item of a burst
+
+unsigned long  burstRemaining = 0;    // number of scans left to send in the burst
+unsigned long  burstIntervalMsec = 0; // time between scans, 0 to send them back to back
+unsigned long  burstLastMsec = 0;     // millis() when the last scan of the burst was sent
+
+// select the item for the next scan according to the scan mode.
+void pluAfterScan (void)
 {
-    unsigned char   uchBCC = 0;
-    short   sIndex;
+  switch (pluScanMode) {
+    case 1:
+      pluSelected = (pluSelected + 1) % PLU_COUNT;
+      break;
+    case 2:
+      pluSelected = random(PLU_COUNT);
+      break;
+  }
+}
 
-    for (sIndex = 0; sIndex < sLength; sIndex++) {
-        uchBCC ^= *(puchData + sIndex);
-    }
+unsigned char s1 = 0x30, s2 = 0x30;   // status byte 1 and status byte 2
+
+// the scale. the weight is 0 to 99999 in the units the scale is set up for, hundredths
+// of a pound or thousandths of a kilogram. after the weight is changed with the W command
+// the weight is in motion for scaleSettleMsec as a real scale is while it settles. the
+// motion and zero weight bits of status byte 1 are set from the weight when a status is
+// sent, along with any bits set with the keypad.
+#define SCALE_STATUS_MOTION   0x01    // status byte 1, the weight is in motion
+#define SCALE_STATUS_ZERO     0x02    // status byte 1, the weight is zero
 
-    return (uchBCC);
+const unsigned long scaleSettleMsec = 500;
+
+unsigned long  scaleWeight = 0;       // the weight on the scale
+unsigned long  scaleChangeMsec = 0;   // millis() when the weight was last changed
+bool  scaleMonitor = false;           // a 14 command is waiting for a stable weight
+
+bool scaleStable (void)
+{
+  return millis() - scaleChangeMsec >= scaleSettleMsec;
 }
 
+// the messages are built into transmit queues rather than written to Serial so that
+// building a message never waits for the port. see serviceTx().
+#include "txqueue.h"
+
+TxQueue<64>  txReplies;     // replies to the commands of the point of sale
+TxQueue<64>  txScans;       // scans pushed by the button or a burst
+
+// the message formats. a scan is the message type, the symbology characters, the barcode
+// digits, and an ETX. a status is the message type, status bytes 1 and 2, and an ETX.
+// a weight is 11, the five digits of the weight, and an ETX. the messages are built by
+// a ScanFrame, see scanframe.h, which appends the BCC to a scan when the format has
+// bSendBcc. the status and weight messages have no BCC in either format.
+#include "scanframe.h"
+
+struct ScanSpec {
+  char  specScan[3];      // message type of a scan
+  char  specStatus[3];    // message type of a status
+  bool  bSendBcc;         // append the BCC to a scan
+};
+
+const ScanSpec specInUseFmt [] PROGMEM = {
+      { "18", "14", false },    // NCR 78xx without BCC appended to message
+      { "08", "14", true }      // NCR 78xx with BCC appended to message
+};
+
+enum SpecInUse { Ncr_78xx = 0, Ncr_78xx_Bcc = 1 };
+SpecInUse  specInUse = Ncr_78xx;
+
 #define USE_LCD         // use the 16x2 LCD as a display
 //#define USE_KEYPAD      // use the keypad for input selection
 #define USE_BUTTON      // use the button to trigger sending a scan
-#define USE_SERIAL      // use Serial for debugging prints
+// Serial is the port of the point of sale so debugging prints go to the terminal along with the
+// messages, ahead of the transmit queues, and wait for room in the transmit buffer. only for
+// debugging on the bench, never with a point of sale attached.
+//#define USE_SERIAL      // use Serial for debugging prints
 
 
 #if defined(USE_LCD)
 // A 16x2 LCD can be attached to the Arduino to show
-// status information. See format specifier lcdInfoFmt[] above.
-//  - d  -> a digit or a decimal point for the current weight setting
-//  - u  -> a letter of current weight units:  lb, kg
-//  - s  -> a letter of current scale specification
+// status information. See updateLCDInfo() below.
+//  - n  -> a digit of the catalog index of the item the next scan sends
+//  - b  -> a digit of the barcode of the item the next scan sends
 //  - i  -> a symbol representing current input status from keypad see handleKeyPad()
-//          R ready for weight request
-//          * clear key to restart the data entry sequence
-//          # change the units of measurement
+//          R ready for scan request
+//          * clear key to start entering the catalog index of an item
+//          # select the item whose catalog index was entered
 //          A set the status byte 1 value (0 - 3)
 //          B set the status byte 2 value (0 - 3)
-//          C set the specification to be used for response messages
-//  - m  -> a letter of a free form message
+//          C set the message format, 0 NCR 78xx, 1 NCR 78xx with BCC
+//          X a scan is being sent
+//          F the button was pressed but the scan queue is full, the scan is sent when there is room
+//  - w  -> a digit of the weight on the scale
 //
 //      00 01 02 03 04 05 06 07 08 09 10 11 12 13 14 15
-//  0    d  d  d  d  d  d  d  u  u     a  a  b  b  
-//  1    i  m  m  m  m  m  m  m  m  m  m  m  m  m  m  m
+//  0    n  n  n     b  b  b  b  b  b  b  b  b  b  b  b
+//  1    i     W     w  w  w  w  w
 
 #include <LiquidCrystal.h>
 
@@ -158,10 +228,24 @@ int setLcdIndicator (int c)
 
 int updateLCDInfo (void)
 {
-    char cBuff[32] = "Hello";
-          
+    char cBuff[32] = {0};
+    ScannerData  item;
+
+    // the catalog index and barcode of the item the next scan sends.
+    pluGetItem (pluSelected, item);
+    snprintf (cBuff, sizeof(cBuff), "%-3u %-12.12s", pluSelected, item.barcode);
+
+#if defined(USE_LCD)
+    lcd.setCursor(0,0);
+    lcd.print(cBuff);
+#endif
+#if defined(USE_SERIAL)
+    Serial.println(cBuff);
+#endif
+
+    snprintf (cBuff, sizeof(cBuff), "W %5.5lu", scaleWeight);
 #if defined(USE_LCD)
-    lcd.setCursor(1,0);
+    lcd.setCursor(2,1);
     lcd.print(cBuff);
 #endif
 #if defined(USE_SERIAL)
@@ -181,13 +265,56 @@ int updateLCDInfo (void)
 // is wired to the sensing pin on the Arduino. There is a pulldown
 // resistor of 10KOhm connected between the second pole and ground.
 //
-// The button has a debouncing delay so that the button state is sensed
-// only so often in order to give a person time to press the button and
-// release it in order to trigger only a single scan event.
+// The button is debounced with a state machine driven by millis() rather than
+// with a delay() so that the Serial port is still handled while the button is
+// pressed. A press must read HIGH for buttonDebounceMsec before it triggers a
+// scan, and it triggers only the one scan however long it is held. The button
+// must then read LOW for buttonDebounceMsec before another press is seen.
 
 const int buttonPin = 10;    // the pin number the pushbutton is connected to
-int buttonState = 0;         // variable for reading the pushbutton status
-const unsigned long buttondelay = 250;  // milliseconds of delay for debouncing
+const unsigned long buttonDebounceMsec = 20;  // milliseconds the button must be steady
+
+enum ButtonState { ButtonUp, ButtonGoingDown, ButtonDown, ButtonGoingUp };
+ButtonState  buttonState = ButtonUp;
+unsigned long  buttonChangeMsec = 0;   // millis() when the button last changed
+
+// returns true once for each debounced press of the button.
+bool buttonPressed (void)
+{
+  int  iPin = digitalRead(buttonPin);
+  unsigned long  ulNow = millis();
+
+  switch (buttonState) {
+    case ButtonUp:
+      if (iPin == HIGH) {
+        buttonState = ButtonGoingDown;
+        buttonChangeMsec = ulNow;
+      }
+      break;
+    case ButtonGoingDown:
+      if (iPin == LOW) {
+        buttonState = ButtonUp;       // a bounce or noise, not a press
+      } else if (ulNow - buttonChangeMsec >= buttonDebounceMsec) {
+        buttonState = ButtonDown;
+        return true;
+      }
+      break;
+    case ButtonDown:
+      if (iPin == LOW) {
+        buttonState = ButtonGoingUp;
+        buttonChangeMsec = ulNow;
+      }
+      break;
+    case ButtonGoingUp:
+      if (iPin == HIGH) {
+        buttonState = ButtonDown;     // still held, a bounce on release
+      } else if (ulNow - buttonChangeMsec >= buttonDebounceMsec) {
+        buttonState = ButtonUp;
+      }
+      break;
+  }
+  return false;
+}
 
 #endif
 
@@ -217,8 +344,9 @@ byte colPins[COLS] = {5, 4, 3, 2}; //connect to the column pinouts of the keypad
 //initialize an instance of class NewKeypad
 Keypad customKeypad = Keypad( makeKeymap(hexaKeys), rowPins, colPins, ROWS, COLS);
 
-short lbNdx = 0;    // index for keypad data entry into lb1 and lb2 to change weight
+short lbNdx = 0;    // index for keypad data entry of a catalog index, 100 to ignore digits
 short stNdx = 0;    // set status indicator, 0 no set, 1 set byte 1, 2 set byte 2, 100 set Spec in use
+unsigned long pluEntry = 0;   // catalog index being entered with the keypad
 
 void handleKeyPad ()
 {
@@ -227,13 +355,17 @@ void handleKeyPad ()
   if (customKey){
     switch (customKey) {
     case '*':     // clear key to restart the data entry sequence
-        lbNdx = 0;        // set the weight entry state indicator to allow input
-        stNdx = 0;        // set the stNdx state indicator indicating weight entry
+        lbNdx = 0;        // set the catalog index entry state indicator to allow input
+        stNdx = 0;        // set the stNdx state indicator indicating catalog index entry
+        pluEntry = 0;
         setLcdIndicator('*');
         break;
-    case '#':     // change the units of measurement
+    case '#':     // select the item whose catalog index was entered
+        if (lbNdx > 0 && lbNdx < 100 && pluEntry < PLU_COUNT) {
+          pluSelected = pluEntry;
+        }
         stNdx = 0;          // reset the stNdx state indicator as we are done
-        lbNdx = 100;        // set the weight entry state indicator to ignore input
+        lbNdx = 100;        // set the catalog index entry state indicator to ignore input
         updateLCDInfo();
         setLcdIndicator('R');
         break;
@@ -260,7 +392,7 @@ void handleKeyPad ()
         break;
     case '0':
         if (stNdx == 100) {
-          specInUse = Scp_01;
+          specInUse = Ncr_78xx;
           stNdx = 0;          // reset the stNdx state indicator as we are done
           lbNdx = 100;        // set the weight entry state indicator to ignore input
           updateLCDInfo();
@@ -269,7 +401,7 @@ void handleKeyPad ()
         }
     case '1':
         if (stNdx == 100) {
-          specInUse = Scp_02;
+          specInUse = Ncr_78xx_Bcc;
           stNdx = 0;          // reset the stNdx state indicator as we are done
           lbNdx = 100;        // set the weight entry state indicator to ignore input
           updateLCDInfo();
@@ -302,39 +434,223 @@ void handleKeyPad ()
           break;
         }
 
+        if (lbNdx < 5) {
+          pluEntry *= 10;
+          pluEntry += customKey - '0';
+          lbNdx++;
+        }
         break;  
     }
   }
 }
 #endif    // defined(USE_KEYPAD)
 
-void handle_command(const String &inCommand) {
+// queue the scan message for the selected item and select the item for the
+// next scan. returns false if there was no room for the scan.
+bool sendScan (void)
+{
+  ScanFrame< TxQueue<64> >  frame (txScans);
+
+  txScans.begin ();
+  frame.put_P (specInUseFmt[specInUse].specScan);
+  frame.putRecord (pluRecords + pluSelected * PLU_RECORD_SIZE, symbologyList);
+  frame.end (pgm_read_byte (&specInUseFmt[specInUse].bSendBcc));
+  if (!txScans.commit ()) return false;
+  pluAfterScan ();
+  return true;
+}
+
+// queue the status message. the two formats have the same status message.
+void sendStatus (void)
+{
+  ScanFrame< TxQueue<64> >  frame (txReplies);
+  unsigned char  uchStatus1 = s1;
+
+  if (!scaleStable ()) uchStatus1 |= SCALE_STATUS_MOTION;
+  if (scaleWeight == 0) uchStatus1 |= SCALE_STATUS_ZERO;
+
+  txReplies.begin ();
+  frame.put_P (specInUseFmt[specInUse].specStatus);
+  frame.put (uchStatus1);
+  frame.put (s2);
+  frame.end (false);
+  txReplies.commit ();
+}
+
+// queue the reply to a weight request, the weight if it is stable and not zero
+// and otherwise the status which tells why there is no weight.
+void sendWeight (void)
+{
+  ScanFrame< TxQueue<64> >  frame (txReplies);
+  unsigned long  ulDigits = scaleWeight;
+  char  achDigits[5];
+
+  if (!scaleStable () || scaleWeight == 0) {
+    sendStatus ();
+    return;
+  }
+
+  for (int i = 4; i >= 0; i--, ulDigits /= 10) achDigits[i] = '0' + ulDigits % 10;
+  txReplies.begin ();
+  frame.put ('1');
+  frame.put ('1');
+  for (int i = 0; i < 5; i++) frame.put (achDigits[i]);
+  frame.end (false);
+  txReplies.commit ();
+}
+
+// queue a reply which has been formatted into a string.
+void sendReply (const char *pszReply)
+{
+  txReplies.begin ();
+  txReplies.write (pszReply, (uint8_t)strlen (pszReply));
+  txReplies.commit ();
+}
+
+// answer a 14 scale monitor command once the weight is stable and not zero.
+void serviceScale (void)
+{
+  if (scaleMonitor && scaleStable () && scaleWeight != 0 && txReplies.room () >= 8) {
+    scaleMonitor = false;
+    sendWeight ();
+  }
+}
+
+// the dispatcher. moves whole messages from the transmit queues to Serial when the
+// transmit buffer has room for them, the replies to the point of sale first so that a
+// burst of scans does not hold up a weight reply.
+void serviceTx (void)
+{
+  while (txReplies.send (Serial)) ;
+  while (txScans.send (Serial)) ;
+}
+
+// send the next scan of a burst if it is time and there is room for it.
+void serviceBurst (void)
+{
+  if (burstRemaining == 0) return;
+  if (burstIntervalMsec && millis() - burstLastMsec < burstIntervalMsec) return;
+  if (txScans.room () < SCAN_FRAME_MAX) return;
+
+  if (basketCount) {
+    pluSelected = basketItems[basketNext];
+    basketNext = (basketNext + 1) % basketCount;
+  }
+  sendScan ();
+  burstLastMsec = millis();
+  burstRemaining--;
+}
+
+void handle_command(const char *inCommand) {
     char cBuff[64] = {0};
 
 #if defined(USE_SERIAL)
     Serial.println(inCommand);
 #endif
     switch (inCommand[0]) {
-      case 0x31:    // status command
+      case 0x31:    // NCR 78xx scale commands
 #if defined(USE_SERIAL)
         Serial.println("0x31 command");
 #endif
-        if (inCommand[1] == 0x33) {
-          sprintf (cBuff, specInUseFmt[0].specStatus, s1, s2);
+        if (inCommand[1] == 0x31) {           // 11 weight request
+          sendWeight ();
+        } else if (inCommand[1] == 0x33) {    // 13 status request
+          sendStatus ();
+        } else if (inCommand[1] == 0x34) {    // 14 scale monitor, send the weight once it is stable
+          scaleMonitor = true;
+          serviceScale ();
         } else {
-          sprintf (cBuff, specInUseFmt[0].specScan, pluList[0].symChar, pluList[0].barcode);
+          sprintf (cBuff, "\n?\r\x03");
         }
         break;
       case 'S':    // status command
       case 's':
-        sprintf (cBuff, specInUseFmt[specInUse].specStatus, s1, s2);
+        sendStatus ();
+        break;
+
+      // the W command is not part of the scanner protocol. a test harness uses it to put
+      // a weight on the scale, W<weight>, and it responds with W, the weight, and ETX.
+      case 'W':
+      case 'w':
+        if (isdigit (inCommand[1]) && atol (inCommand + 1) <= 99999) {
+          scaleWeight = atol (inCommand + 1);
+          scaleChangeMsec = millis();
+          sprintf (cBuff, "W%lu\x03", scaleWeight);
+          updateLCDInfo();
+        } else {
+          sprintf (cBuff, "W?\x03");
+        }
+        break;
+
+      // the following commands are not part of the scanner protocol. they are used by a
+      // test harness to choose the items scanned. each responds with the selected item,
+      // P<index> <symbology><barcode><ETX>, or with P?<ETX> if there is no such item.
+      case 'P':    // select the item by its catalog index, P<index>
+      case 'p':
+      case 'F':    // find the item by its barcode and select it, F<barcode digits>
+      case 'f':
+      case 'M':    // set the scan mode, M0 same item, M1 next item, M2 random item after each scan
+      case 'm':
+        {
+          ScannerData  item;
+          long  lItem = pluSelected;
+
+          if (inCommand[0] == 'P' || inCommand[0] == 'p') {
+            lItem = (inCommand[1] >= '0' && inCommand[1] <= '9') ? atol (inCommand + 1) : -1;
+          } else if (inCommand[0] == 'F' || inCommand[0] == 'f') {
+            lItem = pluFind (inCommand + 1);
+          } else if (inCommand[1] >= '0' && inCommand[1] <= '2') {
+            pluScanMode = inCommand[1] - '0';
+          }
+
+          if (lItem >= 0 && pluGetItem ((uint16_t)lItem, item)) {
+            pluSelected = (uint16_t)lItem;
+            sprintf (cBuff, "P%u %s%s\x03", pluSelected, item.symChar, item.barcode);
+            updateLCDInfo();
+          } else {
+            sprintf (cBuff, "P?\x03");
+          }
+        }
+        break;
+      case 'K':    // add the item with the catalog index to the basket, K<index>, or empty the basket, K
+      case 'k':
+        if (inCommand[1] == 0) {
+          basketCount = basketNext = 0;
+          sprintf (cBuff, "K0\x03");
+        } else if (basketCount < BASKET_SIZE && isdigit (inCommand[1]) && atol (inCommand + 1) < PLU_COUNT) {
+          basketItems[basketCount++] = (uint16_t)atol (inCommand + 1);
+          sprintf (cBuff, "K%u\x03", basketCount);
+        } else {
+          sprintf (cBuff, "K?\x03");
+        }
+        break;
+      case 'C':    // set the message format, C0 NCR 78xx, C1 NCR 78xx with BCC
+      case 'c':
+        if (inCommand[1] == '0' || inCommand[1] == '1') {
+          specInUse = (inCommand[1] == '0') ? Ncr_78xx : Ncr_78xx_Bcc;
+          sprintf (cBuff, "C%c\x03", inCommand[1]);
+        } else {
+          sprintf (cBuff, "C?\x03");
+        }
+        break;
+      case 'B':    // send a burst of scans, B<count>[,<msec between scans>], or stop a burst, B0
+      case 'b':
+        {
+          const char  *pComma = strchr (inCommand, ',');
+
+          burstRemaining = strtoul (inCommand + 1, 0, 10);
+          burstIntervalMsec = pComma ? strtoul (pComma + 1, 0, 10) : 0;
+          burstLastMsec = millis() - burstIntervalMsec;     // the first scan goes right away
+          basketNext = 0;
+          sprintf (cBuff, "B%lu\x03", burstRemaining);
+        }
         break;
       default:     // unrecognized command
         sprintf (cBuff, "\n?\r\x03");
         break;
     }
     
-    Serial.print(cBuff);
+    if (cBuff[0]) sendReply (cBuff);
 #if defined(USE_SERIAL)
     Serial.println("");
 #endif
@@ -346,6 +662,8 @@ void setup() {
 
   delay (1000);
 
+  randomSeed(micros());     // for scan mode 2, a random item after each scan
+
 #if defined(USE_LCD)
   updateLCDInfo();
   setLcdIndicator('R');
@@ -358,39 +676,85 @@ void setup() {
 
 }
 
-void loop() {
-   // put your main code here, to run repeatedly:
-
-#if defined(USE_KEYPAD)
-   handleKeyPad();
-#endif
+// the work of the simulator is done by the tasks of a cooperative task runtime, see
+// libraries/TaskRuntime, each task doing a little work each pass of loop() and
+// returning. a scale request or a command should be seen within 2 msec, the deadline
+// of the commands task, and the queued messages sent as soon as Serial has room.
+#include <TaskRuntime.h>
 
 #if defined(USE_BUTTON)
-    // read the state of the pushbutton value:
-    buttonState = digitalRead(buttonPin);
-    
-    if (buttonState) {
-      delay(buttondelay);
+// a debounced press of the button is a scan of the selected item. if txScans has no room,
+// during a burst, the press is kept and the scan queued once there is room, with F shown
+// on the LCD meanwhile.
+bool  buttonPending = false;
+
+void TaskButton (void)
+{
+    if (buttonPressed()) {
+      buttonPending = true;
+      if (txScans.room () < SCAN_FRAME_MAX) setLcdIndicator('F');
+    }
+    if (buttonPending && txScans.room () >= SCAN_FRAME_MAX) {
+      buttonPending = false;
       setLcdIndicator('X');
-      handle_command("11");
-      // Clear the string for the next command
-      inBuffer = "";
+      sendScan();
       setLcdIndicator('R');
     }
+}
 #endif
 
-   // setup as non-blocking code
-   incoming = Serial.read();
-   if(incoming < 255) {
-         if(incoming == '\n' || incoming == '\r' || incoming == '\x03') {  // newline, carriage return, both, or custom character
-            // handle the incoming command
-            handle_command(inBuffer);
-
-            // Clear the string for the next command
-            inBuffer = "";
-        } else{
-            // add the character to the buffer
-            inBuffer += (char)incoming;
-        }
-    }
+// take everything the Serial port has received and handle each command as soon as its
+// terminator arrives. the receive buffer of the Serial port holds more than the ring buffer
+// of cmdFramer so a burst of pipelined commands would overflow it if they were all taken first.
+void TaskCommands (void)
+{
+   while (Serial.available() > 0) {
+      cmdFramer.putByte((uint8_t)Serial.read());
+      if (cmdFramer.getFrame(cmdBuffer, sizeof(cmdBuffer)) >= 0) {
+         handle_command(cmdBuffer);
+      }
+   }
+}
+
+#if defined(USE_SERIAL)
+void TaskCounts (void)
+{
+   static uint16_t usOverflows = 0;
+   static uint16_t usDropped = 0;
+
+   if (usOverflows != cmdFramer.overflowCount()) {
+      usOverflows = cmdFramer.overflowCount();
+      Serial.print("command overflows: ");
+      Serial.println(usOverflows);
+   }
+   if (usDropped != txReplies.droppedCount() + txScans.droppedCount()) {
+      usDropped = txReplies.droppedCount() + txScans.droppedCount();
+      Serial.print("messages dropped: ");
+      Serial.println(usDropped);
+   }
+}
+#endif
+
+Task  tasks[] = {
+   // name       function         period msec   deadline usec
+#if defined(USE_KEYPAD)
+   { "keypad",   handleKeyPad,    0,            0 },
+#endif
+#if defined(USE_BUTTON)
+   { "button",   TaskButton,      0,            0 },
+#endif
+   { "burst",    serviceBurst,    0,            0 },      // queue the next scan of a burst if one is due
+   { "scale",    serviceScale,    0,            0 },      // answer a scale monitor command once the weight is stable
+   { "commands", TaskCommands,    0,            2000 },
+   { "tx",       serviceTx,       0,            0 },      // send the queued replies and scans as Serial has room
+#if defined(USE_SERIAL)
+   { "counts",   TaskCounts,      0,            0 },      // print the overflow and dropped counts when they change
+#endif
+};
+
+TaskRuntime  taskRuntime (tasks, sizeof(tasks) / sizeof(tasks[0]));
+
+void loop() {
+   // put your main code here, to run repeatedly:
+   taskRuntime.run();
 }
@@ -0,0 +1,111 @@
+/*
+ * Transmit queue of whole messages for the scanner scale simulator.
+ *
+ * The scanner scale sends two kinds of messages on the one serial port, scans pushed
+ * when the button is pressed or by a burst and replies to the weight and status requests
+ * of the point of sale. Each kind is built into its own TxQueue and loop() moves whole
+ * messages from the queues to Serial only when the Serial transmit buffer has room for
+ * all of a message. Messages are never interleaved, building a message never waits for
+ * the port, and a burst of scans can not hold up a weight reply since the replies are
+ * sent first.
+ *
+ * The queue is a ring buffer whose size is fixed by the template argument. Each message
+ * is stored as its length followed by its bytes. A message is started with begin(), its
+ * bytes added with write(), so a TxQueue can be the output of a ScanFrame, and it is
+ * added to the queue by commit(). If it does not fit then commit() throws it away and
+ * counts it as dropped.
+ *
+ * Usage:
+ *     TxQueue<64>  txReplies;
+ *
+ *     txReplies.begin ();
+ *     txReplies.write ('1'); ...
+ *     txReplies.commit ();
+ *
+ *     txReplies.send (Serial);     // in loop()
+ */
+
+#if !defined(TXQUEUE_H_INCLUDED)
+#define TXQUEUE_H_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+
+template <uint8_t N>     // size of the ring buffer, must be a power of 2 no larger than 128
+class TxQueue {
+  public:
+    TxQueue () : head(0), tail(0), start(0), bOverflow(false), usDropped(0) {}
+
+    // start a new message. a message which was begun and not committed is thrown away.
+    void begin (void) {
+      head = start;
+      bOverflow = (used () >= N);
+      if (!bOverflow) head++;           // room for the length, filled in by commit()
+    }
+
+    // add a byte to the message being built.
+    size_t write (uint8_t c) {
+      if (bOverflow || (uint8_t)(head - tail) >= N) {
+        bOverflow = true;
+        return 0;
+      }
+      ring[head++ & (N - 1)] = c;
+      return 1;
+    }
+
+    size_t write (const char *pBuff, uint8_t nLength) {
+      for (uint8_t i = 0; i < nLength; i++) write ((uint8_t)pBuff[i]);
+      return nLength;
+    }
+
+    // add the message being built to the queue. returns false if it did not fit.
+    bool commit (void) {
+      uint8_t  nLength = (uint8_t)(head - start - 1);
+
+      if (bOverflow || nLength == 0) {
+        if (bOverflow) usDropped++;
+        head = start;
+        bOverflow = false;
+        return false;
+      }
+      ring[start & (N - 1)] = nLength;
+      start = head;
+      return true;
+    }
+
+    // the length of the next message, 0 if the queue is empty.
+    uint8_t peek (void) const {
+      return (tail == start) ? 0 : ring[tail & (N - 1)];
+    }
+
+    // bytes free for messages, less the length byte of a message.
+    uint8_t room (void) const {
+      uint8_t  nFree = N - used ();
+      return nFree ? nFree - 1 : 0;
+    }
+
+    // write the next message to a serial port, such as Serial, if there is room for
+    // all of it in the transmit buffer of the port. returns true if it was sent.
+    template <class S> bool send (S &port) {
+      uint8_t  nLength = peek ();
+
+      if (nLength == 0 || port.availableForWrite () < nLength) return false;
+      tail++;
+      while (nLength--) port.write (ring[tail++ & (N - 1)]);
+      return true;
+    }
+
+    uint16_t droppedCount (void) const { return usDropped; }
+
+  private:
+    uint8_t  used (void) const { return (uint8_t)(start - tail); }
+
+    uint8_t  ring[N];
+    uint8_t  head;           // index of the next byte of the message being built
+    uint8_t  tail;           // index of the length of the oldest message
+    uint8_t  start;          // index of the length of the message being built, the end of the committed messages
+    bool     bOverflow;      // the message being built did not fit
+    uint16_t usDropped;      // number of messages thrown away since they did not fit
+};
+
+#endif    // !defined(TXQUEUE_H_INCLUDED)